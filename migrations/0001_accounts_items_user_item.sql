@@ -0,0 +1,18 @@
+-- Adds the unique (UserID, ItemID) key of `tw_accounts_items` to databases
+-- created from an older MRPG-database.sql. The items are written with
+-- INSERT ... ON DUPLICATE KEY UPDATE, which needs this key.
+--
+-- Older servers could insert the same item of an account twice. Every later
+-- update matched by UserID and ItemID, so the copies hold the same values.
+-- Only the oldest row of each item is kept.
+
+START TRANSACTION;
+
+DELETE `Copy` FROM `tw_accounts_items` AS `Copy`
+  INNER JOIN `tw_accounts_items` AS `Kept`
+    ON `Kept`.`UserID` = `Copy`.`UserID` AND `Kept`.`ItemID` = `Copy`.`ItemID` AND `Kept`.`ID` < `Copy`.`ID`;
+
+COMMIT;
+
+ALTER TABLE `tw_accounts_items`
+  ADD UNIQUE KEY `UserItem` (`UserID`,`ItemID`);
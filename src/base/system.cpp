@@ -25,6 +25,7 @@
 	#include <netinet/in.h>
 	#include <pthread.h>
 	#include <sys/ioctl.h>
+	#include <sys/mman.h>
 	#include <sys/socket.h>
 
 	#include <dirent.h>
@@ -43,6 +44,7 @@
 	#include <direct.h>
 	#include <errno.h>
 	#include <fcntl.h>
+	#include <io.h>
 	#include <process.h>
 	#include <shellapi.h>
 	#include <wincrypt.h>
@@ -413,6 +415,43 @@ long int io_length(IOHANDLE io)
 	return length;
 }
 
+const void *io_map(IOHANDLE io, unsigned *size)
+{
+	long int length = io_length(io);
+	void *data;
+	*size = 0;
+	if(length <= 0)
+		return 0x0;
+
+#if defined(CONF_FAMILY_WINDOWS)
+	HANDLE mapping = CreateFileMapping((HANDLE)_get_osfhandle(_fileno((FILE*)io)), NULL, PAGE_READONLY, 0, 0, NULL);
+	if(!mapping)
+		return 0x0;
+	data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if(!data)
+		return 0x0;
+#else
+	data = mmap(0x0, length, PROT_READ, MAP_PRIVATE, fileno((FILE*)io), 0);
+	if(data == MAP_FAILED)
+		return 0x0;
+#endif
+
+	*size = (unsigned)length;
+	return data;
+}
+
+void io_unmap(const void *data, unsigned size)
+{
+	if(!data)
+		return;
+#if defined(CONF_FAMILY_WINDOWS)
+	UnmapViewOfFile(data);
+#else
+	munmap((void *)data, size);
+#endif
+}
+
 unsigned io_write(IOHANDLE io, const void *buffer, unsigned size)
 {
 	return fwrite(buffer, 1, size, (FILE*)io);
@@ -335,6 +335,36 @@ long int io_tell(IOHANDLE io);
 */
 long int io_length(IOHANDLE io);
 
+/*
+	Function: io_map
+		Maps the whole file read-only into memory.
+
+	Parameters:
+		io - Handle to the file.
+		size - Receives the size of the mapping.
+
+	Returns:
+		Returns the mapped data or 0x0 if the file could not be mapped.
+
+	Remarks:
+		- The mapping stays valid after the file is closed.
+		- Release it with io_unmap.
+		- Changes to the file show through the mapping, truncating it
+		  can raise SIGBUS on access. Replace mapped files atomically
+		  (write a new file and rename it) instead of overwriting them.
+*/
+const void *io_map(IOHANDLE io, unsigned *size);
+
+/*
+	Function: io_unmap
+		Releases a mapping created by io_map.
+
+	Parameters:
+		data - The mapped data.
+		size - Size of the mapping.
+*/
+void io_unmap(const void *data, unsigned size);
+
 /*
 	Function: io_close
 		Closes a file.
@@ -24,16 +24,15 @@ class IEngineMap : public IMap
 {
 	MACRO_INTERFACE("enginemap", 0)
 public:
-	virtual bool Load(const char *pMapName) = 0;
+	virtual bool Load(const char *pMapName, bool MapFile = false) = 0;
 	virtual bool IsLoaded() = 0;
 	virtual void Unload() = 0;
 	virtual SHA256_DIGEST Sha256() = 0;
 	virtual unsigned Crc() = 0;
 
-	virtual void SetCurrentMapSize(int Size) = 0;
+	// the map file as it is sent to the clients
 	virtual int GetCurrentMapSize() = 0;
-	virtual void SetCurrentMapData(unsigned char* CurrentMapData) = 0;
-	virtual unsigned char* GetCurrentMapData() = 0;
+	virtual const unsigned char* GetCurrentMapData() = 0;
 };
 
 extern IEngineMap *CreateEngineMap();
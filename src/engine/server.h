@@ -6,6 +6,8 @@
 #include "kernel.h"
 #include "message.h"
 
+#include <functional>
+
 #define DC_SERVER_INFO 13872503
 #define DC_PLAYER_INFO 1346299
 #define DC_JOIN_LEAVE 14494801
@@ -201,12 +203,16 @@ public:
 
 	virtual bool IsClientChangesWorld(int ClientID) = 0;
 	virtual void ChangeWorld(int ClientID, int NewWorldID) = 0;
+
+	// runs right away, or after every world has finished the current stage when the worlds are ticked in parallel
+	virtual void ExecuteCrossWorld(std::function<void()> Func) = 0;
 	virtual int GetClientWorldID(int ClientID) = 0;
 	virtual const char* GetWorldName(int WorldID) = 0;
 	virtual int GetWorldsSize() const = 0;
 
 	virtual void SetClientLanguage(int ClientID, const char* pLanguage) = 0;
 	virtual const char* GetClientLanguage(int ClientID) const = 0;
+	virtual int GetClientLanguageID(int ClientID) const = 0;
 
 	// discord
 	virtual void SendDiscordMessage(const char *pChannel, int Color, const char* pTitle, const char* pText) = 0;
@@ -223,6 +229,12 @@ public:
 	virtual void *SnapNewItem(int Type, int ID, int Size) = 0;
 	virtual void SnapSetStaticsize(int ItemType, int Size) = 0;
 
+	// items created between begin and end are recorded into a fragment instead of the
+	// snapshot, the fragment can then be added to the snapshots of several clients
+	virtual void SnapBeginFragment() = 0;
+	virtual int SnapEndFragment(const void **ppData) = 0;
+	virtual void SnapAddFragment(const void *pData, int Size) = 0;
+
 	enum
 	{
 		RCON_CID_SERV=-1,
@@ -247,12 +259,14 @@ class IGameServer : public IInterface
 	MACRO_INTERFACE("gameserver", 0)
 protected:
 public:
+	virtual void OnInitMap(int WorldID) = 0;
 	virtual void OnInit(int WorldID) = 0;
 	virtual void OnConsoleInit() = 0;
 	virtual void OnShutdown() = 0;
 
 	virtual void OnTick() = 0;
 	virtual void OnTickMainWorld() = 0;
+	virtual void OnWakeUp(int SleepTicks) = 0;
 	virtual void OnPreSnap() = 0;
 	virtual void OnSnap(int ClientID) = 0;
 	virtual void OnPostSnap() = 0;
@@ -12,6 +12,9 @@ bool CMultiWorlds::Add(int WorldID, IKernel* pKernel, IServer *pServer)
 
 	CWorldGameServer& pNewWorld = m_Worlds[WorldID];
 	pNewWorld.m_pGameServer = CreateGameServer();
+	pNewWorld.m_Sleeping = false;
+	pNewWorld.m_LastActiveTick = 0;
+	pNewWorld.m_SleepTick = 0;
 
 	bool RegisterFail = false;
 	if(m_NextIsReloading) // reregister
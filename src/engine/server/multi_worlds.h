@@ -13,6 +13,11 @@ public:
 		char m_aPath[512];
 		class IGameServer* m_pGameServer;
 		class IEngineMap* m_pLoadedMap;
+
+		// hibernation
+		bool m_Sleeping;
+		int m_LastActiveTick;
+		int m_SleepTick;
 	};
 
 	CMultiWorlds()
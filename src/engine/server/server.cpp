@@ -31,6 +31,7 @@
 #include "discord/discord_main.h"
 #include "multi_worlds.h"
 #include "server_ban.h"
+#include "world_thread_pool.h"
 
 void CServer::CClient::Reset()
 {
@@ -46,6 +47,9 @@ void CServer::CClient::Reset()
 	m_SnapRate = SNAPRATE_INIT;
 	m_Score = 0;
 	m_NextMapChunk = 0;
+	m_MapTransferStart = 0;
+	m_MapTransferChunks = 0;
+	m_MapTransferRequests = 0;
 }
 
 CServer::CServer() : m_Register()
@@ -62,6 +66,11 @@ CServer::CServer() : m_Register()
 	m_RconPasswordSet = 0;
 	m_GeneratedRconPassword = 0;
 	m_HeavyReload = false;
+	m_InWorldStage = false;
+	m_pWorldPool = nullptr;
+	mem_zero(m_aMapTransfers, sizeof(m_aMapTransfers));
+	mem_zero(m_aaStartupTime, sizeof(m_aaStartupTime));
+	mem_zero(m_aStartupStageTime, sizeof(m_aStartupStageTime));
 
 	m_ServerInfoFirstRequest = 0;
 	m_ServerInfoNumRequests = 0;
@@ -79,6 +88,7 @@ CServer::~CServer()
 	m_pDiscord->quit();
 	delete m_pDiscord;
 #endif
+	delete m_pWorldPool;
 	delete m_pMultiWorlds;
 
 	Database->DisconnectConnectionHeap();
@@ -220,6 +230,7 @@ void CServer::SetClientLanguage(int ClientID, const char* pLanguage)
 		return;
 
 	str_copy(m_aClients[ClientID].m_aLanguage, pLanguage, sizeof(m_aClients[ClientID].m_aLanguage));
+	m_aClients[ClientID].m_LanguageID = Localization()->GetLanguageID(pLanguage);
 }
 
 bool CServer::IsClientChangesWorld(int ClientID)
@@ -250,8 +261,22 @@ const char* CServer::GetClientLanguage(int ClientID) const
 	return m_aClients[ClientID].m_aLanguage;
 }
 
+int CServer::GetClientLanguageID(int ClientID) const
+{
+	if (ClientID < 0 || ClientID >= MAX_CLIENTS || m_aClients[ClientID].m_State < CClient::STATE_READY)
+		return -1;
+	return m_aClients[ClientID].m_LanguageID;
+}
+
 void CServer::ChangeWorld(int ClientID, int NewWorldID)
 {
+	// touches both worlds, wait until they are done
+	if(m_InWorldStage)
+	{
+		ExecuteCrossWorld([this, ClientID, NewWorldID]() { ChangeWorld(ClientID, NewWorldID); });
+		return;
+	}
+
 	if(ClientID < 0 || ClientID >= MAX_PLAYERS || NewWorldID == m_aClients[ClientID].m_WorldID || !MultiWorlds()->IsValid(NewWorldID) || m_aClients[ClientID].m_State < CClient::STATE_READY)
 		return;
 
@@ -271,6 +296,71 @@ void CServer::ChangeWorld(int ClientID, int NewWorldID)
 	SendMap(ClientID);
 }
 
+void CServer::ExecuteCrossWorld(std::function<void()> Func)
+{
+	if(!m_InWorldStage)
+	{
+		Func();
+		return;
+	}
+
+	std::lock_guard<std::mutex> Lock(m_CrossWorldLock);
+	m_aCrossWorldQueue.push_back(std::move(Func));
+}
+
+void CServer::RunWorldStage(const std::function<void(int)>& Func)
+{
+	const int NumWorlds = MultiWorlds()->GetSizeInitilized();
+	if(!m_pWorldPool)
+	{
+		for(int i = 0; i < NumWorlds; i++)
+			Func(i);
+		return;
+	}
+
+	m_InWorldStage = true;
+	m_pWorldPool->Run(NumWorlds, Func);
+	m_InWorldStage = false;
+
+	// every world has passed the barrier, run what was postponed in the order it was requested
+	std::vector<std::function<void()>> aQueue;
+	{
+		std::lock_guard<std::mutex> Lock(m_CrossWorldLock);
+		aQueue.swap(m_aCrossWorldQueue);
+	}
+	for(auto& Func : aQueue)
+		Func();
+}
+
+void CServer::UpdateWorldsHibernation()
+{
+	int aPlayers[ENGINE_MAX_WORLDS] = { 0 };
+	for(int i = 0; i < MAX_PLAYERS; i++)
+	{
+		if(m_aClients[i].m_State != CClient::STATE_EMPTY && MultiWorlds()->IsValid(m_aClients[i].m_WorldID))
+			aPlayers[m_aClients[i].m_WorldID]++;
+	}
+
+	for(int i = 0; i < MultiWorlds()->GetSizeInitilized(); i++)
+	{
+		CMultiWorlds::CWorldGameServer* pWorld = MultiWorlds()->GetWorld(i);
+		if(aPlayers[i] > 0 || i == MAIN_WORLD_ID || !g_Config.m_SvHibernateWorlds)
+		{
+			pWorld->m_LastActiveTick = Tick();
+			if(pWorld->m_Sleeping)
+			{
+				pWorld->m_Sleeping = false;
+				pWorld->m_pGameServer->OnWakeUp(Tick() - pWorld->m_SleepTick);
+			}
+		}
+		else if(!pWorld->m_Sleeping && Tick() - pWorld->m_LastActiveTick > g_Config.m_SvHibernateDelay * TickSpeed())
+		{
+			pWorld->m_Sleeping = true;
+			pWorld->m_SleepTick = Tick();
+		}
+	}
+}
+
 int CServer::GetClientWorldID(int ClientID)
 {
 	if(ClientID < 0 || ClientID >= MAX_CLIENTS || m_aClients[ClientID].m_State < CClient::STATE_READY)
@@ -339,6 +429,14 @@ void CServer::Kick(int ClientID, const char *pReason)
 		return;
 	}
 
+	// dropping a client clears its data in every world
+	if(m_InWorldStage)
+	{
+		std::string Reason(pReason);
+		ExecuteCrossWorld([this, ClientID, Reason]() { m_NetServer.Drop(ClientID, Reason.c_str()); });
+		return;
+	}
+
 	m_NetServer.Drop(ClientID, pReason);
 }
 
@@ -366,6 +464,7 @@ int CServer::Init()
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
 		str_copy(m_aClients[i].m_aLanguage, "en", sizeof(m_aClients[i].m_aLanguage));
+		m_aClients[i].m_LanguageID = -1;
 		m_aClients[i].m_State = CClient::STATE_EMPTY;
 		m_aClients[i].m_aName[0] = 0;
 		m_aClients[i].m_aClan[0] = 0;
@@ -592,6 +691,8 @@ int CServer::SendMsg(CMsgPacker *pMsg, int Flags, int ClientID, int64 Mask, int
 
 	if(!(Flags&MSGFLAG_NOSEND))
 	{
+		// worlds may send from their own threads
+		std::lock_guard<std::mutex> Lock(m_NetSendLock);
 		if(ClientID == -1)
 		{
 			CPacker Pack;
@@ -641,13 +742,32 @@ int CServer::SendMsg(CMsgPacker *pMsg, int Flags, int ClientID, int64 Mask, int
 	return 0;
 }
 
-void CServer::DoSnapshot(int WorldID)
+// every thread that produces snapshots has its own builder
+static thread_local CSnapshotBuilder s_SnapshotBuilder;
+
+// items recorded for a shared fragment
+static thread_local struct CSnapFragmentRecorder
+{
+	bool m_Recording = false;
+	int m_NumInts = 0;
+	int m_aData[CSnapshot::MAX_SIZE / sizeof(int)];
+} s_Fragment;
+
+void CServer::DoSnapshot()
 {
-	GameServer(WorldID)->OnPreSnap();
+	const int NumWorlds = MultiWorlds()->GetSizeInitilized();
+	for(int WorldID = 0; WorldID < NumWorlds; WorldID++)
+	{
+		if(!MultiWorlds()->GetWorld(WorldID)->m_Sleeping)
+			GameServer(WorldID)->OnPreSnap();
+	}
+
+	int NumJobs = 0;
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
 		// client must be ingame to recive snapshots
-		if(m_aClients[i].m_WorldID != WorldID || m_aClients[i].m_State != CClient::STATE_INGAME)
+		const int WorldID = m_aClients[i].m_WorldID;
+		if(WorldID < 0 || WorldID >= NumWorlds || MultiWorlds()->GetWorld(WorldID)->m_Sleeping || m_aClients[i].m_State != CClient::STATE_INGAME)
 			continue;
 
 		// this client is trying to recover, don't spam snapshots
@@ -658,93 +778,117 @@ void CServer::DoSnapshot(int WorldID)
 		if(m_aClients[i].m_SnapRate == CClient::SNAPRATE_INIT && (Tick()%10) != 0)
 			continue;
 
-		{
-			m_SnapshotBuilder.Init();
-				
-			GameServer(WorldID)->OnSnap(i);
+		m_aSnapJobs[NumJobs++].m_ClientID = i;
+	}
 
-			// finish snapshot
-			char aData[CSnapshot::MAX_SIZE];
-			CSnapshot *pData = (CSnapshot *)aData; // Fix compiler warning for strict-aliasing
-			int SnapshotSize = m_SnapshotBuilder.Finish(pData);
+	// the snapshots only read the worlds, every client is built on its own thread
+	if(m_pWorldPool)
+		m_pWorldPool->Run(NumJobs, [this](int Job) { BuildSnapshot(m_aSnapJobs[Job]); });
+	else
+	{
+		for(int Job = 0; Job < NumJobs; Job++)
+			BuildSnapshot(m_aSnapJobs[Job]);
+	}
 
-			int Crc = pData->Crc();
+	for(int Job = 0; Job < NumJobs; Job++)
+		SendSnapshot(m_aSnapJobs[Job]);
 
-			// remove old snapshots
-			// keep 3 seconds worth of snapshots
-			m_aClients[i].m_Snapshots.PurgeUntil(m_CurrentGameTick - SERVER_TICK_SPEED * 3);
+	for(int WorldID = 0; WorldID < NumWorlds; WorldID++)
+	{
+		if(!MultiWorlds()->GetWorld(WorldID)->m_Sleeping)
+			GameServer(WorldID)->OnPostSnap();
+	}
+}
 
-			// save the snapshot
-			m_aClients[i].m_Snapshots.Add(m_CurrentGameTick, time_get(), SnapshotSize, pData, 0, nullptr);
+void CServer::BuildSnapshot(CSnapJob& Job)
+{
+	const int ClientID = Job.m_ClientID;
+	CClient& Client = m_aClients[ClientID];
 
-			// find snapshot that we can perform delta against
-			static CSnapshot s_EmptySnap;
-			s_EmptySnap.Clear();
+	s_SnapshotBuilder.Init();
+	GameServer(Client.m_WorldID)->OnSnap(ClientID);
 
-			int DeltaTick = -1;
-			CSnapshot *pDeltashot = &s_EmptySnap;
-			{
-				int DeltashotSize = m_aClients[i].m_Snapshots.Get(m_aClients[i].m_LastAckedSnapshot, 0, &pDeltashot, 0);
-				if(DeltashotSize >= 0)
-					DeltaTick = m_aClients[i].m_LastAckedSnapshot;
-				else
-				{
-					// no acked package found, force client to recover rate
-					if(m_aClients[i].m_SnapRate == CClient::SNAPRATE_FULL)
-						m_aClients[i].m_SnapRate = CClient::SNAPRATE_RECOVER;
-				}
-			}
+	// finish snapshot
+	char aData[CSnapshot::MAX_SIZE];
+	CSnapshot *pData = (CSnapshot *)aData; // Fix compiler warning for strict-aliasing
+	const int SnapshotSize = s_SnapshotBuilder.Finish(pData);
+	Job.m_Crc = pData->Crc();
 
-			// create delta
-			char aDeltaData[CSnapshot::MAX_SIZE];
-			if(int DeltaSize = m_SnapshotDelta.CreateDelta(pDeltashot, pData, aDeltaData))
-			{
-				// compress it
-				const int MaxSize = MAX_SNAPSHOT_PACKSIZE;
+	// remove old snapshots
+	// keep 3 seconds worth of snapshots
+	Client.m_Snapshots.PurgeUntil(m_CurrentGameTick - SERVER_TICK_SPEED * 3);
 
-				char aCompData[CSnapshot::MAX_SIZE];
-				SnapshotSize = CVariableInt::Compress(aDeltaData, DeltaSize, aCompData, sizeof(aCompData));
-				int NumPackets = (SnapshotSize + MaxSize - 1) / MaxSize;
+	// save the snapshot
+	Client.m_Snapshots.Add(m_CurrentGameTick, time_get(), SnapshotSize, pData, 0, nullptr);
 
-				for(int n = 0, Left = SnapshotSize; Left > 0; n++)
-				{
-					int Chunk = Left < MaxSize ? Left : MaxSize;
-					Left -= Chunk;
+	// find snapshot that we can perform delta against
+	static thread_local CSnapshot s_EmptySnap;
+	s_EmptySnap.Clear();
 
-					if(NumPackets == 1)
-					{
-						CMsgPacker Msg(NETMSG_SNAPSINGLE, true);
-						Msg.AddInt(m_CurrentGameTick);
-						Msg.AddInt(m_CurrentGameTick - DeltaTick);
-						Msg.AddInt(Crc);
-						Msg.AddInt(Chunk);
-						Msg.AddRaw(&aCompData[n * MaxSize], Chunk);
-						SendMsg(&Msg, MSGFLAG_FLUSH, i, -1, WorldID);
-					}
-					else
-					{
-						CMsgPacker Msg(NETMSG_SNAP, true);
-						Msg.AddInt(m_CurrentGameTick);
-						Msg.AddInt(m_CurrentGameTick - DeltaTick);
-						Msg.AddInt(NumPackets);
-						Msg.AddInt(n);
-						Msg.AddInt(Crc);
-						Msg.AddInt(Chunk);
-						Msg.AddRaw(&aCompData[n * MaxSize], Chunk);
-						SendMsg(&Msg, MSGFLAG_FLUSH, i, -1, WorldID);
-					}
-				}
-			}
-			else
-			{
-				CMsgPacker Msg(NETMSG_SNAPEMPTY, true);
-				Msg.AddInt(m_CurrentGameTick);
-				Msg.AddInt(m_CurrentGameTick - DeltaTick);
-				SendMsg(&Msg, MSGFLAG_FLUSH, i, -1, WorldID);
-			}
+	Job.m_DeltaTick = -1;
+	CSnapshot *pDeltashot = &s_EmptySnap;
+	{
+		int DeltashotSize = Client.m_Snapshots.Get(Client.m_LastAckedSnapshot, 0, &pDeltashot, 0);
+		if(DeltashotSize >= 0)
+			Job.m_DeltaTick = Client.m_LastAckedSnapshot;
+		else
+		{
+			// no acked package found, force client to recover rate
+			if(Client.m_SnapRate == CClient::SNAPRATE_FULL)
+				Client.m_SnapRate = CClient::SNAPRATE_RECOVER;
+		}
+	}
+
+	// create delta and compress it
+	char aDeltaData[CSnapshot::MAX_SIZE];
+	Job.m_Size = 0;
+	if(int DeltaSize = m_SnapshotDelta.CreateDelta(pDeltashot, pData, aDeltaData))
+		Job.m_Size = CVariableInt::Compress(aDeltaData, DeltaSize, Job.m_aCompData, sizeof(Job.m_aCompData));
+}
+
+void CServer::SendSnapshot(const CSnapJob& Job)
+{
+	const int ClientID = Job.m_ClientID;
+	const int WorldID = m_aClients[ClientID].m_WorldID;
+	if(Job.m_Size == 0)
+	{
+		CMsgPacker Msg(NETMSG_SNAPEMPTY, true);
+		Msg.AddInt(m_CurrentGameTick);
+		Msg.AddInt(m_CurrentGameTick - Job.m_DeltaTick);
+		SendMsg(&Msg, MSGFLAG_FLUSH, ClientID, -1, WorldID);
+		return;
+	}
+
+	const int MaxSize = MAX_SNAPSHOT_PACKSIZE;
+	const int NumPackets = (Job.m_Size + MaxSize - 1) / MaxSize;
+	for(int n = 0, Left = Job.m_Size; Left > 0; n++)
+	{
+		int Chunk = Left < MaxSize ? Left : MaxSize;
+		Left -= Chunk;
+
+		if(NumPackets == 1)
+		{
+			CMsgPacker Msg(NETMSG_SNAPSINGLE, true);
+			Msg.AddInt(m_CurrentGameTick);
+			Msg.AddInt(m_CurrentGameTick - Job.m_DeltaTick);
+			Msg.AddInt(Job.m_Crc);
+			Msg.AddInt(Chunk);
+			Msg.AddRaw(&Job.m_aCompData[n * MaxSize], Chunk);
+			SendMsg(&Msg, MSGFLAG_FLUSH, ClientID, -1, WorldID);
+		}
+		else
+		{
+			CMsgPacker Msg(NETMSG_SNAP, true);
+			Msg.AddInt(m_CurrentGameTick);
+			Msg.AddInt(m_CurrentGameTick - Job.m_DeltaTick);
+			Msg.AddInt(NumPackets);
+			Msg.AddInt(n);
+			Msg.AddInt(Job.m_Crc);
+			Msg.AddInt(Chunk);
+			Msg.AddRaw(&Job.m_aCompData[n * MaxSize], Chunk);
+			SendMsg(&Msg, MSGFLAG_FLUSH, ClientID, -1, WorldID);
 		}
 	}
-	GameServer(WorldID)->OnPostSnap();
 }
 
 
@@ -794,6 +938,7 @@ int CServer::NewClientCallback(int ClientID, void *pUser, bool Sixup)
 
 	pThis->GameServer(MAIN_WORLD_ID)->ClearClientData(ClientID);
 	str_copy(pThis->m_aClients[ClientID].m_aLanguage, "en", sizeof(pThis->m_aClients[ClientID].m_aLanguage));
+	pThis->m_aClients[ClientID].m_LanguageID = -1;
 	pThis->m_aClients[ClientID].m_State = CClient::STATE_AUTH;
 	pThis->m_aClients[ClientID].m_aName[0] = 0;
 	pThis->m_aClients[ClientID].m_aClan[0] = 0;
@@ -861,32 +1006,24 @@ int CServer::DelClientCallback(int ClientID, const char *pReason, void *pUser)
 
 void CServer::SendMapData(int ClientID, int Chunk)
 {
-	const int WorldID = m_aClients[ClientID].m_WorldID;
-	unsigned int CurrentMapSize = MultiWorlds()->GetWorld(WorldID)->m_pLoadedMap->GetCurrentMapSize();
-	unsigned char* pCurrentMapData = MultiWorlds()->GetWorld(WorldID)->m_pLoadedMap->GetCurrentMapData();
-	const unsigned Crc = MultiWorlds()->GetWorld(WorldID)->m_pLoadedMap->Crc();
-
-	unsigned int ChunkSize = 1024 - 128;
-	const unsigned int Offset = Chunk * ChunkSize;
-	int Last = 0;
+	const CMapTransfer& Transfer = m_aMapTransfers[m_aClients[ClientID].m_WorldID];
 
 	// drop faulty map data requests
-	if (Chunk < 0 || Offset > CurrentMapSize)
+	if(Chunk < 0 || Chunk >= Transfer.m_NumChunks)
 		return;
 
-	if ((Offset + ChunkSize) >= CurrentMapSize)
-	{
-		ChunkSize = CurrentMapSize - Offset;
-		Last = 1;
-	}
+	const int Offset = Chunk * MAP_DATA_CHUNK_SIZE;
+	const int ChunkSize = min((int)MAP_DATA_CHUNK_SIZE, Transfer.m_Size - Offset);
+	const int Last = Chunk == Transfer.m_NumChunks - 1;
 
 	CMsgPacker Msg(NETMSG_MAP_DATA, true);
 	Msg.AddInt(Last);
-	Msg.AddInt(Crc);
+	Msg.AddInt(Transfer.m_Crc);
 	Msg.AddInt(Chunk);
 	Msg.AddInt(ChunkSize);
-	Msg.AddRaw(&pCurrentMapData[Offset], ChunkSize);
+	Msg.AddRaw(&Transfer.m_pData[Offset], ChunkSize);
 	SendMsg(&Msg, MSGFLAG_VITAL | MSGFLAG_FLUSH, ClientID);
+	m_aClients[ClientID].m_MapTransferChunks++;
 
 	if (g_Config.m_Debug)
 	{
@@ -896,6 +1033,21 @@ void CServer::SendMapData(int ClientID, int Chunk)
 	}
 }
 
+// the client has every chunk before the requested one, keep up to sv_map_window chunks in flight
+// ahead of it and send at most sv_map_download_speed of them per request, each chunk only once
+void CServer::SendMapWindow(int ClientID, int Chunk)
+{
+	CClient& Client = m_aClients[ClientID];
+	const int NumChunks = m_aMapTransfers[Client.m_WorldID].m_NumChunks;
+	if(Chunk < 0 || Chunk >= NumChunks)
+		return;
+
+	Client.m_NextMapChunk = max(Client.m_NextMapChunk, Chunk);
+	const int End = min(min(Chunk + g_Config.m_SvMapWindow + 1, NumChunks), Client.m_NextMapChunk + m_MapChunksPerRequest);
+	for(; Client.m_NextMapChunk < End; Client.m_NextMapChunk++)
+		SendMapData(ClientID, Client.m_NextMapChunk);
+}
+
 void CServer::SendCapabilities(int ClientID)
 {
 	CMsgPacker Msg(NETMSG_CAPABILITIES, true);
@@ -932,6 +1084,9 @@ void CServer::SendMap(int ClientID)
 	}
 
 	m_aClients[ClientID].m_NextMapChunk = 0;
+	m_aClients[ClientID].m_MapTransferStart = time_get();
+	m_aClients[ClientID].m_MapTransferChunks = 0;
+	m_aClients[ClientID].m_MapTransferRequests = 0;
 }
 
 void CServer::SendConnectionReady(int ClientID)
@@ -1073,27 +1228,28 @@ void CServer::ProcessClientPacket(CNetChunk *pPacket)
 				return;
 
 			const int Chunk = Unpacker.GetInt();
-			if (Chunk != m_aClients[ClientID].m_NextMapChunk || !g_Config.m_SvFastDownload)
+			m_aClients[ClientID].m_MapTransferRequests++;
+			if (!g_Config.m_SvFastDownload)
 			{
 				SendMapData(ClientID, Chunk);
 				return;
 			}
 
-			if (Chunk == 0)
-			{
-				for (int i = 0; i < g_Config.m_SvMapWindow; i++)
-				{
-					SendMapData(ClientID, i);
-				}
-			}
-
-			SendMapData(ClientID, g_Config.m_SvMapWindow + m_aClients[ClientID].m_NextMapChunk);
-			m_aClients[ClientID].m_NextMapChunk++;
+			SendMapWindow(ClientID, Chunk);
 		}
 		else if(MsgID == NETMSG_READY)
 		{
 			if((pPacket->m_Flags&NET_CHUNKFLAG_VITAL) != 0 && m_aClients[ClientID].m_State == CClient::STATE_CONNECTING)
 			{
+				// time from sending the map to the client being ready, also for world changes
+				{
+					const CClient& Client = m_aClients[ClientID];
+					char aBuf[256];
+					str_format(aBuf, sizeof(aBuf), "map transfer done. ClientID=%d world=%d chunks=%d requests=%d time=%.1fms", ClientID, Client.m_WorldID,
+						Client.m_MapTransferChunks, Client.m_MapTransferRequests, (time_get() - Client.m_MapTransferStart) * 1000.0 / time_freq());
+					Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "server", aBuf);
+				}
+
 				if(!m_aClients[ClientID].m_IsChangesWorld)
 				{
 					char aAddrStr[NETADDR_MAXSTRSIZE];
@@ -1728,33 +1884,91 @@ bool CServer::LoadMap(int ID)
 	char aBuf[512];
 	str_format(aBuf, sizeof(aBuf), "maps/%s", MultiWorlds()->GetWorld(ID)->m_aPath);
 
+	// the map keeps the file image, mapped or read, downloads are served from it
 	IEngineMap *pMap = MultiWorlds()->GetWorld(ID)->m_pLoadedMap;
-	if(!pMap->Load(aBuf))
-		return false;
+	return pMap->Load(aBuf, g_Config.m_SvMapMmap);
+}
+
+void CServer::RunStartupStage(int Stage, bool Parallel, const std::function<void(int)>& Func)
+{
+	const int NumWorlds = MultiWorlds()->GetSizeInitilized();
+	auto TimedFunc = [this, Stage, &Func](int WorldID)
+	{
+		const int64 Start = time_get();
+		Func(WorldID);
+		m_aaStartupTime[WorldID][Stage] = time_get() - Start;
+	};
+
+	const int64 Start = time_get();
+	if(Parallel && m_pWorldPool)
+		m_pWorldPool->Run(NumWorlds, TimedFunc);
+	else
+	{
+		for(int i = 0; i < NumWorlds; i++)
+			TimedFunc(i);
+	}
+	m_aStartupStageTime[Stage] = time_get() - Start;
+}
+
+bool CServer::LoadWorldMaps()
+{
+	const int NumWorlds = MultiWorlds()->GetSizeInitilized();
+	std::vector<char> aLoaded(NumWorlds, 0);
+	RunStartupStage(STARTUP_MAP, true, [this, &aLoaded](int WorldID) { aLoaded[WorldID] = LoadMap(WorldID); });
 
 	// reinit snapshot ids
 	m_IDPool.TimeoutIDs();
 
-	// get the sha256 and crc of the map
-	char aSha256[SHA256_MAXSTRSIZE];
-	sha256_str(pMap->Sha256(), aSha256, sizeof(aSha256));
-	char aBufMsg[256];
-	str_format(aBufMsg, sizeof(aBufMsg), "%s sha256 is %s", aBuf, aSha256);
-	Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "server", aBufMsg);
-	str_format(aBufMsg, sizeof(aBufMsg), "%s crc is %08x", aBuf, pMap->Crc());
-	Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "server", aBufMsg);
-
-	// load complete map into memory for download
+	char aBuf[256];
+	for(int i = 0; i < NumWorlds; i++)
 	{
-		IOHANDLE File = Storage()->OpenFile(aBuf, IOFLAG_READ, IStorageEngine::TYPE_ALL);
-		pMap->SetCurrentMapSize((int)io_length(File));
-		pMap->SetCurrentMapData((unsigned char *)mem_alloc(pMap->GetCurrentMapSize(), 1));
-		io_read(File, pMap->GetCurrentMapData(), pMap->GetCurrentMapSize());
-		io_close(File);
+		if(!aLoaded[i])
+		{
+			str_format(aBuf, sizeof(aBuf), "maps/%s the map is not loaded...", MultiWorlds()->GetWorld(i)->m_aPath);
+			Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+			return false;
+		}
+
+		// split the map into download chunks
+		IEngineMap *pMap = MultiWorlds()->GetWorld(i)->m_pLoadedMap;
+		CMapTransfer& Transfer = m_aMapTransfers[i];
+		Transfer.m_pData = pMap->GetCurrentMapData();
+		Transfer.m_Size = pMap->GetCurrentMapSize();
+		Transfer.m_NumChunks = (Transfer.m_Size + MAP_DATA_CHUNK_SIZE - 1) / MAP_DATA_CHUNK_SIZE;
+		Transfer.m_Crc = pMap->Crc();
+
+		// get the sha256 and crc of the map
+		char aSha256[SHA256_MAXSTRSIZE];
+		sha256_str(pMap->Sha256(), aSha256, sizeof(aSha256));
+		str_format(aBuf, sizeof(aBuf), "maps/%s sha256 is %s", MultiWorlds()->GetWorld(i)->m_aPath, aSha256);
+		Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "server", aBuf);
+		str_format(aBuf, sizeof(aBuf), "maps/%s crc is %08x", MultiWorlds()->GetWorld(i)->m_aPath, pMap->Crc());
+		Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "server", aBuf);
 	}
 	return true;
 }
 
+void CServer::InitWorlds()
+{
+	const int NumWorlds = MultiWorlds()->GetSizeInitilized();
+	RunStartupStage(STARTUP_PRECOMPUTE, true, [this](int WorldID) { GameServer(WorldID)->OnInitMap(WorldID); });
+
+	// the components fill tables shared by all worlds while loading from the database
+	RunStartupStage(STARTUP_INIT, false, [this](int WorldID) { GameServer(WorldID)->OnInit(WorldID); });
+
+	char aBuf[256];
+	const double Freq = (double)time_freq() / 1000.0;
+	for(int i = 0; i < NumWorlds; i++)
+	{
+		str_format(aBuf, sizeof(aBuf), "world %d '%s': map %.1fms, precompute %.1fms, init %.1fms", i, GetWorldName(i),
+			m_aaStartupTime[i][STARTUP_MAP] / Freq, m_aaStartupTime[i][STARTUP_PRECOMPUTE] / Freq, m_aaStartupTime[i][STARTUP_INIT] / Freq);
+		Console()->Print(IConsole::OUTPUT_LEVEL_ADDINFO, "server", aBuf);
+	}
+	str_format(aBuf, sizeof(aBuf), "%d worlds started: maps %.1fms, precompute %.1fms, init %.1fms", NumWorlds,
+		m_aStartupStageTime[STARTUP_MAP] / Freq, m_aStartupStageTime[STARTUP_PRECOMPUTE] / Freq, m_aStartupStageTime[STARTUP_INIT] / Freq);
+	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
+}
+
 void CServer::InitRegister(CNetServer *pNetServer, IEngineMasterServer *pMasterServer, IConsole *pConsole)
 {
 	m_Register.Init(pNetServer, pMasterServer, pConsole);
@@ -1770,18 +1984,20 @@ int CServer::Run()
 	CConectionPool::Initilize();
 	Instance::m_pServer = static_cast<IServer*>(this);
 
-	// loading maps to memory
+	// between the barriers a world may only write its own state, the shared data (guilds, bots, dungeons)
+	// is changed in the serial stages or through ExecuteCrossWorld
 	char aBuf[256];
-	for(int i = 0; i < MultiWorlds()->GetSizeInitilized(); i++)
+	if(g_Config.m_SvParallelWorlds > 1)
 	{
-		if(!LoadMap(i))
-		{
-			str_format(aBuf, sizeof(aBuf), "maps/%s the map is not loaded...", MultiWorlds()->GetWorld(i)->m_aPath);
-			Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
-			return -1;
-		}
+		m_pWorldPool = new CWorldThreadPool(g_Config.m_SvParallelWorlds);
+		str_format(aBuf, sizeof(aBuf), "worlds are processed by %d threads", m_pWorldPool->NumThreads());
+		Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
 	}
 
+	// loading maps to memory
+	if(!LoadWorldMaps())
+		return -1;
+
 	// start server
 	NETADDR BindAddr;
 	if(g_Config.m_Bindaddr[0] && net_host_lookup(g_Config.m_Bindaddr, &BindAddr, NETTYPE_ALL) == 0)
@@ -1812,8 +2028,7 @@ int CServer::Run()
 		dbg_msg("server", "the worlds were not found or were not initialized");
 		return -1;
 	}
-	for(int i = 0; i < MultiWorlds()->GetSizeInitilized(); i++)
-		MultiWorlds()->GetWorld(i)->m_pGameServer->OnInit(i);
+	InitWorlds();
 
 	str_format(aBuf, sizeof(aBuf), "version %s", GameServer()->NetVersion());
 	Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
@@ -1845,6 +2060,9 @@ int CServer::Run()
 			bool ShouldSnap = false;
 			bool ExistsPlayers = false;
 
+			// callbacks of finished queries are executed on the tick thread
+			Database->Update();
+
 			while(t > TickStartTime(m_CurrentGameTick+1))
 			{
 				NewTicks = true;
@@ -1893,12 +2111,13 @@ int CServer::Run()
 					}
 				}
 
+				UpdateWorldsHibernation();
 				MultiWorlds()->GetWorld(MAIN_WORLD_ID)->m_pGameServer->OnTickMainWorld();
-				for(int i = 0; i < MultiWorlds()->GetSizeInitilized(); i++)
+				RunWorldStage([this](int WorldID)
 				{
-					IGameServer* pGameServer = MultiWorlds()->GetWorld(i)->m_pGameServer;
-					pGameServer->OnTick();
-				}
+					if(!MultiWorlds()->GetWorld(WorldID)->m_Sleeping)
+						MultiWorlds()->GetWorld(WorldID)->m_pGameServer->OnTick();
+				});
 			}
 
 			if(NewTicks)
@@ -1918,16 +2137,9 @@ int CServer::Run()
 						return -1;
 					}
 					
-					for(int i = 0; i < MultiWorlds()->GetSizeInitilized(); i++)
-					{
-						// load map data
-						if(!LoadMap(i))
-						{
-							str_format(aBuf, sizeof(aBuf), "maps/%s the map is not loaded...", MultiWorlds()->GetWorld(i)->m_aPath);
-							Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", aBuf);
-							return -1;
-						}
-					}
+					// load map data
+					if(!LoadWorldMaps())
+						return -1;
 
 					if(m_HeavyReload)
 					{
@@ -1950,11 +2162,7 @@ int CServer::Run()
 					}
 
 					// reinit gamecontext
-					for(int i = 0; i < MultiWorlds()->GetSizeInitilized(); i++)
-					{
-						IGameServer* pGameServer = MultiWorlds()->GetWorld(i)->m_pGameServer;
-						pGameServer->OnInit(i);
-					}
+					InitWorlds();
 
 					UpdateServerInfo(true);
 					Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "server", "A server was heavy reload.");
@@ -1964,8 +2172,7 @@ int CServer::Run()
 					// snap game
 					if(g_Config.m_SvHighBandwidth || ShouldSnap)
 					{
-						for(int i = 0; i < MultiWorlds()->GetSizeInitilized(); i++)
-							DoSnapshot(i);
+						DoSnapshot();
 					}
 					UpdateClientRconCommands();
 				}
@@ -1984,6 +2191,9 @@ int CServer::Run()
 		}
 	}
 
+	// finish pending queries while the worlds are still alive
+	Database->Flush();
+
 	// disconnect all clients on shutdown
 	m_NetServer.Close();
 	m_Econ.Shutdown();
@@ -2017,8 +2227,10 @@ void CServer::ConStatus(IConsole::IResult *pResult, void *pUser)
 			{
 				const char *pAuthStr = pThis->m_aClients[i].m_Authed == AUTHED_ADMIN ? "(Admin)" :
 										pThis->m_aClients[i].m_Authed == AUTHED_MOD ? "(Mod)" : "";
-				str_format(aBuf, sizeof(aBuf), "id=%d addr=%s client=%d name='%s' score=%d %s", i, aAddrStr,
-					pThis->m_aClients[i].m_DDNetVersion, pThis->m_aClients[i].m_aName, pThis->m_aClients[i].m_Score, pAuthStr);
+				const CSnapshotStorage& Snapshots = pThis->m_aClients[i].m_Snapshots;
+				str_format(aBuf, sizeof(aBuf), "id=%d addr=%s client=%d name='%s' score=%d snapshots=%d (%d/%d bytes) %s", i, aAddrStr,
+					pThis->m_aClients[i].m_DDNetVersion, pThis->m_aClients[i].m_aName, pThis->m_aClients[i].m_Score,
+					Snapshots.NumSnapshots(), Snapshots.RetainedBytes(), Snapshots.CapacityBytes(), pAuthStr);
 			}
 			else
 				str_format(aBuf, sizeof(aBuf), "id=%d addr=%s connecting", i, aAddrStr);
@@ -2166,18 +2378,62 @@ void CServer::InitClientBot(int ClientID)
 
 int CServer::SnapNewID()
 {
+	std::lock_guard<std::mutex> Lock(m_IDPoolLock);
 	return m_IDPool.NewID();
 }
 
 void CServer::SnapFreeID(int ID)
 {
+	std::lock_guard<std::mutex> Lock(m_IDPoolLock);
 	m_IDPool.FreeID(ID);
 }
 
 void *CServer::SnapNewItem(int Type, int ID, int Size)
 {
 	dbg_assert(ID >= 0 && ID <=0xffff, "incorrect id");
-	return ID < 0 ? nullptr : m_SnapshotBuilder.NewItem(Type, ID, Size);
+	if(ID < 0)
+		return nullptr;
+
+	if(!s_Fragment.m_Recording)
+		return s_SnapshotBuilder.NewItem(Type, ID, Size);
+
+	// type, id and size in front of the data
+	const int NumInts = 3 + Size / (int)sizeof(int);
+	if(Size % (int)sizeof(int) != 0 || s_Fragment.m_NumInts + NumInts > (int)std::size(s_Fragment.m_aData))
+		return nullptr;
+
+	int *pItem = &s_Fragment.m_aData[s_Fragment.m_NumInts];
+	s_Fragment.m_NumInts += NumInts;
+	pItem[0] = Type;
+	pItem[1] = ID;
+	pItem[2] = Size;
+	mem_zero(pItem + 3, Size);
+	return pItem + 3;
+}
+
+void CServer::SnapBeginFragment()
+{
+	s_Fragment.m_Recording = true;
+	s_Fragment.m_NumInts = 0;
+}
+
+int CServer::SnapEndFragment(const void **ppData)
+{
+	s_Fragment.m_Recording = false;
+	*ppData = s_Fragment.m_aData;
+	return s_Fragment.m_NumInts * (int)sizeof(int);
+}
+
+void CServer::SnapAddFragment(const void *pData, int Size)
+{
+	const int *pItem = (const int *)pData;
+	const int *pEnd = pItem + Size / (int)sizeof(int);
+	while(pItem < pEnd)
+	{
+		if(void *pObj = s_SnapshotBuilder.NewItem(pItem[0], pItem[1], pItem[2]))
+			mem_copy(pObj, pItem + 3, pItem[2]);
+		pItem += 3 + pItem[2] / (int)sizeof(int);
+	}
 }
 
 void CServer::SnapSetStaticsize(int ItemType, int Size)
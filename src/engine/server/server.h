@@ -6,6 +6,10 @@
 
 #include <engine/shared/uuid_manager.h>
 
+#include <functional>
+#include <mutex>
+#include <vector>
+
 class CServer : public IServer
 {
 	class IConsole *m_pConsole;
@@ -13,6 +17,7 @@ class CServer : public IServer
 	class CMultiWorlds* m_pMultiWorlds;
 	class CServerBan* m_pServerBan;
 	class DiscordJob* m_pDiscord;
+	class CWorldThreadPool* m_pWorldPool;
 
 public:
 	class IGameServer* GameServer(int WorldID = 0) override;
@@ -69,6 +74,7 @@ public:
 		char m_aNameChangeRequest[MAX_NAME_LENGTH];
 		char m_aClan[MAX_CLAN_LENGTH];
 		char m_aLanguage[MAX_LANGUAGE_LENGTH];
+		int m_LanguageID;
 
 		int m_Version;
 		int m_Country;
@@ -81,7 +87,11 @@ public:
 		int m_OldWorldID;
 		bool m_IsChangesWorld;
 
+		// map transfer, every chunk below m_NextMapChunk was sent
 		int m_NextMapChunk;
+		int64 m_MapTransferStart;
+		int m_MapTransferChunks;
+		int m_MapTransferRequests;
 		bool m_Quitting;
 		const IConsole::CCommandInfo *m_pRconCmdToSend;
 
@@ -102,7 +112,6 @@ public:
 	int m_aIdMap[MAX_CLIENTS * VANILLA_MAX_CLIENTS];
 
 	CSnapshotDelta m_SnapshotDelta;
-	CSnapshotBuilder m_SnapshotBuilder;
 	CSnapIDPool m_IDPool;
 	CNetServer m_NetServer;
 	CEcon m_Econ;
@@ -114,14 +123,43 @@ public:
 	int m_PrintCBIndex;
 	bool m_HeavyReload;
 
+	// parallel worlds
+	bool m_InWorldStage;
+	std::mutex m_NetSendLock;
+	std::mutex m_IDPoolLock;
+	std::mutex m_CrossWorldLock;
+	std::vector<std::function<void()>> m_aCrossWorldQueue;
+
+	// snapshots are built concurrently and sent afterwards in client order
+	struct CSnapJob
+	{
+		int m_ClientID;
+		int m_DeltaTick;
+		int m_Crc;
+		int m_Size; // 0 for an empty delta, -1 if it could not be compressed
+		char m_aCompData[CSnapshot::MAX_SIZE];
+	};
+	CSnapJob m_aSnapJobs[MAX_PLAYERS];
+
 	// map
 	enum
 	{
 		MAP_CHUNK_SIZE=NET_MAX_PAYLOAD-NET_MAX_CHUNKHEADERSIZE-4, // msg type
+		MAP_DATA_CHUNK_SIZE=1024-128, // the chunk size the clients were always sent
 	};
 	int m_MapChunksPerRequest;
 	int m_DataChunksPerRequest;
 
+	// the map of every world split into download chunks when it is loaded
+	struct CMapTransfer
+	{
+		const unsigned char *m_pData;
+		int m_Size;
+		int m_NumChunks;
+		unsigned m_Crc;
+	};
+	CMapTransfer m_aMapTransfers[ENGINE_MAX_WORLDS];
+
 	int m_RconPasswordSet;
 	int m_GeneratedRconPassword;
 
@@ -156,10 +194,12 @@ public:
 
 	bool IsClientChangesWorld(int ClientID) override;
 	void ChangeWorld(int ClientID, int NewWorldID) override;
+	void ExecuteCrossWorld(std::function<void()> Func) override;
 	int GetClientWorldID(int ClientID) override;
 
 	void SetClientLanguage(int ClientID, const char* pLanguage) override;
 	const char* GetClientLanguage(int ClientID) const override;
+	int GetClientLanguageID(int ClientID) const override;
 	const char* GetWorldName(int WorldID) override;
 	int GetWorldsSize() const override;
 
@@ -197,7 +237,11 @@ public:
 	int GetClientVersion(int ClientID) const override;
 	int SendMsg(CMsgPacker* pMsg, int Flags, int ClientID, int64 Mask = -1, int WorldID = -1) override;
 
-	void DoSnapshot(int WorldID);
+	void DoSnapshot();
+	void BuildSnapshot(CSnapJob& Job);
+	void SendSnapshot(const CSnapJob& Job);
+	void RunWorldStage(const std::function<void(int)>& Func);
+	void UpdateWorldsHibernation();
 
 	static int NewClientCallback(int ClientID, void* pUser, bool Sixup);
 	static int NewClientNoAuthCallback(int ClientID, void* pUser);
@@ -205,6 +249,7 @@ public:
 	static int ClientRejoinCallback(int ClientID, void* pUser);
 
 	void SendMapData(int ClientID, int Chunk);
+	void SendMapWindow(int ClientID, int Chunk);
 	void SendCapabilities(int ClientID);
 	void SendMap(int ClientID);
 	void SendConnectionReady(int ClientID);
@@ -255,6 +300,20 @@ public:
 
 	bool LoadMap(int ID);
 
+	// worlds start in stages, each stage runs the worlds on the pool
+	enum
+	{
+		STARTUP_MAP = 0,
+		STARTUP_PRECOMPUTE,
+		STARTUP_INIT,
+		NUM_STARTUP_STAGES
+	};
+	int64 m_aaStartupTime[ENGINE_MAX_WORLDS][NUM_STARTUP_STAGES];
+	int64 m_aStartupStageTime[NUM_STARTUP_STAGES];
+	void RunStartupStage(int Stage, bool Parallel, const std::function<void(int)>& Func);
+	bool LoadWorldMaps();
+	void InitWorlds();
+
 	void InitRegister(CNetServer *pNetServer, IEngineMasterServer *pMasterServer, IConsole *pConsole);
 	int Run();
 
@@ -279,6 +338,9 @@ public:
 	void SnapFreeID(int ID) override;
 	void *SnapNewItem(int Type, int ID, int Size) override;
 	void SnapSetStaticsize(int ItemType, int Size) override;
+	void SnapBeginFragment() override;
+	int SnapEndFragment(const void **ppData) override;
+	void SnapAddFragment(const void *pData, int Size) override;
 
 	int* GetIdMap(int ClientID) override;
 };
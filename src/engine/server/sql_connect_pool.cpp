@@ -4,25 +4,24 @@
 
 #include <engine/shared/config.h>
 
+#include <cctype>
+#include <map>
+
 /*
-	I don't see the point in using SELECT operations in the thread,
-	since this will lead to unnecessary code, which may cause confusion,
-	and by calculations if (SQL server / server) = localhost,
-	this will not do any harm (but after the release is complete,
-	it is advisable to use the Thread function with Callback)
-	And in General, you should review the SQL system,
-	it works (and has been tested by time and tests),
-	but this implementation is not very narrowly focused
-	This approach works if the old query is not executed before,
-	 a new query it will create a reserve.
-	 It may seem that it does not use Pool,
-	 but in fact it is and is created as a reserve when running
-	 <tlock>
-	 Usage is performed in turn following synchronously
-	 working running through each request in order
-	 This pool is not asynchronous
+	Queries are executed by a fixed set of workers, every worker owns
+	its own connection and a lock-free queue. All queries of a table go
+	to the same worker, so they are executed in the order they were
+	made: a write is never overtaken by a later write or select of the
+	same row. Results never leave the worker thread through the
+	callback directly, finished queries are collected in the completion
+	queue and the callbacks are executed on the tick thread in Update().
+	When the total amount of queued queries reaches sv_sql_queue_size
+	the producer is throttled until the workers catch up.
+	Bound queries (PrepareBind/ExecuteBind) are prepared once per worker
+	connection and reused, only the arguments are sent afterwards.
+	Synchronous selects use a separate connection, they first wait until
+	the queries made before them on their tables are executed.
 */
-std::atomic_flag g_atomic_lock;
 
 // #####################################################
 // SQL CONNECTION POOL
@@ -32,7 +31,7 @@ void CConectionPool::Initilize()
 {
 	if(m_ptrInstance)
 		m_ptrInstance.reset();
-	m_ptrInstance = std::make_shared<CConectionPool>(std::forward<CConectionPool>({}));
+	m_ptrInstance.reset(new CConectionPool());
 }
 
 std::shared_ptr<CConectionPool> CConectionPool::GetInstance()
@@ -45,14 +44,22 @@ CConectionPool::CConectionPool()
 	try
 	{
 		m_pDriver = get_driver_instance();
+		m_pSyncConnection = CreateConnection();
 		for(int i = 0; i < g_Config.m_SvMySqlPoolSize; ++i)
-			this->CreateConnection();
+		{
+			std::unique_ptr<CWorker> pWorker = std::make_unique<CWorker>();
+			pWorker->m_pConnection = CreateConnection();
+			m_apWorkers.push_back(std::move(pWorker));
+		}
 	}
 	catch (SQLException& e)
 	{
 		dbg_msg("Sql Exception", "%s", e.what());
 		exit(0);
 	}
+
+	for(auto& pWorker : m_apWorkers)
+		pWorker->m_Thread = std::thread(&CConectionPool::WorkerThread, this, pWorker.get());
 }
 
 CConectionPool::~CConectionPool()
@@ -62,27 +69,35 @@ CConectionPool::~CConectionPool()
 
 void CConectionPool::DisconnectConnectionHeap()
 {
-	g_atomic_lock.test_and_set(std::memory_order_acquire);
-	while(!m_ConnList.empty())
+	// the workers execute everything that is still queued before they leave
+	m_Shutdown.store(true);
+	for(auto& pWorker : m_apWorkers)
 	{
-		std::shared_ptr<Connection> pConnection = m_ConnList.front();
-		m_ConnList.pop_front();
-
-		try
-		{
-			if(pConnection)
-			{
-				pConnection->close();
-			}
-		}
-		catch(SQLException& e)
 		{
-			dbg_msg("Sql Exception", "%s", e.what());
+			std::lock_guard<std::mutex> Lock(pWorker->m_SleepLock);
+			pWorker->m_WakeUp.notify_one();
 		}
+		if(pWorker->m_Thread.joinable())
+			pWorker->m_Thread.join();
 
-		pConnection.reset();
+		pWorker->m_aStatements.clear();
+		DisconnectConnection(pWorker->m_pConnection);
+		pWorker->m_pConnection.reset();
+	}
+
+	// nobody is left to run the callbacks
+	while(m_CompletedDepth.load() > 0)
+	{
+		CQueryTask* pTask = m_Completed.Pop();
+		if(!pTask)
+			break;
+		m_CompletedDepth.fetch_sub(1);
+		delete pTask;
 	}
-	g_atomic_lock.clear(std::memory_order_release);
+
+	std::lock_guard<std::mutex> Lock(m_SyncLock);
+	DisconnectConnection(m_pSyncConnection);
+	m_pSyncConnection.reset();
 }
 
 std::shared_ptr<Connection> CConectionPool::CreateConnection()
@@ -108,64 +123,365 @@ std::shared_ptr<Connection> CConectionPool::CreateConnection()
 		{
 			dbg_msg("Sql Exception", "%s", e.what());
 			DisconnectConnection(pConnection);
+			pConnection.reset();
 		}
 	}
-
-	g_atomic_lock.test_and_set(std::memory_order_acquire);
-	m_ConnList.push_back(pConnection);
-	g_atomic_lock.clear(std::memory_order_release);
 	return pConnection;
 }
 
-std::shared_ptr<Connection> CConectionPool::GetConnection()
+void CConectionPool::DisconnectConnection(std::shared_ptr<Connection> pConnection)
 {
-	std::shared_ptr<Connection> pConnection;
-	if(m_ConnList.empty())
+	try
 	{
-		pConnection = CreateConnection();
-		return pConnection;
+		if(pConnection)
+		{
+			pConnection->close();
+		}
 	}
+	catch (SQLException& e)
+	{
+		dbg_msg("Sql Exception", "%s", e.what());
+	}
+}
 
-	g_atomic_lock.test_and_set(std::memory_order_acquire);
-	pConnection = m_ConnList.front();
-	m_ConnList.pop_front();
-	g_atomic_lock.clear(std::memory_order_relaxed);
+// #####################################################
+// TASK QUEUE
+// #####################################################
+void CConectionPool::CTaskQueue::Push(CQueryTask* pTask)
+{
+	pTask->m_pNext.store(nullptr, std::memory_order_relaxed);
+	CQueryTask* pPrev = m_pHead.exchange(pTask, std::memory_order_acq_rel);
+	pPrev->m_pNext.store(pTask, std::memory_order_release);
+}
 
-	if (pConnection->isClosed())
+CConectionPool::CQueryTask* CConectionPool::CTaskQueue::Pop()
+{
+	// returns nullptr if the queue is empty or a producer has not finished linking yet
+	CQueryTask* pTail = m_pTail;
+	CQueryTask* pNext = pTail->m_pNext.load(std::memory_order_acquire);
+	if(pTail == &m_Stub)
 	{
-		pConnection.reset();
-		pConnection = CreateConnection();
+		if(!pNext)
+			return nullptr;
+		m_pTail = pNext;
+		pTail = pNext;
+		pNext = pNext->m_pNext.load(std::memory_order_acquire);
 	}
 
-	return pConnection;
+	if(pNext)
+	{
+		m_pTail = pNext;
+		return pTail;
+	}
+
+	if(pTail != m_pHead.load(std::memory_order_acquire))
+		return nullptr;
+
+	Push(&m_Stub);
+	pNext = pTail->m_pNext.load(std::memory_order_acquire);
+	if(pNext)
+	{
+		m_pTail = pNext;
+		return pTail;
+	}
+	return nullptr;
 }
 
-void CConectionPool::ReleaseConnection(std::shared_ptr<Connection> pConnection)
+// #####################################################
+// WORKERS
+// #####################################################
+std::string CConectionPool::QueryTable(const std::string& Query)
 {
-	if (pConnection)
+	// the first name after INTO, UPDATE or FROM
+	size_t Start = std::string::npos;
+	for(const char* pKeyword : { "INTO ", "UPDATE ", "FROM " })
 	{
-		g_atomic_lock.test_and_set(std::memory_order_acquire);
-		m_ConnList.push_back(pConnection);
-		g_atomic_lock.clear(std::memory_order_release);
+		const size_t Pos = Query.find(pKeyword);
+		if(Pos != std::string::npos && (Start == std::string::npos || Pos + str_length(pKeyword) < Start))
+			Start = Pos + str_length(pKeyword);
 	}
+	if(Start == std::string::npos)
+		return std::string();
+
+	size_t End = Start;
+	while(End < Query.size() && (isalnum((unsigned char)Query[End]) || Query[End] == '_'))
+		End++;
+	return Query.substr(Start, End - Start);
 }
 
-void CConectionPool::DisconnectConnection(std::shared_ptr<Connection> pConnection)
+CConectionPool::CWorker* CConectionPool::WorkerFor(const std::string& Table) const
+{
+	return m_apWorkers[std::hash<std::string>()(Table) % m_apWorkers.size()].get();
+}
+
+void CConectionPool::WaitForTables(const std::string& Tables)
+{
+	if(m_apWorkers.empty())
+		return;
+
+	// every name of the table list counts, joins and aliases only make it wait for more
+	std::string Name;
+	for(size_t i = 0; i <= Tables.size(); i++)
+	{
+		if(i < Tables.size() && (isalnum((unsigned char)Tables[i]) || Tables[i] == '_'))
+		{
+			Name += Tables[i];
+			continue;
+		}
+		if(Name.empty())
+			continue;
+
+		CWorker* pWorker = WorkerFor(Name);
+		const uint64_t Queued = pWorker->m_NumQueued.load();
+		while(pWorker->m_NumHandled.load() < Queued)
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+		Name.clear();
+	}
+}
+
+void CConectionPool::Enqueue(CQueryTask* pTask, const std::string& Table)
+{
+	if(m_Shutdown.load() || m_apWorkers.empty())
+	{
+		dbg_msg("SQL", "query dropped, the pool is shut down: %s", pTask->m_Query.c_str());
+		delete pTask;
+		return;
+	}
+
+	// backpressure: do not let the producer run away from the database
+	if(m_QueueDepth.load(std::memory_order_relaxed) >= g_Config.m_SvMySqlQueueSize)
+	{
+		dbg_msg("SQL", "queue is full (%d queries), waiting for the workers", m_QueueDepth.load(std::memory_order_relaxed));
+		while(m_QueueDepth.load(std::memory_order_relaxed) >= g_Config.m_SvMySqlQueueSize)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	m_QueueDepth.fetch_add(1);
+
+	CWorker* pWorker = WorkerFor(Table.empty() ? QueryTable(pTask->m_Query) : Table);
+	pWorker->m_NumQueued.fetch_add(1);
+	pWorker->m_Pending.fetch_add(1);
+	pWorker->m_Queue.Push(pTask);
+	if(pWorker->m_Sleeping.load())
+	{
+		std::lock_guard<std::mutex> Lock(pWorker->m_SleepLock);
+		pWorker->m_WakeUp.notify_one();
+	}
+}
+
+PreparedStatement* CConectionPool::GetStatement(CWorker* pWorker, const std::string& Query)
+{
+	auto Iter = pWorker->m_aStatements.find(Query);
+	if(Iter != pWorker->m_aStatements.end())
+		return Iter->second.get();
+
+	// the templates are static strings, only generated ones can overflow the cache
+	if(pWorker->m_aStatements.size() >= MAX_PREPARED_STATEMENTS)
+		pWorker->m_aStatements.clear();
+
+	std::unique_ptr<PreparedStatement> pStmt(pWorker->m_pConnection->prepareStatement(Query.c_str()));
+	return pWorker->m_aStatements.emplace(Query, std::move(pStmt)).first->second.get();
+}
+
+bool CConectionPool::ExecuteTask(CWorker* pWorker, CQueryTask* pTask)
 {
+	if(!pWorker->m_pConnection || pWorker->m_pConnection->isClosed())
+	{
+		pWorker->m_aStatements.clear();
+		pWorker->m_pConnection = CreateConnection();
+	}
+
 	try
 	{
-		if(pConnection)
+		if(pTask->m_Prepared)
 		{
-			pConnection->close();
+			PreparedStatement* pStmt = GetStatement(pWorker, pTask->m_Query);
+			for(unsigned i = 0; i < pTask->m_aArguments.size(); i++)
+			{
+				const BindValue& Argument = pTask->m_aArguments[i];
+				if(const int* pValue = std::get_if<int>(&Argument))
+					pStmt->setInt(i + 1, *pValue);
+				else if(const int64_t* pValue = std::get_if<int64_t>(&Argument))
+					pStmt->setInt64(i + 1, *pValue);
+				else if(const double* pValue = std::get_if<double>(&Argument))
+					pStmt->setDouble(i + 1, *pValue);
+				else
+					pStmt->setString(i + 1, std::get<std::string>(Argument));
+			}
+			pStmt->execute();
+		}
+		else
+		{
+			const std::unique_ptr<Statement> pStmt(pWorker->m_pConnection->createStatement());
+			if(pTask->m_TypeQuery == DB::SELECT)
+				pTask->m_pResult.reset(pStmt->executeQuery(pTask->m_Query.c_str()));
+			else
+				pStmt->execute(pTask->m_Query.c_str());
+			pStmt->close();
 		}
+		pTask->m_Success = true;
 	}
 	catch (SQLException& e)
 	{
-		dbg_msg("Sql Exception", "%s", e.what());
+		dbg_msg("SQL", "%s", e.what());
+
+		// the statement may belong to a broken connection
+		if(pTask->m_Prepared)
+			pWorker->m_aStatements.erase(pTask->m_Query);
+	}
+	m_QueueDepth.fetch_sub(1);
+
+	// hand the result back to the tick thread
+	if(pTask->m_Success && (pTask->m_pCallbackResult || pTask->m_pCallbackUpdate))
+	{
+		m_CompletedDepth.fetch_add(1);
+		m_Completed.Push(pTask);
+		return true;
+	}
+
+	const bool Success = pTask->m_Success;
+	delete pTask;
+	return Success;
+}
+
+void CConectionPool::WorkerThread(CWorker* pWorker)
+{
+	m_pDriver->threadInit();
+
+	std::multimap<std::chrono::steady_clock::time_point, CQueryTask*> Delayed;
+	while(true)
+	{
+		while(pWorker->m_Pending.load() > 0)
+		{
+			CQueryTask* pTask = pWorker->m_Queue.Pop();
+			if(!pTask)
+				break;
+			pWorker->m_Pending.fetch_sub(1);
+
+			if(!m_Shutdown.load() && pTask->m_ExecuteTime > std::chrono::steady_clock::now())
+				Delayed.emplace(pTask->m_ExecuteTime, pTask);
+			else
+				ExecuteTask(pWorker, pTask);
+
+			// delayed queries were asked to run later, nobody waits for them
+			pWorker->m_NumHandled.fetch_add(1);
+		}
+
+		const auto Now = std::chrono::steady_clock::now();
+		while(!Delayed.empty() && (m_Shutdown.load() || Delayed.begin()->first <= Now))
+		{
+			CQueryTask* pTask = Delayed.begin()->second;
+			Delayed.erase(Delayed.begin());
+			ExecuteTask(pWorker, pTask);
+		}
+
+		if(m_Shutdown.load() && Delayed.empty() && pWorker->m_Pending.load() == 0)
+			break;
+
+		std::unique_lock<std::mutex> Lock(pWorker->m_SleepLock);
+		pWorker->m_Sleeping.store(true);
+		auto HasWork = [this, pWorker]() { return pWorker->m_Pending.load() > 0 || m_Shutdown.load(); };
+		if(Delayed.empty())
+			pWorker->m_WakeUp.wait(Lock, HasWork);
+		else
+			pWorker->m_WakeUp.wait_until(Lock, Delayed.begin()->first, HasWork);
+		pWorker->m_Sleeping.store(false);
 	}
 
-	g_atomic_lock.test_and_set(std::memory_order_acquire);
-	m_ConnList.remove(pConnection);
-	pConnection.reset();
-	g_atomic_lock.clear(std::memory_order_release);
-}
\ No newline at end of file
+	m_pDriver->threadEnd();
+}
+
+void CConectionPool::Update()
+{
+	while(m_CompletedDepth.load() > 0)
+	{
+		// a worker may still be linking the task, it will be picked up on the next call
+		CQueryTask* pTask = m_Completed.Pop();
+		if(!pTask)
+			break;
+		m_CompletedDepth.fetch_sub(1);
+
+		try
+		{
+			if(pTask->m_pCallbackResult)
+				pTask->m_pCallbackResult(std::move(pTask->m_pResult));
+			else if(pTask->m_pCallbackUpdate)
+				pTask->m_pCallbackUpdate();
+		}
+		catch (SQLException& e)
+		{
+			dbg_msg("SQL", "%s", e.what());
+		}
+		delete pTask;
+	}
+}
+
+void CConectionPool::Flush()
+{
+	while(m_QueueDepth.load() > 0 || m_CompletedDepth.load() > 0)
+	{
+		Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+// #####################################################
+// RESULTS
+// #####################################################
+ResultPtr CConectionPool::CResultSelect::Execute() const
+{
+	CConectionPool* pPool = Database;
+	ResultPtr pResult = nullptr;
+
+	pPool->WaitForTables(m_Table);
+
+	std::lock_guard<std::mutex> Lock(pPool->m_SyncLock);
+	pPool->m_pDriver->threadInit();
+	if(!pPool->m_pSyncConnection || pPool->m_pSyncConnection->isClosed())
+		pPool->m_pSyncConnection = pPool->CreateConnection();
+
+	try
+	{
+		const std::unique_ptr<Statement> pStmt(pPool->m_pSyncConnection->createStatement());
+		pResult.reset(pStmt->executeQuery(m_Query.c_str()));
+		pStmt->close();
+	}
+	catch (SQLException& e)
+	{
+		dbg_msg("SQL", "%s", e.what());
+	}
+	pPool->m_pDriver->threadEnd();
+	return pResult;
+}
+
+void CConectionPool::CResultSelect::AtExecute(const CallbackResultPtr& pCallbackResult)
+{
+	CQueryTask* pTask = new CQueryTask;
+	pTask->m_Query = m_Query;
+	pTask->m_TypeQuery = DB::SELECT;
+	pTask->m_pCallbackResult = pCallbackResult;
+	Database->Enqueue(pTask, m_Table);
+}
+
+void CConectionPool::CResultQuery::AtExecute(const CallbackUpdatePtr& pCallbackResult, int DelayMilliseconds)
+{
+	CQueryTask* pTask = new CQueryTask;
+	pTask->m_Query = m_Query;
+	pTask->m_TypeQuery = m_TypeQuery;
+	pTask->m_pCallbackUpdate = pCallbackResult;
+	if(DelayMilliseconds > 0)
+		pTask->m_ExecuteTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(DelayMilliseconds);
+	Database->Enqueue(pTask, m_Table);
+}
+
+void CConectionPool::CResultBind::AtExecute(const CallbackUpdatePtr& pCallbackResult, int DelayMilliseconds)
+{
+	CQueryTask* pTask = new CQueryTask;
+	pTask->m_Query = m_Query;
+	pTask->m_TypeQuery = m_TypeQuery;
+	pTask->m_Prepared = true;
+	pTask->m_aArguments = m_aArguments;
+	pTask->m_pCallbackUpdate = pCallbackResult;
+	if(DelayMilliseconds > 0)
+		pTask->m_ExecuteTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(DelayMilliseconds);
+	Database->Enqueue(pTask, m_Table);
+}
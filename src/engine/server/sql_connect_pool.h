@@ -6,15 +6,27 @@
 	#define throw(...)
 	#include <cppconn/driver.h>
 	#include <cppconn/statement.h>
+	#include <cppconn/prepared_statement.h>
 	#include <cppconn/resultset.h>
 	#undef throw /* reset */
 #else
 	#include <cppconn/driver.h>
 	#include <cppconn/statement.h>
+	#include <cppconn/prepared_statement.h>
 	#include <cppconn/resultset.h>
 #endif
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+#include <vector>
 
 using namespace sql;
 
@@ -34,6 +46,7 @@ enum class DB
  * defined
  */
 #define MAX_QUERY_LEN 2048
+#define MAX_PREPARED_STATEMENTS 128
 #define FORMAT_STRING_ARGS(format, output, len) \
 {                                               \
 	va_list ap;                                 \
@@ -45,7 +58,6 @@ enum class DB
 	(output) = buffer;                          \
 }
 #define Database CConectionPool::GetInstance().get()
-inline std::recursive_mutex g_SqlThreadRecursiveLock;
 
 /*
  * using typename
@@ -53,6 +65,7 @@ inline std::recursive_mutex g_SqlThreadRecursiveLock;
 using ResultPtr = std::unique_ptr<ResultSet>;
 using CallbackResultPtr = std::function<void(ResultPtr)>;
 using CallbackUpdatePtr = std::function<void()>;
+using BindValue = std::variant<int, int64_t, double, std::string>;
 
 /*
  * class
@@ -69,20 +82,87 @@ private:
 	CConectionPool();
 
 	std::shared_ptr<Connection> CreateConnection();
-	std::shared_ptr<Connection> GetConnection();
-	void ReleaseConnection(std::shared_ptr<Connection> pConnection);
 	void DisconnectConnection(std::shared_ptr<Connection> pConnection);
 
 	static std::shared_ptr<CConectionPool> m_ptrInstance;
-	std::list<std::shared_ptr<Connection>> m_ConnList;
 	Driver* m_pDriver;
 
+	// query that travels from the producer to a worker and back to the tick thread
+	struct CQueryTask
+	{
+		std::atomic<CQueryTask*> m_pNext{ nullptr };
+		std::string m_Query;
+		DB m_TypeQuery{ DB::OTHER };
+		std::chrono::steady_clock::time_point m_ExecuteTime;
+		CallbackResultPtr m_pCallbackResult;
+		CallbackUpdatePtr m_pCallbackUpdate;
+		bool m_Prepared{ false };
+		std::vector<BindValue> m_aArguments;
+		ResultPtr m_pResult;
+		bool m_Success{ false };
+	};
+
+	// intrusive lock-free multi-producer single-consumer queue
+	class CTaskQueue
+	{
+		std::atomic<CQueryTask*> m_pHead;
+		CQueryTask* m_pTail;
+		CQueryTask m_Stub;
+
+	public:
+		CTaskQueue() : m_pHead(&m_Stub), m_pTail(&m_Stub) {}
+		CTaskQueue(const CTaskQueue&) = delete;
+		void Push(CQueryTask* pTask);
+		CQueryTask* Pop();
+	};
+
+	// each worker owns its connection, nothing is shared between workers
+	struct CWorker
+	{
+		std::thread m_Thread;
+		std::shared_ptr<Connection> m_pConnection;
+		std::unordered_map<std::string, std::unique_ptr<PreparedStatement>> m_aStatements;
+		CTaskQueue m_Queue;
+		std::atomic<int> m_Pending{ 0 };
+		std::atomic<uint64_t> m_NumQueued{ 0 };
+		std::atomic<uint64_t> m_NumHandled{ 0 };
+		std::atomic<bool> m_Sleeping{ false };
+		std::mutex m_SleepLock;
+		std::condition_variable m_WakeUp;
+	};
+
+	void WorkerThread(CWorker* pWorker);
+	PreparedStatement* GetStatement(CWorker* pWorker, const std::string& Query);
+	bool ExecuteTask(CWorker* pWorker, CQueryTask* pTask);
+	void Enqueue(CQueryTask* pTask, const std::string& Table);
+	CWorker* WorkerFor(const std::string& Table) const;
+	void WaitForTables(const std::string& Tables);
+	static std::string QueryTable(const std::string& Query);
+
+	std::vector<std::unique_ptr<CWorker>> m_apWorkers;
+	std::atomic<bool> m_Shutdown{ false };
+	std::atomic<int> m_QueueDepth{ 0 };
+	CTaskQueue m_Completed;
+	std::atomic<int> m_CompletedDepth{ 0 };
+
+	// connection for synchronous selects, callers may come from any thread
+	std::shared_ptr<Connection> m_pSyncConnection;
+	std::mutex m_SyncLock;
+
 public:
 	~CConectionPool();
 
 	// functions
 	void DisconnectConnectionHeap();
 
+	// run callbacks of finished queries, must be called from the tick thread
+	void Update();
+
+	// wait until every queued query is executed and its callback has run
+	void Flush();
+
+	int GetQueueDepth() const { return m_QueueDepth.load(std::memory_order_relaxed); }
+
 	// database extraction function
 private:
 	class CResultBase
@@ -90,6 +170,7 @@ private:
 	protected:
 		friend class CConectionPool;
 		std::string m_Query;
+		std::string m_Table;
 		DB m_TypeQuery;
 	public:
 		const char* GetQueryString() const { return m_Query.c_str(); }
@@ -103,69 +184,12 @@ private:
 			std::string strQuery;
 			FORMAT_STRING_ARGS(pBuffer, strQuery, MAX_QUERY_LEN);
 			m_Query = std::string("SELECT " + std::string(pSelect) + " FROM " + std::string(pTable) + " " + strQuery + ";");
+			m_Table = pTable;
 			return *this;
 		}
 
-		[[nodiscard]] ResultPtr Execute() const
-		{
-			const char* pError = nullptr;
-
-			g_SqlThreadRecursiveLock.lock();
-			Database->m_pDriver->threadInit();
-			std::shared_ptr<Connection> pConnection = Database->GetConnection();
-			ResultPtr pResult = nullptr;
-			try
-			{
-				const std::unique_ptr<Statement> pStmt(pConnection->createStatement());
-				pResult.reset(pStmt->executeQuery(m_Query.c_str()));
-				pStmt->close();
-			}
-			catch (SQLException& e)
-			{
-				pError = e.what();
-			}
-			Database->ReleaseConnection(pConnection);
-			Database->m_pDriver->threadEnd();
-			g_SqlThreadRecursiveLock.unlock();
-
-			if (pError != nullptr)
-				dbg_msg("SQL", "%s", pError);
-
-			return pResult;
-		}
-
-		void AtExecute(const CallbackResultPtr& pCallbackResult)
-		{
-			auto Item = [pCallbackResult](const std::string Query)
-			{
-				const char* pError = nullptr;
-
-				g_SqlThreadRecursiveLock.lock();
-				Database->m_pDriver->threadInit();
-				std::shared_ptr<Connection> pConnection = Database->GetConnection();
-				try
-				{
-					const std::unique_ptr<Statement> pStmt(pConnection->createStatement());
-					ResultPtr pResult(pStmt->executeQuery(Query.c_str()));
-					if(pCallbackResult)
-					{
-						pCallbackResult(std::move(pResult));
-					}
-					pStmt->close();
-				}
-				catch (SQLException& e)
-				{
-					pError = e.what();
-				}
-				Database->ReleaseConnection(pConnection);
-				Database->m_pDriver->threadEnd();
-				g_SqlThreadRecursiveLock.unlock();
-
-				if (pError != nullptr)
-					dbg_msg("SQL", "%s", pError);
-			};
-			std::thread(Item, m_Query).detach();
-		}
+		[[nodiscard]] ResultPtr Execute() const;
+		void AtExecute(const CallbackResultPtr& pCallbackResult);
 	};
 
 	class CResultQuery : public CResultBase
@@ -182,44 +206,11 @@ private:
 				m_Query = std::string("UPDATE " + std::string(pTable) + " SET " + strQuery + ";");
 			else if (m_TypeQuery == DB::REMOVE)
 				m_Query = std::string("DELETE FROM " + std::string(pTable) + " " + strQuery + ";");
+			m_Table = pTable;
 			return *this;
 		}
 
-		void AtExecute(const CallbackUpdatePtr& pCallbackResult, int DelayMilliseconds = 0)
-		{
-			auto Item = [pCallbackResult](const std::string Query, const int Milliseconds)
-			{
-				if (Milliseconds > 0)
-					std::this_thread::sleep_for(std::chrono::milliseconds(Milliseconds));
-
-				const char* pError = nullptr;
-
-				g_SqlThreadRecursiveLock.lock();
-				Database->m_pDriver->threadInit();
-				std::shared_ptr<Connection> pConnection = Database->GetConnection();
-				try
-				{
-					const std::unique_ptr<Statement> pStmt(pConnection->createStatement());
-					pStmt->execute(Query.c_str());
-					if(pCallbackResult)
-					{
-						pCallbackResult();
-					}
-					pStmt->close();
-				}
-				catch (SQLException& e)
-				{
-					pError = e.what();
-				}
-				Database->ReleaseConnection(pConnection);
-				Database->m_pDriver->threadEnd();
-				g_SqlThreadRecursiveLock.unlock();
-
-				if (pError != nullptr)
-					dbg_msg("SQL", "%s", pError);
-			};
-			std::thread(Item, m_Query, DelayMilliseconds).detach();
-		}
+		void AtExecute(const CallbackUpdatePtr& pCallbackResult, int DelayMilliseconds = 0);
 		void Execute(int DelayMilliseconds = 0) { return AtExecute(nullptr, DelayMilliseconds); }
 	};
 
@@ -235,6 +226,45 @@ private:
 		}
 	};
 
+	// the query is sent once as a template with '?' placeholders and the
+	// statement is reused by the worker, the arguments are never formatted
+	class CResultBind : public CResultBase
+	{
+		friend class CConectionPool;
+		std::vector<BindValue> m_aArguments;
+
+	public:
+		template<typename T>
+		CResultBind& Add(const T& Value)
+		{
+			if constexpr(std::is_enum_v<T> || std::is_same_v<T, bool>)
+				m_aArguments.emplace_back(static_cast<int>(Value));
+			else if constexpr(std::is_integral_v<T>)
+			{
+				if constexpr(sizeof(T) > sizeof(int) || (std::is_unsigned_v<T> && sizeof(T) == sizeof(int)))
+					m_aArguments.emplace_back(static_cast<int64_t>(Value));
+				else
+					m_aArguments.emplace_back(static_cast<int>(Value));
+			}
+			else if constexpr(std::is_floating_point_v<T>)
+				m_aArguments.emplace_back(static_cast<double>(Value));
+			else
+				m_aArguments.emplace_back(std::string(Value));
+			return *this;
+		}
+
+		template<typename ... Ts>
+		CResultBind& Bind(const Ts&... Args)
+		{
+			m_aArguments.clear();
+			(Add(Args), ...);
+			return *this;
+		}
+
+		void AtExecute(const CallbackUpdatePtr& pCallbackResult, int DelayMilliseconds = 0);
+		void Execute(int DelayMilliseconds = 0) { return AtExecute(nullptr, DelayMilliseconds); }
+	};
+
 	// - - - - - - - - - - - - - - - -
 	// select
 	// - - - - - - - - - - - - - - - -
@@ -242,6 +272,7 @@ private:
 	{
 		CResultSelect Data;
 		Data.m_Query = std::string("SELECT " + std::string(pSelect) + " FROM " + std::string(pTable) + " " + strQuery + ";");
+		Data.m_Table = pTable;
 		Data.m_TypeQuery = Type;
 
 		return std::make_shared<CResultSelect>(Data);
@@ -310,6 +341,7 @@ private:
 	{
 		CResultQuery Data;
 		Data.m_TypeQuery = Type;
+		Data.m_Table = pTable;
 		if(Type == DB::INSERT)
 			Data.m_Query = std::string("INSERT INTO " + std::string(pTable) + " " + strQuery + ";");
 		else if(Type == DB::UPDATE)
@@ -340,6 +372,52 @@ public:
 		// checking format query
 		PrepareQueryInsertUpdateDelete(T, pTable, strQuery)->Execute(Milliseconds);
 	}
+
+	// - - - - - - - - - - - - - - - -
+	// bind : insert : update : delete : custom
+	// - - - - - - - - - - - - - - - -
+private:
+	static std::shared_ptr<CResultBind> PrepareQueryBind(DB Type, const char* pTable, const char* pTemplate)
+	{
+		CResultBind Data;
+		Data.m_TypeQuery = Type;
+		Data.m_Table = pTable;
+		if(Type == DB::INSERT)
+			Data.m_Query = std::string("INSERT INTO " + std::string(pTable) + " " + pTemplate);
+		else if(Type == DB::UPDATE)
+			Data.m_Query = std::string("UPDATE " + std::string(pTable) + " SET " + pTemplate);
+		else if(Type == DB::REMOVE)
+			Data.m_Query = std::string("DELETE FROM " + std::string(pTable) + " " + pTemplate);
+		else
+			Data.m_Query = std::string(pTemplate);
+
+		return std::make_shared<CResultBind>(Data);
+	}
+
+public:
+	template<DB T>
+	static std::enable_if_t<(T == DB::INSERT || T == DB::UPDATE || T == DB::REMOVE), std::shared_ptr<CResultBind>> PrepareBind(const char* pTable, const char* pTemplate)
+	{
+		return PrepareQueryBind(T, pTable, pTemplate);
+	}
+
+	template<DB T>
+	static std::enable_if_t<T == DB::OTHER, std::shared_ptr<CResultBind>> PrepareBind(const char* pTemplate)
+	{
+		return PrepareQueryBind(T, "", pTemplate);
+	}
+
+	template<DB T, int Milliseconds = 0, typename ... Ts>
+	static std::enable_if_t<(T == DB::INSERT || T == DB::UPDATE || T == DB::REMOVE), void> ExecuteBind(const char* pTable, const char* pTemplate, const Ts&... Args)
+	{
+		PrepareQueryBind(T, pTable, pTemplate)->Bind(Args...).Execute(Milliseconds);
+	}
+
+	template<DB T, int Milliseconds = 0, typename ... Ts>
+	static std::enable_if_t<T == DB::OTHER, void> ExecuteBind(const char* pTemplate, const Ts&... Args)
+	{
+		PrepareQueryBind(T, "", pTemplate)->Bind(Args...).Execute(Milliseconds);
+	}
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "world_thread_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+CWorldThreadPool::CWorldThreadPool(int NumThreads)
+{
+	m_Shutdown = false;
+	m_Generation = 0;
+	m_pFunc = nullptr;
+	m_NextTask = 0;
+	m_NumTasks = 0;
+	m_NumFinished = 0;
+	m_NumActive = 0;
+
+	// the thread calling Run() works too
+	for(int i = 1; i < NumThreads; i++)
+		m_aThreads.emplace_back(&CWorldThreadPool::WorkerThread, this);
+}
+
+CWorldThreadPool::~CWorldThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		m_Shutdown = true;
+	}
+	m_WakeUp.notify_all();
+
+	for(auto& Thread : m_aThreads)
+		Thread.join();
+}
+
+void CWorldThreadPool::Run(int NumTasks, const std::function<void(int)>& Func)
+{
+	if(NumTasks <= 0)
+		return;
+
+	if((int)m_aCost.size() != NumTasks)
+		m_aCost.assign(NumTasks, 0);
+
+	// start with the most expensive worlds of the previous stage
+	m_aOrder.resize(NumTasks);
+	std::iota(m_aOrder.begin(), m_aOrder.end(), 0);
+	std::stable_sort(m_aOrder.begin(), m_aOrder.end(), [this](int A, int B) { return m_aCost[A] > m_aCost[B]; });
+
+	{
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		m_pFunc = &Func;
+		m_NumTasks = NumTasks;
+		m_NumFinished = 0;
+		m_NextTask.store(0);
+		m_Generation++;
+	}
+	m_WakeUp.notify_all();
+
+	Process();
+
+	// barrier: every world is done and no worker holds the stage anymore
+	std::unique_lock<std::mutex> Lock(m_Lock);
+	m_Done.wait(Lock, [this]() { return m_NumFinished == m_NumTasks && m_NumActive == 0; });
+	m_pFunc = nullptr;
+}
+
+void CWorldThreadPool::Process()
+{
+	while(true)
+	{
+		const int Index = m_NextTask.fetch_add(1);
+		if(Index >= m_NumTasks)
+			break;
+
+		const int Task = m_aOrder[Index];
+		const auto Start = std::chrono::steady_clock::now();
+		(*m_pFunc)(Task);
+		m_aCost[Task] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Start).count();
+
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		if(++m_NumFinished == m_NumTasks)
+			m_Done.notify_all();
+	}
+}
+
+void CWorldThreadPool::WorkerThread()
+{
+	int LastGeneration = 0;
+	while(true)
+	{
+		{
+			std::unique_lock<std::mutex> Lock(m_Lock);
+			m_WakeUp.wait(Lock, [this, LastGeneration]() { return m_Shutdown || (m_Generation != LastGeneration && m_pFunc); });
+			if(m_Shutdown)
+				return;
+
+			LastGeneration = m_Generation;
+			m_NumActive++;
+		}
+
+		Process();
+
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		if(--m_NumActive == 0)
+			m_Done.notify_all();
+	}
+}
@@ -0,0 +1,49 @@
+#ifndef ENGINE_SERVER_WORLD_THREAD_POOL_H
+#define ENGINE_SERVER_WORLD_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+	Runs one stage (tick or snapshot) of every world concurrently.
+	The worlds of a stage are handed out through a shared counter, a thread
+	that finished its world takes the next free one, so a slow world does
+	not hold up the others. The worlds measured as slowest in the previous
+	stage are handed out first. Run() returns only after every world of the
+	stage is done, this is the barrier after which cross-world operations
+	are executed.
+*/
+class CWorldThreadPool
+{
+	std::vector<std::thread> m_aThreads;
+	std::mutex m_Lock;
+	std::condition_variable m_WakeUp;
+	std::condition_variable m_Done;
+	bool m_Shutdown;
+	int m_Generation;
+
+	// current stage
+	const std::function<void(int)>* m_pFunc;
+	std::vector<int> m_aOrder;
+	std::vector<int64_t> m_aCost;
+	std::atomic<int> m_NextTask;
+	int m_NumTasks;
+	int m_NumFinished;
+	int m_NumActive;
+
+	void WorkerThread();
+	void Process();
+
+public:
+	CWorldThreadPool(int NumThreads);
+	~CWorldThreadPool();
+
+	int NumThreads() const { return (int)m_aThreads.size() + 1; }
+	void Run(int NumTasks, const std::function<void(int)>& Func);
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include "datafile.h"
 
 #include <base/hash_ctxt.h>
+#include <base/math.h>
 #include <base/system.h>
 #include <engine/storage.h>
 
@@ -88,7 +89,9 @@ struct CDatafileInfo
 
 struct CDatafile
 {
-	IOHANDLE m_File;
+	const unsigned char *m_pRaw; // the whole file, mapped or read once
+	unsigned m_RawSize;
+	bool m_RawMapped;
 	SHA256_DIGEST m_Sha256;
 	unsigned m_Crc;
 	CDatafileInfo m_Info;
@@ -98,7 +101,15 @@ struct CDatafile
 	char *m_pData;
 };
 
-bool CDataFileReader::Open(class IStorageEngine *pStorage, const char *pFilename, int StorageType)
+static void FreeRaw(const unsigned char *pRaw, unsigned RawSize, bool Mapped)
+{
+	if(Mapped)
+		io_unmap(pRaw, RawSize);
+	else
+		free((void *)pRaw);
+}
+
+bool CDataFileReader::Open(class IStorageEngine *pStorage, const char *pFilename, int StorageType, bool MapFile)
 {
 	dbg_msg("datafile", "loading. filename='%s'", pFilename);
 
@@ -109,7 +120,28 @@ bool CDataFileReader::Open(class IStorageEngine *pStorage, const char *pFilename
 		return false;
 	}
 
-	// take the CRC of the file and store it
+	// everything below reads from the image of the file, it is served for download as it is.
+	// a mapped file must only be replaced atomically, the default keeps a private copy
+	unsigned RawSize = 0;
+	const unsigned char *pRaw = MapFile ? (const unsigned char *)io_map(File, &RawSize) : 0x0;
+	const bool RawMapped = pRaw != 0x0;
+	if(!RawMapped)
+	{
+		long int Length = io_length(File);
+		RawSize = Length > 0 ? (unsigned)Length : 0;
+		unsigned char *pBuffer = (unsigned char *)malloc(RawSize + 1);
+		if(io_read(File, pBuffer, RawSize) != RawSize)
+		{
+			dbg_msg("datafile", "couldn't read '%s'", pFilename);
+			free(pBuffer);
+			io_close(File);
+			return false;
+		}
+		pRaw = pBuffer;
+	}
+	io_close(File);
+
+	// take the CRC and SHA256 of the file in a single pass
 	unsigned Crc = 0;
 	SHA256_DIGEST Sha256;
 	{
@@ -120,33 +152,30 @@ bool CDataFileReader::Open(class IStorageEngine *pStorage, const char *pFilename
 
 		SHA256_CTX Sha256Ctxt;
 		sha256_init(&Sha256Ctxt);
-		unsigned char aBuffer[BUFFER_SIZE];
-
-		while(true)
+		for(unsigned Offset = 0; Offset < RawSize; Offset += BUFFER_SIZE)
 		{
-			unsigned Bytes = io_read(File, aBuffer, BUFFER_SIZE);
-			if(Bytes <= 0)
-				break;
-			Crc = crc32(Crc, aBuffer, Bytes);
-			sha256_update(&Sha256Ctxt, aBuffer, Bytes);
+			const unsigned Bytes = min(RawSize - Offset, (unsigned)BUFFER_SIZE);
+			Crc = crc32(Crc, pRaw + Offset, Bytes);
+			sha256_update(&Sha256Ctxt, pRaw + Offset, Bytes);
 		}
 		Sha256 = sha256_finish(&Sha256Ctxt);
-
-		io_seek(File, 0, IOSEEK_START);
 	}
 
 	// TODO: change this header
 	CDatafileHeader Header;
-	if(sizeof(Header) != io_read(File, &Header, sizeof(Header)))
+	if(RawSize < sizeof(Header))
 	{
 		dbg_msg("datafile", "couldn't load header");
+		FreeRaw(pRaw, RawSize, RawMapped);
 		return false;
 	}
+	mem_copy(&Header, pRaw, sizeof(Header));
 	if(Header.m_aID[0] != 'A' || Header.m_aID[1] != 'T' || Header.m_aID[2] != 'A' || Header.m_aID[3] != 'D')
 	{
 		if(Header.m_aID[0] != 'D' || Header.m_aID[1] != 'A' || Header.m_aID[2] != 'T' || Header.m_aID[3] != 'A')
 		{
 			dbg_msg("datafile", "wrong signature. %x %x %x %x", Header.m_aID[0], Header.m_aID[1], Header.m_aID[2], Header.m_aID[3]);
+			FreeRaw(pRaw, RawSize, RawMapped);
 			return false;
 		}
 	}
@@ -157,6 +186,7 @@ bool CDataFileReader::Open(class IStorageEngine *pStorage, const char *pFilename
 	if(Header.m_Version != 3 && Header.m_Version != 4)
 	{
 		dbg_msg("datafile", "wrong version. version=%x", Header.m_Version);
+		FreeRaw(pRaw, RawSize, RawMapped);
 		return false;
 	}
 
@@ -172,28 +202,29 @@ bool CDataFileReader::Open(class IStorageEngine *pStorage, const char *pFilename
 	AllocSize += sizeof(CDatafile); // add space for info structure
 	AllocSize += Header.m_NumRawData * sizeof(void *); // add space for data pointers
 
+	// read types, offsets, sizes and item data
+	unsigned ReadSize = min(Size, RawSize - (unsigned)sizeof(CDatafileHeader));
+	if(ReadSize != Size)
+	{
+		FreeRaw(pRaw, RawSize, RawMapped);
+		dbg_msg("datafile", "couldn't load the whole thing, wanted=%d got=%d", Size, ReadSize);
+		return false;
+	}
+
 	CDatafile *pTmpDataFile = (CDatafile *)malloc(AllocSize);
 	pTmpDataFile->m_Header = Header;
 	pTmpDataFile->m_DataStartOffset = sizeof(CDatafileHeader) + Size;
 	pTmpDataFile->m_ppDataPtrs = (char **)(pTmpDataFile + 1);
 	pTmpDataFile->m_pData = (char *)(pTmpDataFile + 1) + Header.m_NumRawData * sizeof(char *);
-	pTmpDataFile->m_File = File;
+	pTmpDataFile->m_pRaw = pRaw;
+	pTmpDataFile->m_RawSize = RawSize;
+	pTmpDataFile->m_RawMapped = RawMapped;
 	pTmpDataFile->m_Sha256 = Sha256;
 	pTmpDataFile->m_Crc = Crc;
 
 	// clear the data pointers
 	mem_zero(pTmpDataFile->m_ppDataPtrs, Header.m_NumRawData * sizeof(void *));
-
-	// read types, offsets, sizes and item data
-	unsigned ReadSize = io_read(File, pTmpDataFile->m_pData, Size);
-	if(ReadSize != Size)
-	{
-		io_close(pTmpDataFile->m_File);
-		free(pTmpDataFile);
-		pTmpDataFile = 0;
-		dbg_msg("datafile", "couldn't load the whole thing, wanted=%d got=%d", Size, ReadSize);
-		return false;
-	}
+	mem_copy(pTmpDataFile->m_pData, pRaw + sizeof(CDatafileHeader), Size);
 
 	Close();
 	m_pDataFile = pTmpDataFile;
@@ -206,6 +237,7 @@ bool CDataFileReader::Open(class IStorageEngine *pStorage, const char *pFilename
 	{
 		dbg_msg("datafile", "allocsize=%d", AllocSize);
 		dbg_msg("datafile", "readsize=%d", ReadSize);
+		dbg_msg("datafile", "mapped=%d", m_pDataFile->m_RawMapped);
 		dbg_msg("datafile", "swaplen=%d", Header.m_Swaplen);
 		dbg_msg("datafile", "item_size=%d", m_pDataFile->m_Header.m_ItemSize);
 	}
@@ -277,6 +309,13 @@ void *CDataFileReader::GetDataImpl(int Index, int Swap)
 	{
 		// fetch the data size
 		int DataSize = GetFileDataSize(Index);
+		const unsigned Offset = m_pDataFile->m_DataStartOffset + m_pDataFile->m_Info.m_pDataOffsets[Index];
+		if(DataSize < 0 || Offset > m_pDataFile->m_RawSize || (unsigned)DataSize > m_pDataFile->m_RawSize - Offset)
+		{
+			dbg_msg("datafile", "data index=%d is outside of the file", Index);
+			return 0;
+		}
+		const unsigned char *pSrc = m_pDataFile->m_pRaw + Offset;
 #if defined(CONF_ARCH_ENDIAN_BIG)
 		int SwapSize = DataSize;
 #endif
@@ -284,34 +323,25 @@ void *CDataFileReader::GetDataImpl(int Index, int Swap)
 		if(m_pDataFile->m_Header.m_Version == 4)
 		{
 			// v4 has compressed data
-			void *pTemp = malloc(DataSize);
 			unsigned long UncompressedSize = m_pDataFile->m_Info.m_pDataSizes[Index];
 			unsigned long s;
 
 			dbg_msg("datafile", "loading data index=%d size=%d uncompressed=%lu", Index, DataSize, UncompressedSize);
 			m_pDataFile->m_ppDataPtrs[Index] = (char *)malloc(UncompressedSize);
 
-			// read the compressed data
-			io_seek(m_pDataFile->m_File, m_pDataFile->m_DataStartOffset + m_pDataFile->m_Info.m_pDataOffsets[Index], IOSEEK_START);
-			io_read(m_pDataFile->m_File, pTemp, DataSize);
-
-			// decompress the data, TODO: check for errors
+			// decompress the data straight from the file image, TODO: check for errors
 			s = UncompressedSize;
-			uncompress((Bytef *)m_pDataFile->m_ppDataPtrs[Index], &s, (Bytef *)pTemp, DataSize);
+			uncompress((Bytef *)m_pDataFile->m_ppDataPtrs[Index], &s, (const Bytef *)pSrc, DataSize);
 #if defined(CONF_ARCH_ENDIAN_BIG)
 			SwapSize = s;
 #endif
-
-			// clean up the temporary buffers
-			free(pTemp);
 		}
 		else
 		{
 			// load the data
 			dbg_msg("datafile", "loading data index=%d size=%d", Index, DataSize);
 			m_pDataFile->m_ppDataPtrs[Index] = (char *)malloc(DataSize);
-			io_seek(m_pDataFile->m_File, m_pDataFile->m_DataStartOffset + m_pDataFile->m_Info.m_pDataOffsets[Index], IOSEEK_START);
-			io_read(m_pDataFile->m_File, m_pDataFile->m_ppDataPtrs[Index], DataSize);
+			mem_copy(m_pDataFile->m_ppDataPtrs[Index], pSrc, DataSize);
 		}
 
 #if defined(CONF_ARCH_ENDIAN_BIG)
@@ -484,7 +514,7 @@ bool CDataFileReader::Close()
 	for(i = 0; i < m_pDataFile->m_Header.m_NumRawData; i++)
 		free(m_pDataFile->m_ppDataPtrs[i]);
 
-	io_close(m_pDataFile->m_File);
+	FreeRaw(m_pDataFile->m_pRaw, m_pDataFile->m_RawSize, m_pDataFile->m_RawMapped);
 	free(m_pDataFile);
 	m_pDataFile = 0;
 	return true;
@@ -518,11 +548,18 @@ int CDataFileReader::MapSize() const
 	return m_pDataFile->m_Header.m_Size + 16;
 }
 
-IOHANDLE CDataFileReader::File()
+const unsigned char *CDataFileReader::RawData() const
+{
+	if(!m_pDataFile)
+		return 0;
+	return m_pDataFile->m_pRaw;
+}
+
+unsigned CDataFileReader::RawSize() const
 {
 	if(!m_pDataFile)
 		return 0;
-	return m_pDataFile->m_File;
+	return m_pDataFile->m_RawSize;
 }
 
 CDataFileWriter::CDataFileWriter()
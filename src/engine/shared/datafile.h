@@ -32,7 +32,7 @@ public:
 
 	bool IsOpen() const { return m_pDataFile != nullptr; }
 
-	bool Open(class IStorageEngine *pStorage, const char *pFilename, int StorageType);
+	bool Open(class IStorageEngine *pStorage, const char *pFilename, int StorageType, bool MapFile = false);
 	bool Close();
 
 	void *GetData(int Index);
@@ -51,7 +51,10 @@ public:
 	SHA256_DIGEST Sha256() const;
 	unsigned Crc() const;
 	int MapSize() const;
-	IOHANDLE File();
+
+	// the unmodified file, mapped into memory when the platform allows it
+	const unsigned char *RawData() const;
+	unsigned RawSize() const;
 };
 
 // write access
@@ -7,17 +7,8 @@
 
 class CMap : public IEngineMap
 {
-	int m_CurrentMapSize;
-	unsigned char* m_pCurrentMapData;
-
 	CDataFileReader m_DataFile;
 public:
-	CMap() : m_CurrentMapSize(0), m_pCurrentMapData(0x0) {}
-	~CMap()
-	{
-		mem_free(m_pCurrentMapData);
-		m_pCurrentMapData = 0x0;
-	}
 
 	virtual void *GetData(int Index) { return m_DataFile.GetData(Index); }
 	virtual void *GetDataSwapped(int Index) { return m_DataFile.GetDataSwapped(Index); }
@@ -27,27 +18,20 @@ public:
 	virtual void *FindItem(int Type, int ID) { return m_DataFile.FindItem(Type, ID); }
 	virtual int NumItems() { return m_DataFile.NumItems(); }
 
-	virtual void SetCurrentMapSize(int Size) { m_CurrentMapSize = Size; }
-	virtual int GetCurrentMapSize() { return m_CurrentMapSize; }
-
-	virtual void SetCurrentMapData(unsigned char* CurrentMapData) { m_pCurrentMapData = CurrentMapData; }
-	virtual unsigned char* GetCurrentMapData() { return m_pCurrentMapData; }
+	virtual int GetCurrentMapSize() { return (int)m_DataFile.RawSize(); }
+	virtual const unsigned char* GetCurrentMapData() { return m_DataFile.RawData(); }
 
 	virtual void Unload()
 	{
 		m_DataFile.Close();
-
-		m_CurrentMapSize = 0;
-		mem_free(m_pCurrentMapData);
-		m_pCurrentMapData = 0x0;
 	}
 
-	virtual bool Load(const char *pMapName)
+	virtual bool Load(const char *pMapName, bool MapFile)
 	{
 		IStorageEngine* pStorage = Kernel()->RequestInterface<IStorageEngine>();
 		if (!pStorage)
 			return false;
-		return m_DataFile.Open(pStorage, pMapName, IStorageEngine::TYPE_ALL);
+		return m_DataFile.Open(pStorage, pMapName, IStorageEngine::TYPE_ALL, MapFile);
 	}
 
 	virtual bool IsLoaded()
@@ -456,116 +456,145 @@ int CSnapshotDelta::UnpackDelta(CSnapshot *pFrom, CSnapshot *pTo, const void *pS
 
 // CSnapshotStorage
 
+CSnapshotStorage::CSnapshotStorage()
+{
+	m_pData = 0;
+	m_DataCapacity = 0;
+	Init();
+}
+
+CSnapshotStorage::~CSnapshotStorage()
+{
+	free(m_pData);
+}
+
 void CSnapshotStorage::Init()
 {
-	m_pFirst = 0;
-	m_pLast = 0;
+	// the memory is kept for the next snapshots
+	for(int &TickHolder : m_aTickHolders)
+		TickHolder = -1;
+	m_First = 0;
+	m_NumHolders = 0;
+	m_DataRetained = 0;
 }
 
 void CSnapshotStorage::PurgeAll()
 {
-	CHolder *pHolder = m_pFirst;
+	Init();
+}
 
-	while(pHolder)
-	{
-		CHolder *pNext = pHolder->m_pNext;
-		free(pHolder);
-		pHolder = pNext;
-	}
+void CSnapshotStorage::PurgeFirst()
+{
+	const CHolder &First = m_aHolders[m_First];
+	int &TickHolder = m_aTickHolders[First.m_Tick & (MAX_HOLDERS - 1)];
+	if(TickHolder == m_First)
+		TickHolder = -1;
 
-	// no more snapshots in storage
-	m_pFirst = 0;
-	m_pLast = 0;
+	m_DataRetained -= First.m_SnapSize + First.m_AltSnapSize;
+	m_First = (m_First + 1) & (MAX_HOLDERS - 1);
+	m_NumHolders--;
 }
 
 void CSnapshotStorage::PurgeUntil(int Tick)
 {
-	CHolder *pHolder = m_pFirst;
-
-	while(pHolder)
-	{
-		CHolder *pNext = pHolder->m_pNext;
-		if(pHolder->m_Tick >= Tick)
-			return; // no more to remove
-		free(pHolder);
+	while(m_NumHolders > 0 && Holder(0).m_Tick < Tick)
+		PurgeFirst();
+}
 
-		// did we come to the end of the list?
-		if(!pNext)
-			break;
+int CSnapshotStorage::Grow(int Size)
+{
+	int Retained = 0;
+	for(int i = 0; i < m_NumHolders; i++)
+		Retained += AlignedSize(Holder(i).m_SnapSize + Holder(i).m_AltSnapSize);
 
-		m_pFirst = pNext;
-		pNext->m_pPrev = 0x0;
+	int Capacity = m_DataCapacity > 0 ? m_DataCapacity * 2 : MIN_DATA_CAPACITY;
+	while(Capacity < Retained + Size)
+		Capacity *= 2;
 
-		pHolder = pNext;
+	// move the retained snapshots to the start of the new memory
+	char *pData = (char *)malloc(Capacity);
+	int Offset = 0;
+	for(int i = 0; i < m_NumHolders; i++)
+	{
+		CHolder &Entry = Holder(i);
+		const int EntrySize = Entry.m_SnapSize + Entry.m_AltSnapSize;
+		mem_copy(pData + Offset, m_pData + Entry.m_Offset, EntrySize);
+		Entry.m_Offset = Offset;
+		Offset += AlignedSize(EntrySize);
 	}
 
-	// no more snapshots in storage
-	m_pFirst = 0;
-	m_pLast = 0;
+	free(m_pData);
+	m_pData = pData;
+	m_DataCapacity = Capacity;
+	return Offset;
 }
 
-void CSnapshotStorage::Add(int Tick, int64_t Tagtime, int DataSize, void *pData, int AltDataSize, void *pAltData)
+int CSnapshotStorage::Allocate(int Size)
 {
-	// allocate memory for holder + snapshot_data
-	int TotalSize = sizeof(CHolder) + DataSize;
+	Size = AlignedSize(Size);
+	if(m_NumHolders == 0)
+		return Size <= m_DataCapacity ? 0 : Grow(Size);
 
-	if(AltDataSize > 0)
+	// the free memory is behind the last snapshot and in front of the first one
+	const CHolder &First = Holder(0);
+	const CHolder &Last = Holder(m_NumHolders - 1);
+	const int End = Last.m_Offset + AlignedSize(Last.m_SnapSize + Last.m_AltSnapSize);
+	if(Last.m_Offset >= First.m_Offset)
 	{
-		TotalSize += AltDataSize;
+		if(End + Size <= m_DataCapacity)
+			return End;
+		if(Size <= First.m_Offset)
+			return 0;
 	}
+	else if(End + Size <= First.m_Offset)
+		return End;
 
-	CHolder *pHolder = (CHolder *)malloc(TotalSize);
+	return Grow(Size);
+}
 
-	// set data
-	pHolder->m_Tick = Tick;
-	pHolder->m_Tagtime = Tagtime;
-	pHolder->m_SnapSize = DataSize;
-	pHolder->m_pSnap = (CSnapshot *)(pHolder + 1);
-	mem_copy(pHolder->m_pSnap, pData, DataSize);
+void CSnapshotStorage::Add(int Tick, int64_t Tagtime, int DataSize, void *pData, int AltDataSize, void *pAltData)
+{
+	if(AltDataSize < 0)
+		AltDataSize = 0;
 
-	if(AltDataSize > 0) // create alternative if wanted
-	{
-		pHolder->m_pAltSnap = (CSnapshot *)(((char *)pHolder->m_pSnap) + DataSize);
-		mem_copy(pHolder->m_pAltSnap, pAltData, AltDataSize);
-		pHolder->m_AltSnapSize = AltDataSize;
-	}
-	else
-	{
-		pHolder->m_pAltSnap = 0;
-		pHolder->m_AltSnapSize = 0;
-	}
+	// ticks only go forward, make room for the new tick in the lookup
+	if(m_NumHolders > 0 && Tick <= Holder(m_NumHolders - 1).m_Tick)
+		PurgeAll();
+	while(m_NumHolders > 0 && (m_NumHolders == MAX_HOLDERS || Tick - Holder(0).m_Tick >= MAX_HOLDERS))
+		PurgeFirst();
+
+	const int Offset = Allocate(DataSize + AltDataSize);
+	mem_copy(m_pData + Offset, pData, DataSize);
+	if(AltDataSize > 0)
+		mem_copy(m_pData + Offset + DataSize, pAltData, AltDataSize);
+
+	const int Index = (m_First + m_NumHolders) & (MAX_HOLDERS - 1);
+	CHolder &Entry = m_aHolders[Index];
+	Entry.m_Tagtime = Tagtime;
+	Entry.m_Tick = Tick;
+	Entry.m_Offset = Offset;
+	Entry.m_SnapSize = DataSize;
+	Entry.m_AltSnapSize = AltDataSize;
 
-	// link
-	pHolder->m_pNext = 0;
-	pHolder->m_pPrev = m_pLast;
-	if(m_pLast)
-		m_pLast->m_pNext = pHolder;
-	else
-		m_pFirst = pHolder;
-	m_pLast = pHolder;
+	m_aTickHolders[Tick & (MAX_HOLDERS - 1)] = Index;
+	m_NumHolders++;
+	m_DataRetained += DataSize + AltDataSize;
 }
 
 int CSnapshotStorage::Get(int Tick, int64_t *pTagtime, CSnapshot **ppData, CSnapshot **ppAltData)
 {
-	CHolder *pHolder = m_pFirst;
-
-	while(pHolder)
-	{
-		if(pHolder->m_Tick == Tick)
-		{
-			if(pTagtime)
-				*pTagtime = pHolder->m_Tagtime;
-			if(ppData)
-				*ppData = pHolder->m_pSnap;
-			if(ppAltData)
-				*ppAltData = pHolder->m_pAltSnap;
-			return pHolder->m_SnapSize;
-		}
-
-		pHolder = pHolder->m_pNext;
-	}
+	const int Index = m_aTickHolders[Tick & (MAX_HOLDERS - 1)];
+	if(Index < 0 || m_aHolders[Index].m_Tick != Tick)
+		return -1;
 
-	return -1;
+	const CHolder &Entry = m_aHolders[Index];
+	if(pTagtime)
+		*pTagtime = Entry.m_Tagtime;
+	if(ppData)
+		*ppData = (CSnapshot *)(m_pData + Entry.m_Offset);
+	if(ppAltData)
+		*ppAltData = Entry.m_AltSnapSize > 0 ? (CSnapshot *)(m_pData + Entry.m_Offset + Entry.m_SnapSize) : 0;
+	return Entry.m_SnapSize;
 }
 
 // CSnapshotBuilder
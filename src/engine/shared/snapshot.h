@@ -100,35 +100,63 @@ public:
 
 // CSnapshotStorage
 
+/*
+	Keeps the snapshots sent to one client until they are acked or too old.
+	The snapshots are written one after another into a ring of memory that
+	only grows when the retained snapshots do not fit anymore, so after the
+	first seconds no memory is allocated. A snapshot is found by its tick
+	without searching, the pointers returned by Get stay valid until the
+	next Add.
+*/
 class CSnapshotStorage
 {
-public:
-	class CHolder
+	enum
 	{
-	public:
-		CHolder *m_pPrev;
-		CHolder *m_pNext;
+		MAX_HOLDERS = 256, // a power of two, more ticks than the server keeps
+		MIN_DATA_CAPACITY = 128 * 1024,
+	};
 
+	struct CHolder
+	{
 		int64_t m_Tagtime;
 		int m_Tick;
-
+		int m_Offset;
 		int m_SnapSize;
 		int m_AltSnapSize;
-
-		CSnapshot *m_pSnap;
-		CSnapshot *m_pAltSnap;
 	};
 
-	CHolder *m_pFirst;
-	CHolder *m_pLast;
+	// the holders in the order they were added and the holder of every tick
+	CHolder m_aHolders[MAX_HOLDERS];
+	int m_aTickHolders[MAX_HOLDERS];
+	int m_First;
+	int m_NumHolders;
+
+	char *m_pData;
+	int m_DataCapacity;
+	int m_DataRetained;
+
+	static int AlignedSize(int Size) { return (Size + 7) & ~7; }
+	CHolder &Holder(int Index) { return m_aHolders[(m_First + Index) & (MAX_HOLDERS - 1)]; }
+	int Allocate(int Size);
+	int Grow(int Size);
+	void PurgeFirst();
+
+public:
+	CSnapshotStorage();
+	~CSnapshotStorage();
+
+	CSnapshotStorage(const CSnapshotStorage &) = delete;
+	CSnapshotStorage &operator=(const CSnapshotStorage &) = delete;
 
-	CSnapshotStorage() { Init(); }
-	~CSnapshotStorage() { PurgeAll(); }
 	void Init();
 	void PurgeAll();
 	void PurgeUntil(int Tick);
 	void Add(int Tick, int64_t Tagtime, int DataSize, void *pData, int AltDataSize, void *pAltData);
 	int Get(int Tick, int64_t *pTagtime, CSnapshot **ppData, CSnapshot **ppAltData);
+
+	int NumSnapshots() const { return m_NumHolders; }
+	int RetainedBytes() const { return m_DataRetained; }
+	int CapacityBytes() const { return m_DataCapacity; }
 };
 
 class CSnapshotBuilder
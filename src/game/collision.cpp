@@ -39,9 +39,14 @@ CCollision::CCollision()
 void CCollision::Init(class CLayers *pLayers)
 {
 	m_pLayers = pLayers;
-	m_Width = m_pLayers->GameLayer()->m_Width;
-	m_Height = m_pLayers->GameLayer()->m_Height;
-	m_pTiles = static_cast<CTile *>(m_pLayers->Map()->GetData(m_pLayers->GameLayer()->m_Data));
+	InitTiles(static_cast<CTile *>(m_pLayers->Map()->GetData(m_pLayers->GameLayer()->m_Data)), m_pLayers->GameLayer()->m_Width, m_pLayers->GameLayer()->m_Height);
+}
+
+void CCollision::InitTiles(CTile *pTiles, int Width, int Height)
+{
+	m_Width = Width;
+	m_Height = Height;
+	m_pTiles = pTiles;
 
 	for(int i = 0; i < m_Width*m_Height; i++)
 	{
@@ -81,6 +86,22 @@ void CCollision::Init(class CLayers *pLayers)
 			m_pTiles[i].m_Reserved = static_cast< char >(Index);
 		}
 	}
+
+	// pack the tiles for the line checks
+	const int NumTiles = m_Width * m_Height;
+	m_aFlags.assign(NumTiles, 0);
+	m_aSolidBits.assign((NumTiles + 63) / 64, 0);
+	m_aBlockBits.assign((NumTiles + 63) / 64, 0);
+	for(int i = 0; i < NumTiles; i++)
+	{
+		const int Flags = m_pTiles[i].m_Index > 128 ? 0 : m_pTiles[i].m_Index;
+		m_aFlags[i] = static_cast<uint8_t>(Flags);
+		if(Flags & COLFLAG_SOLID)
+			m_aSolidBits[i >> 6] |= (uint64_t)1 << (i & 63);
+		if(Flags & (COLFLAG_SOLID | COLFLAG_DISALLOW_MOVE))
+			m_aBlockBits[i >> 6] |= (uint64_t)1 << (i & 63);
+	}
+	m_aLineMemo.clear();
 }
 
 int CCollision::GetTile(int x, int y) const
@@ -114,8 +135,14 @@ unsigned short CCollision::GetParseTile(int x, int y) const
 	return static_cast<int>(m_pTiles[Ny * m_Width + Nx].m_Reserved);
 }
 
-int CCollision::IntersectLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision) const
+bool CCollision::TraverseLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision, int ColFlag, int *pHitTile) const
 {
+	const std::vector<uint64_t> *pBits = nullptr;
+	if(ColFlag == COLFLAG_SOLID)
+		pBits = &m_aSolidBits;
+	else if(ColFlag == (COLFLAG_SOLID | COLFLAG_DISALLOW_MOVE))
+		pBits = &m_aBlockBits;
+
 	const int Tile0X = round_to_int(Pos0.x)/32;
 	const int Tile0Y = round_to_int(Pos0.y)/32;
 	const int Tile1X = round_to_int(Pos1.x)/32;
@@ -148,7 +175,7 @@ int CCollision::IntersectLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *p
 
 	while(CurTileX != Tile1X || CurTileY != Tile1Y)
 	{
-		if(IsTile(CurTileX*32,CurTileY*32, COLFLAG_SOLID))
+		if(TestTile(CurTileX, CurTileY, pBits, ColFlag))
 			break;
 		if(CurTileY != Tile1Y && (CurTileX == Tile1X || Error > 0))
 		{
@@ -163,7 +190,7 @@ int CCollision::IntersectLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *p
 			Vertical = true;
 		}
 	}
-	if(IsTile(CurTileX*32,CurTileY*32, COLFLAG_SOLID))
+	if(TestTile(CurTileX, CurTileY, pBits, ColFlag))
 	{
 		if(CurTileX != Tile0X || CurTileY != Tile0Y)
 		{
@@ -189,96 +216,40 @@ int CCollision::IntersectLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *p
 				Dir *= 0.5f / absolute(Dir.y) + 1.f;
 			*pOutBeforeCollision = Pos - Dir;
 		}
-		return  GetTile(CurTileX*32,CurTileY*32);
+		if(pHitTile)
+			*pHitTile = GetTile(CurTileX*32, CurTileY*32);
+		return true;
 	}
 	if(pOutCollision)
 		*pOutCollision = Pos1;
 	if(pOutBeforeCollision)
 		*pOutBeforeCollision = Pos1;
-	return 0;
+	return false;
 }
 
-bool CCollision::IntersectLineColFlag(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2* pOutBeforeCollision, int ColFlag) const
+int CCollision::IntersectLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision) const
 {
-	const int Tile0X = round_to_int(Pos0.x) / 32;
-	const int Tile0Y = round_to_int(Pos0.y) / 32;
-	const int Tile1X = round_to_int(Pos1.x) / 32;
-	const int Tile1Y = round_to_int(Pos1.y) / 32;
-
-	const float Ratio = (Tile0X == Tile1X) ? 1.f : (Pos1.y - Pos0.y) / (Pos1.x - Pos0.x);
-	const float DetPos = Pos0.x * Pos1.y - Pos0.y * Pos1.x;
-
-	const int DeltaTileX = (Tile0X <= Tile1X) ? 1 : -1;
-	const int DeltaTileY = (Tile0Y <= Tile1Y) ? 1 : -1;
-
-	const float DeltaError = DeltaTileY * DeltaTileX * Ratio;
-
-	int CurTileX = Tile0X;
-	int CurTileY = Tile0Y;
-	vec2 Pos = Pos0;
-
-	bool Vertical = false;
+	int HitTile = 0;
+	TraverseLine(Pos0, Pos1, pOutCollision, pOutBeforeCollision, COLFLAG_SOLID, &HitTile);
+	return HitTile;
+}
 
-	float Error = 0;
-	if(Tile0Y != Tile1Y && Tile0X != Tile1X)
-	{
-		Error = (CurTileX * Ratio - CurTileY - DetPos / (32 * (Pos1.x - Pos0.x))) * DeltaTileY;
-		if(Tile0X < Tile1X)
-			Error += Ratio * DeltaTileY;
-		if(Tile0Y < Tile1Y)
-			Error -= DeltaTileY;
-	}
+bool CCollision::IntersectLineColFlag(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2* pOutBeforeCollision, int ColFlag) const
+{
+	return TraverseLine(Pos0, Pos1, pOutCollision, pOutBeforeCollision, ColFlag, nullptr);
+}
 
-	while(CurTileX != Tile1X || CurTileY != Tile1Y)
-	{
-		if(IsTile(CurTileX * 32, CurTileY * 32, ColFlag))
-			break;
-		if(CurTileY != Tile1Y && (CurTileX == Tile1X || Error > 0))
-		{
-			CurTileY += DeltaTileY;
-			Error -= 1;
-			Vertical = false;
-		}
-		else
-		{
-			CurTileX += DeltaTileX;
-			Error += DeltaError;
-			Vertical = true;
-		}
-	}
-	if(IsTile(CurTileX * 32, CurTileY * 32, ColFlag))
-	{
-		if(CurTileX != Tile0X || CurTileY != Tile0Y)
-		{
-			if(Vertical)
-			{
-				Pos.x = 32 * (CurTileX + ((Tile0X < Tile1X) ? 0 : 1));
-				Pos.y = (Pos.x * (Pos1.y - Pos0.y) - DetPos) / (Pos1.x - Pos0.x);
-			}
-			else
-			{
-				Pos.y = 32 * (CurTileY + ((Tile0Y < Tile1Y) ? 0 : 1));
-				Pos.x = (Pos.y * (Pos1.x - Pos0.x) + DetPos) / (Pos1.y - Pos0.y);
-			}
-		}
-		if(pOutCollision)
-			*pOutCollision = Pos;
-		if(pOutBeforeCollision)
-		{
-			vec2 Dir = normalize(Pos1 - Pos0);
-			if(Vertical)
-				Dir *= 0.5f / absolute(Dir.x) + 1.f;
-			else
-				Dir *= 0.5f / absolute(Dir.y) + 1.f;
-			*pOutBeforeCollision = Pos - Dir;
-		}
-		return true;
-	}
-	if(pOutCollision)
-		*pOutCollision = Pos1;
-	if(pOutBeforeCollision)
-		*pOutBeforeCollision = Pos1;
-	return false;
+bool CCollision::IntersectLineWithInvisibleMemo(vec2 Pos0, vec2 Pos1) const
+{
+	const int Tile0 = clamp(round_to_int(Pos0.y)/32, 0, m_Height-1) * m_Width + clamp(round_to_int(Pos0.x)/32, 0, m_Width-1);
+	const int Tile1 = clamp(round_to_int(Pos1.y)/32, 0, m_Height-1) * m_Width + clamp(round_to_int(Pos1.x)/32, 0, m_Width-1);
+	const uint64_t Key = ((uint64_t)Tile0 << 32) | (uint64_t)Tile1;
+	if(const auto Iter = m_aLineMemo.find(Key); Iter != m_aLineMemo.end())
+		return Iter->second;
+
+	const bool Intersected = IntersectLineWithInvisible(Pos0, Pos1, nullptr, nullptr);
+	m_aLineMemo[Key] = Intersected;
+	return Intersected;
 }
 
 // Cord 'X','x' or 'Y','y' | SumSymbol '+' or '-'
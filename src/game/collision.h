@@ -5,6 +5,10 @@
 
 #include <base/vmath.h>
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 enum
 {
 	CANTMOVE_LEFT = 1 << 0,
@@ -28,6 +32,23 @@ class CCollision
 	bool IsTile(int x, int y, int Flag=COLFLAG_SOLID) const;
 	int GetTile(int x, int y) const;
 
+	// packed tiles for the line checks, one bit per tile
+	std::vector<uint64_t> m_aSolidBits;
+	std::vector<uint64_t> m_aBlockBits;
+	std::vector<uint8_t> m_aFlags;
+
+	// visibility between tile pairs, valid until ClearLineMemo()
+	mutable std::unordered_map<uint64_t, bool> m_aLineMemo;
+
+	bool TestTile(int TileX, int TileY, const std::vector<uint64_t> *pBits, int ColFlag) const
+	{
+		const int Index = clamp(TileY, 0, m_Height - 1) * m_Width + clamp(TileX, 0, m_Width - 1);
+		if(pBits)
+			return ((*pBits)[Index >> 6] >> (Index & 63)) & 1;
+		return m_aFlags[Index] & ColFlag;
+	}
+	bool TraverseLine(vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision, int ColFlag, int *pHitTile) const;
+
 public:
 	enum
 	{
@@ -40,6 +61,8 @@ public:
 
 	CCollision();
 	void Init(class CLayers *pLayers);
+	// converts the game tiles in place, the tiles must outlive the collision
+	void InitTiles(class CTile *pTiles, int Width, int Height);
 	bool CheckPoint(float x, float y, int Flag=COLFLAG_SOLID) const { return IsTile(round_to_int(x), round_to_int(y), Flag); }
 	bool CheckPoint(vec2 Pos, int Flag=COLFLAG_SOLID) const { return CheckPoint(Pos.x, Pos.y, Flag); }
 	int GetCollisionAt(float x, float y) const { return GetTile(round_to_int(x), round_to_int(y)); }
@@ -65,6 +88,11 @@ public:
 		return IntersectLineColFlag(Pos0, Pos1, pOutCollision, pOutBeforeCollision, COLFLAG_DISALLOW_MOVE | COLFLAG_SOLID);
 	};
 	bool IntersectLineColFlag(vec2 Pos0, vec2 Pos1, vec2* pOutCollision, vec2* pOutBeforeCollision, int ColFlag) const;
+
+	// line of sight for the bots, the result is shared by all lines between the same two tiles
+	// until ClearLineMemo() is called. Lines between the same tiles can differ at tile corners.
+	bool IntersectLineWithInvisibleMemo(vec2 Pos0, vec2 Pos1) const;
+	void ClearLineMemo() { m_aLineMemo.clear(); }
 	void MovePoint(vec2 *pInoutPos, vec2 *pInoutVel, float Elasticity, int *pBounces) const;
 	void MoveBox(vec2 *pInoutPos, vec2 *pInoutVel, vec2 Size, float Elasticity, bool *pDeath=NULL) const;
 	bool TestBox(vec2 Pos, vec2 Size, int Flag=COLFLAG_SOLID) const;
@@ -268,8 +268,9 @@ void CCharacterCore::Tick(bool UseInput, CTuningParams* pTuningParams)
 		if (m_pWorld && pTuning->m_PlayerHooking)
 		{
 			float Distance = 0.0f;
-			for (int i = 0; i < MAX_CLIENTS; i++)
+			for (int Index = 0; Index < m_pWorld->m_NumCharacters; Index++)
 			{
+				const int i = m_pWorld->m_aCharacterIDs[Index];
 				CCharacterCore* pCharCore = m_pWorld->m_apCharacters[i];
 				if (!pCharCore || pCharCore->m_CollisionDisabled || m_WorldID != pCharCore->m_WorldID || pCharCore == this)
 					continue;
@@ -367,8 +368,9 @@ void CCharacterCore::Tick(bool UseInput, CTuningParams* pTuningParams)
 
 	if (m_pWorld)
 	{
-		for (int i = 0; i < MAX_CLIENTS; i++)
+		for (int Index = 0; Index < m_pWorld->m_NumCharacters; Index++)
 		{
+			const int i = m_pWorld->m_aCharacterIDs[Index];
 			CCharacterCore* pCharCore = m_pWorld->m_apCharacters[i];
 			if (!pCharCore || pCharCore->m_CollisionDisabled || m_WorldID != pCharCore->m_WorldID || pCharCore == this)
 				continue;
@@ -433,6 +435,31 @@ void CCharacterCore::Tick(bool UseInput, CTuningParams* pTuningParams)
 		m_Vel = normalize(m_Vel) * 6000;
 }
 
+// the samples of a move that can come within Radius of Center, with a margin so that
+// the rounding of the sample positions never drops one
+static bool SweptCircleSteps(vec2 From, vec2 To, float Distance, vec2 Center, float Radius, int NumSteps, int* pFirst, int* pLast)
+{
+	const double Reach = Radius + 1.0;
+	const double DirX = To.x - From.x, DirY = To.y - From.y;
+	const double OffsetX = From.x - Center.x, OffsetY = From.y - Center.y;
+	const double A = DirX * DirX + DirY * DirY;
+	const double B = 2.0 * (OffsetX * DirX + OffsetY * DirY);
+	const double C = OffsetX * OffsetX + OffsetY * OffsetY - Reach * Reach;
+	const double Discriminant = B * B - 4.0 * A * C;
+	if (A <= 0.0 || Discriminant < 0.0)
+		return false;
+
+	const double Root = sqrt(Discriminant);
+	const double Enter = (-B - Root) / (2.0 * A);
+	const double Leave = (-B + Root) / (2.0 * A);
+	if (Leave < 0.0 || Enter > 1.0)
+		return false;
+
+	*pFirst = max(0, (int)floor(clamp(Enter, 0.0, 1.0) * Distance) - 1);
+	*pLast = min(NumSteps - 1, (int)ceil(clamp(Leave, 0.0, 1.0) * Distance) + 1);
+	return *pFirst <= *pLast;
+}
+
 void CCharacterCore::Move(CTuningParams* pTuningParams)
 {
 	const CTuningParams* pTuning = pTuningParams ? pTuningParams : &m_pWorld->m_Tuning;
@@ -459,41 +486,59 @@ void CCharacterCore::Move(CTuningParams* pTuningParams)
 	m_Vel.x = m_Vel.x * (1.0f / RampValue);
 	
 	if(m_pWorld && (m_Super || (pTuning->m_PlayerCollision && !m_CollisionDisabled && !m_Solo)))
+		NewPos = CollidePlayers(NewPos);
+
+	m_Pos = NewPos;
+}
+
+vec2 CCharacterCore::CollidePlayers(vec2 NewPos) const
+{
+	// the move is sampled once per unit and stops at the first sample inside another player.
+	// only the samples in the swept circle of a player are tested
+	float Distance = distance(m_Pos, NewPos);
+	if (Distance <= 0)
+		return NewPos;
+
+	int End = Distance + 1;
+	int HitStep = End;
+	float HitDistance = 0.0f;
+	const CCharacterCore* pHitCore = nullptr;
+	for (int Index = 0; Index < m_pWorld->m_NumCharacters; Index++)
 	{
-		// check player collision
-		float Distance = distance(m_Pos, NewPos);
-		if (Distance > 0)
+		const CCharacterCore* pCharCore = m_pWorld->m_apCharacters[m_pWorld->m_aCharacterIDs[Index]];
+		if (!pCharCore || m_WorldID != pCharCore->m_WorldID || pCharCore == this)
+			continue;
+		if((!(pCharCore->m_Super || m_Super) && (m_Solo || pCharCore->m_Solo || pCharCore->m_CollisionDisabled)))
+			continue;
+
+		int First, Last;
+		if (!SweptCircleSteps(m_Pos, NewPos, Distance, pCharCore->m_Pos, PhysicalSize(), End, &First, &Last))
+			continue;
+
+		// players are tested in slot order, a later one only wins with an earlier sample
+		Last = min(Last, HitStep - 1);
+		for (int i = First; i <= Last; i++)
 		{
-			int End = Distance + 1;
-			vec2 LastPos = m_Pos;
-			for (int i = 0; i < End; i++)
+			float a = i / Distance;
+			vec2 Pos = mix(m_Pos, NewPos, a);
+			float D = distance(Pos, pCharCore->m_Pos);
+			if (D < PhysicalSize() && D >= 0.0f)
 			{
-				float a = i / Distance;
-				vec2 Pos = mix(m_Pos, NewPos, a);
-				for (int p = 0; p < MAX_CLIENTS; p++)
-				{
-					CCharacterCore* pCharCore = m_pWorld->m_apCharacters[p];
-					if (!pCharCore || m_WorldID != pCharCore->m_WorldID || pCharCore == this)
-						continue;
-					if((!(pCharCore->m_Super || m_Super) && (m_Solo || pCharCore->m_Solo || pCharCore->m_CollisionDisabled)))
-						continue;
-
-					float D = distance(Pos, pCharCore->m_Pos);
-					if (D < PhysicalSize() && D >= 0.0f)
-					{
-						if (a > 0.0f)
-							m_Pos = LastPos;
-						else if (distance(NewPos, pCharCore->m_Pos) > D)
-							m_Pos = NewPos;
-						return;
-					}
-				}
-				LastPos = Pos;
+				HitStep = i;
+				HitDistance = D;
+				pHitCore = pCharCore;
+				break;
 			}
 		}
 	}
 
-	m_Pos = NewPos;
+	if (!pHitCore)
+		return NewPos;
+	if (HitStep > 0)
+		return mix(m_Pos, NewPos, (HitStep - 1) / Distance);
+	if (distance(NewPos, pHitCore->m_Pos) > HitDistance)
+		return NewPos;
+	return m_Pos;
 }
 
 void CCharacterCore::Write(CNetObj_CharacterCore* pObjCore)
@@ -640,4 +685,28 @@ void CWorldCore::InitSwitchers(int HighestSwitchNumber)
 		}
 	}
 }
-*/
\ No newline at end of file
+*/
+
+void CWorldCore::SetCharacter(int ClientID, CCharacterCore* pCharCore)
+{
+	const bool Exists = m_apCharacters[ClientID] != nullptr;
+	m_apCharacters[ClientID] = pCharCore;
+	if (Exists == (pCharCore != nullptr))
+		return;
+
+	int Index = 0;
+	while (Index < m_NumCharacters && m_aCharacterIDs[Index] < ClientID)
+		Index++;
+
+	if (pCharCore)
+	{
+		mem_move(&m_aCharacterIDs[Index + 1], &m_aCharacterIDs[Index], (m_NumCharacters - Index) * sizeof(int));
+		m_aCharacterIDs[Index] = ClientID;
+		m_NumCharacters++;
+	}
+	else
+	{
+		m_NumCharacters--;
+		mem_move(&m_aCharacterIDs[Index], &m_aCharacterIDs[Index + 1], (m_NumCharacters - Index) * sizeof(int));
+	}
+}
@@ -198,9 +198,12 @@ public:
 	CWorldCore()
 	{
 		mem_zero(m_apCharacters, sizeof(m_apCharacters));
+		m_NumCharacters = 0;
 		m_pPrng = nullptr;
 	}
 
+	void SetCharacter(int ClientID, class CCharacterCore* pCharCore);
+
 	int RandomOr0(int BelowThis)
 	{
 		if (BelowThis <= 1 || !m_pPrng)
@@ -215,6 +218,9 @@ public:
 
 	CTuningParams m_Tuning;
 	class CCharacterCore* m_apCharacters[MAX_CLIENTS];
+	// the occupied slots of m_apCharacters in ascending order, set through SetCharacter
+	int m_aCharacterIDs[MAX_CLIENTS];
+	int m_NumCharacters;
 	CPrng* m_pPrng;
 };
 
@@ -287,6 +293,8 @@ public:
 	void Reset();
 	void Tick(bool UseInput, CTuningParams* pTuningParams = nullptr);
 	void Move(CTuningParams* pTuningParams = nullptr);
+	// where a move of this core from m_Pos to NewPos stops because of the other players
+	vec2 CollidePlayers(vec2 NewPos) const;
 
 	void Read(const CNetObj_CharacterCore* pObjCore);
 	void Write(CNetObj_CharacterCore* pObjCore);
@@ -17,6 +17,24 @@
 	} \
 	private:
 
+// entities live in the pools of their world, see CEntityAllocator
+#define MACRO_ALLOC_WORLD() \
+	public: \
+	void *operator new(size_t Size, class CGameWorld *pGameWorld) \
+	{ \
+		return pGameWorld->Allocator()->Allocate(Size); \
+	} \
+	void operator delete(void *pPtr, class CGameWorld *pGameWorld) \
+	{ \
+		CEntityAllocator::Free(pPtr); \
+	} \
+	void operator delete(void *pPtr) \
+	{ \
+		CEntityAllocator::Free(pPtr); \
+	} \
+	void *operator new(size_t Size) = delete; \
+	private:
+
 #define MACRO_ALLOC_POOL_ID() \
 	public: \
 	void *operator new(size_t Size, int id); \
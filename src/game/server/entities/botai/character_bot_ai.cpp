@@ -63,7 +63,7 @@ bool CCharacterBotAI::Spawn(class CPlayer *pPlayer, vec2 Pos)
 		m_Core.m_Solo = true;
 		int ClientID = m_pBotPlayer->GetCID();
 		int OwnerCID = m_pBotPlayer->GetEidolonOwner()->GetCID();
-		new CEidolon(&GS()->m_World, Pos, 0, ClientID, OwnerCID);
+		new(&GS()->m_World) CEidolon(&GS()->m_World, Pos, 0, ClientID, OwnerCID);
 	}
 	return true;
 }
@@ -77,7 +77,7 @@ void CCharacterBotAI::GiveRandomEffects(int ClientID)
 		{
 			int MobID = m_pBotPlayer->GetBotMobID();
 			if(const CMobBuffDebuff* pBuff = MobBotInfo::ms_aMobBot[MobID].GetRandomEffect())
-				pPlayer->GiveEffect(pBuff->getEffect(), pBuff->getTime(), pBuff->getChance());
+				pPlayer->GiveEffect(pBuff->getEffectID(), pBuff->getTime(), pBuff->getChance());
 		}
 	}
 }
@@ -168,7 +168,7 @@ void CCharacterBotAI::Die(int Killer, int Weapon)
 	m_pBotPlayer->m_aPlayerTick[TickState::Die] = Server()->Tick() / 2;
 	m_pBotPlayer->m_Spawned = true;
 	GS()->m_World.RemoveEntity(this);
-	GS()->m_World.m_Core.m_apCharacters[ClientID] = nullptr;
+	GS()->m_World.m_Core.SetCharacter(ClientID, nullptr);
 	GS()->CreateDeath(m_Pos, ClientID);
 }
 
@@ -324,13 +324,7 @@ void CCharacterBotAI::Snap(int SnappingClient)
 	}
 
 	// set emote
-	if(m_EmoteStop < Server()->Tick())
-	{
-		m_EmoteType = EMOTE_NORMAL;
-		m_EmoteStop = -1;
-	}
-
-	pCharacter->m_Emote = m_EmoteType;
+	pCharacter->m_Emote = m_EmoteStop < Server()->Tick() ? (int)EMOTE_NORMAL : m_EmoteType;
 	if(250 - ((Server()->Tick() - m_LastAction) % (250)) < 5)
 		pCharacter->m_Emote = EMOTE_BLINK;
 
@@ -466,7 +460,7 @@ void CCharacterBotAI::HandleTuning()
 	{
 		// effect slower
 		const int MobID = m_pBotPlayer->GetBotMobID();
-		if(MobBotInfo::ms_aMobBot[MobID].IsEnabledBehavior("Slower"))
+		if(MobBotInfo::ms_aMobBot[MobID].IsEnabledBehavior(MOBBEHAVIOR_SLOWER))
 		{
 			pTuningParams->m_Gravity = 0.25f;
 			pTuningParams->m_GroundJumpImpulse = 8.0f;
@@ -496,7 +490,7 @@ void CCharacterBotAI::BehaviorTick()
 	const int MobID = m_pBotPlayer->GetBotMobID();
 
 	// sleepy behavior
-	if(m_Target.IsEmpty() && MobBotInfo::ms_aMobBot[MobID].IsEnabledBehavior("Sleepy"))
+	if(m_Target.IsEmpty() && MobBotInfo::ms_aMobBot[MobID].IsEnabledBehavior(MOBBEHAVIOR_SLEEPY))
 	{
 		if(Server()->Tick() % (Server()->TickSpeed() / 2) == 0)
 		{
@@ -621,15 +615,11 @@ void CCharacterBotAI::EngineEidolons()
 
 void CCharacterBotAI::Move()
 {
-	bool Status = false;
-	if(!m_pBotPlayer->m_ThreadReadNow.compare_exchange_strong(Status, true, std::memory_order::memory_order_acquire, std::memory_order::memory_order_relaxed))
-		return;
-
 	SetAim(m_pBotPlayer->m_TargetPos - m_Pos);
 
 	int Index = -1;
 	int ActiveWayPoints = 0;
-	for(int i = 0; i < m_pBotPlayer->m_PathSize && i < 30 && !GS()->Collision()->IntersectLineWithInvisible(m_pBotPlayer->GetWayPoint(i), m_Pos, nullptr, nullptr); i++)
+	for(int i = 0; i < m_pBotPlayer->GetPathSize() && i < 30 && !GS()->Collision()->IntersectLineWithInvisible(m_pBotPlayer->GetWayPoint(i), m_Pos, nullptr, nullptr); i++)
 	{
 		Index = i;
 		ActiveWayPoints = i;
@@ -755,8 +745,6 @@ void CCharacterBotAI::Move()
 		m_Input.m_Jump = 1;
 		m_MoveTick = Server()->Tick();
 	}
-
-	m_pBotPlayer->m_ThreadReadNow.store(false, std::memory_order::memory_order_release);
 }
 
 
@@ -798,12 +786,14 @@ void CCharacterBotAI::SetAim(vec2 Dir)
 // searching for a player among people
 CPlayer* CCharacterBotAI::SearchPlayer(float Distance) const
 {
+	const std::bitset<MAX_CLIENTS> Nearby = GameWorld()->FindCharactersNearby(m_Core.m_Pos, Distance);
 	for(int i = 0 ; i < MAX_PLAYERS; i ++)
 	{
-		if(!GS()->m_apPlayers[i]
+		if(!Nearby[i]
+			|| !GS()->m_apPlayers[i]
 			|| !GS()->m_apPlayers[i]->GetCharacter()
 			|| distance(m_Core.m_Pos, GS()->m_apPlayers[i]->GetCharacter()->m_Core.m_Pos) > Distance
-			|| GS()->Collision()->IntersectLineWithInvisible(GS()->m_apPlayers[i]->GetCharacter()->m_Core.m_Pos, m_Pos, nullptr, nullptr)
+			|| GS()->Collision()->IntersectLineWithInvisibleMemo(GS()->m_apPlayers[i]->GetCharacter()->m_Core.m_Pos, m_Pos)
 			|| !GS()->IsPlayerEqualWorld(i))
 			continue;
 		return GS()->m_apPlayers[i];
@@ -835,18 +825,22 @@ CPlayer *CCharacterBotAI::SearchTankPlayer(float Distance)
 		return nullptr;
 
 	// throw off the lifetime of a target
-	m_Target.UpdateCollised(GS()->Collision()->IntersectLineWithInvisible(pPlayer->GetCharacter()->GetPos(), m_Pos, nullptr, nullptr));
+	m_Target.UpdateCollised(GS()->Collision()->IntersectLineWithInvisibleMemo(pPlayer->GetCharacter()->GetPos(), m_Pos));
 
 	// looking for a stronger
+	const std::bitset<MAX_CLIENTS> Nearby = GameWorld()->FindCharactersNearby(m_Core.m_Pos, 800.0f);
 	for (int i = 0; i < MAX_PLAYERS; i++)
 	{
+		if(!Nearby[i])
+			continue;
+
 		// check the distance of the player
 		CPlayer* pFinderHard = GS()->GetPlayer(i, true, true);
 		if (m_Target.GetCID() == i || !pFinderHard || distance(pFinderHard->GetCharacter()->m_Core.m_Pos, m_Core.m_Pos) > 800.0f)
 			continue;
 
 		// check if the player is tastier for the bot
-		const bool FinderCollised = GS()->Collision()->IntersectLineWithInvisible(pFinderHard->GetCharacter()->m_Core.m_Pos, m_Core.m_Pos, nullptr, nullptr);
+		const bool FinderCollised = GS()->Collision()->IntersectLineWithInvisibleMemo(pFinderHard->GetCharacter()->m_Core.m_Pos, m_Core.m_Pos);
 		if (!FinderCollised && pFinderHard->GetAttributeSize(AttributeIdentifier::HP) > pPlayer->GetAttributeSize(AttributeIdentifier::HP))
 			m_Target.Set(i, 100);
 	}
@@ -860,8 +854,12 @@ CPlayerBot* CCharacterBotAI::SearchMob(float Distance) const
 	CPlayerBot* pBotPlayer = nullptr;
 
 	// looking for a stronger
+	const std::bitset<MAX_CLIENTS> Nearby = GameWorld()->FindCharactersNearby(m_Core.m_Pos, Distance);
 	for(int i = MAX_PLAYERS; i < MAX_CLIENTS; i++)
 	{
+		if(!Nearby[i])
+			continue;
+
 		// check active player bot
 		CPlayerBot* pSearchBotPlayer = dynamic_cast<CPlayerBot*>(GS()->m_apPlayers[i]);
 		if(!pSearchBotPlayer || !pSearchBotPlayer->GetCharacter() || pSearchBotPlayer->GetBotType() != TYPE_BOT_MOB)
@@ -872,7 +870,7 @@ CPlayerBot* CCharacterBotAI::SearchMob(float Distance) const
 			continue;
 
 		// check walls and closed lines
-		if(GS()->Collision()->IntersectLineWithInvisible(pSearchBotPlayer->GetCharacter()->m_Core.m_Pos, m_Core.m_Pos, nullptr, nullptr))
+		if(GS()->Collision()->IntersectLineWithInvisibleMemo(pSearchBotPlayer->GetCharacter()->m_Core.m_Pos, m_Core.m_Pos))
 			continue;
 
 		pBotPlayer = dynamic_cast<CPlayerBot*>(GS()->m_apPlayers[i]);
@@ -885,8 +883,12 @@ CPlayerBot* CCharacterBotAI::SearchMob(float Distance) const
 bool CCharacterBotAI::SearchTalkedPlayer()
 {
 	bool PlayerFinding = false;
+	const std::bitset<MAX_CLIENTS> Nearby = GameWorld()->FindCharactersNearby(m_Core.m_Pos, 128.0f);
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
+		if(!Nearby[i])
+			continue;
+
 		// check for visible client
 		if(!m_pBotPlayer->IsVisibleForClient(i))
 			continue;
@@ -897,7 +899,7 @@ bool CCharacterBotAI::SearchTalkedPlayer()
 			continue;
 
 		// check walls and closed lines
-		if(GS()->Collision()->IntersectLineWithInvisible(pPlayer->GetCharacter()->m_Core.m_Pos, m_Core.m_Pos, nullptr, nullptr))
+		if(GS()->Collision()->IntersectLineWithInvisibleMemo(pPlayer->GetCharacter()->m_Core.m_Pos, m_Core.m_Pos))
 			continue;
 
 		pPlayer->GetCharacter()->m_SafeAreaForTick = true;
@@ -977,7 +979,7 @@ bool CCharacterBotAI::FunctionNurseNPC()
 
 		// increase health for player
 		int Health = max(pPlayer->GetStartHealth() / 20, 1);
-		new CHearth(&GS()->m_World, m_Pos, pPlayer, Health, pPlayer->GetCharacter()->m_Core.m_Vel);
+		new(&GS()->m_World) CHearth(&GS()->m_World, m_Pos, pPlayer, Health, pPlayer->GetCharacter()->m_Core.m_Vel);
 		m_Input.m_Direction = 0;
 
 		// information
@@ -35,7 +35,7 @@ CCharacter::~CCharacter()
 {
 	delete m_pHelper;
 	m_pHelper = nullptr;
-	GS()->m_World.m_Core.m_apCharacters[m_pPlayer->GetCID()] = nullptr;
+	GS()->m_World.m_Core.SetCharacter(m_pPlayer->GetCID(), nullptr);
 }
 
 int CCharacter::GetSnapFullID() const
@@ -58,7 +58,7 @@ bool CCharacter::Spawn(CPlayer *pPlayer, vec2 Pos)
 	m_Core.Init(&GS()->m_World.m_Core, GS()->Collision());
 	m_Core.m_ActiveWeapon = WEAPON_HAMMER;
 	m_Core.m_Pos = m_Pos;
-	GS()->m_World.m_Core.m_apCharacters[m_pPlayer->GetCID()] = &m_Core;
+	GS()->m_World.m_Core.SetCharacter(m_pPlayer->GetCID(), &m_Core);
 
 	m_ReckoningTick = 0;
 	mem_zero(&m_SendCore, sizeof(m_SendCore));
@@ -333,7 +333,7 @@ void CCharacter::FireWeapon()
 		case WEAPON_GUN:
 		{
 			const bool IsExplosive = m_pPlayer->GetItem(itExplosiveGun)->IsEquipped();
-			new CProjectile(GameWorld(), WEAPON_GUN, m_pPlayer->GetCID(), ProjStartPos, Direction, (int)(Server()->TickSpeed()*GS()->Tuning()->m_GunLifetime),
+			new(GameWorld()) CProjectile(GameWorld(), WEAPON_GUN, m_pPlayer->GetCID(), ProjStartPos, Direction, (int)(Server()->TickSpeed()*GS()->Tuning()->m_GunLifetime),
 				g_pData->m_Weapons.m_Gun.m_pBase->m_Damage, IsExplosive, 0, -1, WEAPON_GUN);
 
 			GS()->CreateSound(m_Pos, SOUND_GUN_FIRE);
@@ -350,7 +350,7 @@ void CCharacter::FireWeapon()
 				const float Spreading = ((0.0058945f*(9.0f*ShotSpread)/2)) - (0.0058945f*(9.0f*i));
 				const float a = angle(Direction) + Spreading;
 				const float Speed = (float)GS()->Tuning()->m_ShotgunSpeeddiff + frandom()*0.2f;
-				new CProjectile(GameWorld(), WEAPON_SHOTGUN, m_pPlayer->GetCID(), ProjStartPos,
+				new(GameWorld()) CProjectile(GameWorld(), WEAPON_SHOTGUN, m_pPlayer->GetCID(), ProjStartPos,
 					vec2(cosf(a), sinf(a))*Speed,
 					(int)(Server()->TickSpeed() * GS()->Tuning()->m_ShotgunLifetime),
 					g_pData->m_Weapons.m_Shotgun.m_pBase->m_Damage, IsExplosive, 0, 15, WEAPON_SHOTGUN);
@@ -368,7 +368,7 @@ void CCharacter::FireWeapon()
 			{
 				const float Spreading = ((0.0058945f*(9.0f*ShotSpread)/2)) - (0.0058945f*(9.0f*i));
 				const float a = angle(Direction) + Spreading;
-				new CProjectile(GameWorld(), WEAPON_GRENADE, m_pPlayer->GetCID(), ProjStartPos,
+				new(GameWorld()) CProjectile(GameWorld(), WEAPON_GRENADE, m_pPlayer->GetCID(), ProjStartPos,
 					vec2(cosf(a), sinf(a)),
 					(int)(Server()->TickSpeed()*GS()->Tuning()->m_GrenadeLifetime),
 					g_pData->m_Weapons.m_Grenade.m_pBase->m_Damage, true, 0, SOUND_GRENADE_EXPLODE, WEAPON_GRENADE);
@@ -384,7 +384,7 @@ void CCharacter::FireWeapon()
 			{
 				const float Spreading = ((0.0058945f*(9.0f*ShotSpread)/2)) - (0.0058945f*(9.0f*i));
 				const float a = angle(Direction) + Spreading;
-				new CLaser(GameWorld(), m_Pos, vec2(cosf(a), sinf(a)), GS()->Tuning()->m_LaserReach, m_pPlayer->GetCID());
+				new(GameWorld()) CLaser(GameWorld(), m_Pos, vec2(cosf(a), sinf(a)), GS()->Tuning()->m_LaserReach, m_pPlayer->GetCID());
 			}
 			GS()->CreateSound(m_Pos, SOUND_LASER_FIRE);
 		} break;
@@ -741,7 +741,7 @@ void CCharacter::Die(int Killer, int Weapon)
 	m_pPlayer->m_aPlayerTick[TickState::Die] = Server()->Tick() / 2;
 	m_pPlayer->m_Spawned = true;
 	GS()->m_World.RemoveEntity(this);
-	GS()->m_World.m_Core.m_apCharacters[ClientID] = nullptr;
+	GS()->m_World.m_Core.SetCharacter(ClientID, nullptr);
 	GS()->CreateDeath(m_Pos, ClientID);
 }
 
@@ -854,7 +854,7 @@ bool CCharacter::TakeDamage(vec2 Force, int Dmg, int FromCID, int Weapon)
 		std::for_each(PotionTools::Heal::getList().begin(), PotionTools::Heal::getList().end(), [this](const PotionTools::Heal& p)
 		{
 			CPlayerItem* pPlayerItem = m_pPlayer->GetItem(p.getItemID());
-			if(!m_pPlayer->IsActiveEffect(p.getEffect()) && pPlayerItem->IsEquipped())
+			if(!m_pPlayer->IsActiveEffect(p.getEffectID()) && pPlayerItem->IsEquipped())
 				pPlayerItem->Use(1);
 		});
 	}
@@ -886,13 +886,7 @@ void CCharacter::Snap(int SnappingClient)
 	}
 
 	// set emote
-	if (m_EmoteStop < Server()->Tick())
-	{
-		m_EmoteType = EMOTE_NORMAL;
-		m_EmoteStop = -1;
-	}
-
-	pCharacter->m_Emote = m_EmoteType;
+	pCharacter->m_Emote = m_EmoteStop < Server()->Tick() ? (int)EMOTE_NORMAL : m_EmoteType;
 	if(250 - ((Server()->Tick() - m_LastAction) % (250)) < 5)
 		pCharacter->m_Emote = EMOTE_BLINK;
 
@@ -1109,7 +1103,7 @@ void CCharacter::HandleIndependentTuning()
 
 void CCharacter::HandleBuff(CTuningParams* TuningParams)
 {
-	if(m_pPlayer->IsActiveEffect("Slowdown"))
+	if(m_pPlayer->IsActiveEffect(EFFECT_SLOWDOWN))
 	{
 		TuningParams->m_Gravity = 0.35f;
 		TuningParams->m_GroundFriction = 0.45f;
@@ -1126,18 +1120,18 @@ void CCharacter::HandleBuff(CTuningParams* TuningParams)
 	// poisons
 	if(Server()->Tick() % Server()->TickSpeed() == 0)
 	{
-		if(m_pPlayer->IsActiveEffect("Fire"))
+		if(m_pPlayer->IsActiveEffect(EFFECT_FIRE))
 		{
 			const int ExplodeDamageSize = translate_to_percent_rest(m_pPlayer->GetStartHealth(), 3);
 			GS()->CreateExplosion(m_Core.m_Pos, m_pPlayer->GetCID(), WEAPON_GRENADE, 0);
 			TakeDamage(vec2(0, 0), ExplodeDamageSize, m_pPlayer->GetCID(), WEAPON_SELF);
 		}
-		if(m_pPlayer->IsActiveEffect("Poison"))
+		if(m_pPlayer->IsActiveEffect(EFFECT_POISON))
 		{
 			const int PoisonSize = translate_to_percent_rest(m_pPlayer->GetStartHealth(), 3);
 			TakeDamage(vec2(0, 0), PoisonSize, m_pPlayer->GetCID(), WEAPON_SELF);
 		}
-		if(m_pPlayer->IsActiveEffect("RegenMana"))
+		if(m_pPlayer->IsActiveEffect(EFFECT_REGEN_MANA))
 		{
 			const int RestoreMana = translate_to_percent_rest(m_pPlayer->GetStartMana(), 5);
 			IncreaseMana(RestoreMana);
@@ -1146,7 +1140,7 @@ void CCharacter::HandleBuff(CTuningParams* TuningParams)
 		// worker health potions
 		std::for_each(PotionTools::Heal::getList().begin(), PotionTools::Heal::getList().end(), [this](const PotionTools::Heal& p)
 		{
-			if(m_pPlayer->IsActiveEffect(p.getEffect()))
+			if(m_pPlayer->IsActiveEffect(p.getEffectID()))
 				IncreaseHealth(p.getRecovery());
 		});
 	}
@@ -1292,7 +1286,7 @@ bool CCharacter::CheckFailMana(int Mana)
 	}
 
 	m_Mana -= Mana;
-	if(m_Mana <= m_pPlayer->GetStartMana() / 5 && !m_pPlayer->IsActiveEffect("RegenMana") && m_pPlayer->GetItem(itPotionManaRegen)->IsEquipped())
+	if(m_Mana <= m_pPlayer->GetStartMana() / 5 && !m_pPlayer->IsActiveEffect(EFFECT_REGEN_MANA) && m_pPlayer->GetItem(itPotionManaRegen)->IsEquipped())
 		m_pPlayer->GetItem(itPotionManaRegen)->Use(1);
 
 	m_pPlayer->ShowInformationStats();
@@ -1308,6 +1302,7 @@ void CCharacter::ChangePosition(vec2 NewPos)
 	GS()->CreatePlayerSpawn(NewPos);
 	m_Core.m_Pos = NewPos;
 	m_Pos = NewPos;
+	GameWorld()->UpdateEntityCell(this);
 	ResetHook();
 }
 
@@ -1346,7 +1341,7 @@ void CCharacter::CreateSnapProj(int SnapID, int Value, int TypeID, bool Dynamic,
 		pSnapItem->AddItem(Value, TypeID, Projectile, Dynamic, SnapID);
 		return;
 	}
-	new CSnapFull(&GS()->m_World, m_Core.m_Pos, SnapID, m_pPlayer->GetCID(), Value, TypeID, Dynamic, Projectile);
+	new(&GS()->m_World) CSnapFull(&GS()->m_World, m_Core.m_Pos, SnapID, m_pPlayer->GetCID(), Value, TypeID, Dynamic, Projectile);
 }
 
 void CCharacter::RemoveSnapProj(int Value, int SnapID, bool Effect)
@@ -7,8 +7,9 @@ CEntity::CEntity(CGameWorld *pGameWorld, int ObjType, vec2 Pos, int ProximityRad
 {
 	m_pGameWorld = pGameWorld;
 
-	m_pPrevTypeEntity = nullptr;
-	m_pNextTypeEntity = nullptr;
+	m_TypeSlot = -1;
+	m_GridKey = -1;
+	m_GridSlot = -1;
 
 	m_ID = Server()->SnapNewID();
 	m_ObjType = ObjType;
@@ -12,7 +12,7 @@
 */
 class CEntity
 {
-	MACRO_ALLOC_HEAP()
+	MACRO_ALLOC_WORLD()
 
 private:
 	/* Friend classes */
@@ -21,8 +21,12 @@ private:
 	/* Identity */
 	class CGameWorld *m_pGameWorld;
 
-	CEntity *m_pPrevTypeEntity;
-	CEntity *m_pNextTypeEntity;
+	// index in the entities of its type
+	int m_TypeSlot;
+
+	// cell of the spatial hash and the slot in it
+	int64 m_GridKey;
+	int m_GridSlot;
 
 	int m_ID;
 	int m_ObjType;
@@ -62,8 +66,7 @@ public:
 	class IServer *Server() const { return m_pGameWorld->Server(); }
 
 	/* Getters */
-	CEntity *TypeNext() const { return m_pNextTypeEntity; }
-	CEntity *TypePrev() const { return m_pPrevTypeEntity; }
+	CEntity *TypeNext() const { return m_pGameWorld->NextEntity(this); }
 	const vec2 &GetPos() const			{ return m_Pos; }
 	const vec2 &GetPosTo() const			{ return m_PosTo; }
 	float GetProximityRadius() const	{ return m_ProximityRadius; }
@@ -113,6 +116,14 @@ public:
 	*/
 	virtual void Snap(int SnappingClient) {}
 
+	/*
+		Function: IsSnapShared
+			The snap is the same for every client that does not clip
+			the entity, it is then made once per snapshot tick and
+			shared by all clients.
+	*/
+	virtual bool IsSnapShared() const { return false; }
+
 	/*
 		Function: PostSnap
 			Called after all entities Snap(int SnappingClient) function has been called.
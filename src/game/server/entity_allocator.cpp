@@ -0,0 +1,109 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include "entity_allocator.h"
+
+#include <base/math.h>
+#include <engine/console.h>
+
+CEntityAllocator::~CEntityAllocator()
+{
+	for(int i = 0; i < NUM_CLASSES; i++)
+	{
+		if(m_aClasses[i].m_NumUsed > 0)
+			dbg_msg("entities", "%d entities of %d bytes outlive their world", m_aClasses[i].m_NumUsed, (i + 1) * GRANULARITY);
+		for(void *pSlab : m_aClasses[i].m_apSlabs)
+			mem_free(pSlab);
+	}
+}
+
+void CEntityAllocator::AddSlab(int Class)
+{
+	CSizeClass &SizeClass = m_aClasses[Class];
+	const int Size = BlockSize(Class);
+	const int NumBlocks = max(MIN_SLAB_SIZE / Size, 8);
+
+	char *pSlab = (char *)mem_alloc(Size * NumBlocks, alignof(CHeader));
+	SizeClass.m_apSlabs.push_back(pSlab);
+	SizeClass.m_NumBlocks += NumBlocks;
+
+	// the blocks are handed out in the order of their addresses
+	for(int i = NumBlocks - 1; i >= 0; i--)
+	{
+		CFreeBlock *pBlock = (CFreeBlock *)(pSlab + i * Size);
+		pBlock->m_pNext = SizeClass.m_pFree;
+		SizeClass.m_pFree = pBlock;
+	}
+}
+
+void *CEntityAllocator::Allocate(size_t Size)
+{
+	CHeader *pHeader;
+	const int Class = Size > 0 ? (int)((Size - 1) / GRANULARITY) : 0;
+	if(Class >= NUM_CLASSES)
+	{
+		pHeader = (CHeader *)mem_alloc(sizeof(CHeader) + Size, alignof(CHeader));
+		pHeader->m_Class = -1;
+		m_NumLarge++;
+		m_NumLargeAllocs++;
+	}
+	else
+	{
+		CSizeClass &SizeClass = m_aClasses[Class];
+		if(!SizeClass.m_pFree)
+			AddSlab(Class);
+
+		pHeader = (CHeader *)SizeClass.m_pFree;
+		SizeClass.m_pFree = SizeClass.m_pFree->m_pNext;
+		pHeader->m_Class = Class;
+		SizeClass.m_NumUsed++;
+		SizeClass.m_PeakUsed = max(SizeClass.m_PeakUsed, SizeClass.m_NumUsed);
+		SizeClass.m_NumAllocs++;
+	}
+
+	// entities expect to start zeroed
+	pHeader->m_pOwner = this;
+	void *pPtr = pHeader + 1;
+	mem_zero(pPtr, Size);
+	return pPtr;
+}
+
+void CEntityAllocator::Free(void *pPtr)
+{
+	if(!pPtr)
+		return;
+
+	CHeader *pHeader = (CHeader *)pPtr - 1;
+	CEntityAllocator *pOwner = pHeader->m_pOwner;
+	if(pHeader->m_Class < 0)
+	{
+		pOwner->m_NumLarge--;
+		mem_free(pHeader);
+		return;
+	}
+
+	CSizeClass &SizeClass = pOwner->m_aClasses[pHeader->m_Class];
+	CFreeBlock *pBlock = (CFreeBlock *)pHeader;
+	pBlock->m_pNext = SizeClass.m_pFree;
+	SizeClass.m_pFree = pBlock;
+	SizeClass.m_NumUsed--;
+}
+
+void CEntityAllocator::PrintStats(IConsole *pConsole, const char *pName) const
+{
+	char aBuf[256];
+	int64 ReservedBytes = 0;
+	for(int i = 0; i < NUM_CLASSES; i++)
+	{
+		const CSizeClass &SizeClass = m_aClasses[i];
+		if(SizeClass.m_apSlabs.empty())
+			continue;
+
+		ReservedBytes += (int64)SizeClass.m_NumBlocks * BlockSize(i);
+		str_format(aBuf, sizeof(aBuf), "%s: size=%d used=%d peak=%d blocks=%d slabs=%d allocs=%lld", pName, (i + 1) * GRANULARITY,
+			SizeClass.m_NumUsed, SizeClass.m_PeakUsed, SizeClass.m_NumBlocks, (int)SizeClass.m_apSlabs.size(), (long long)SizeClass.m_NumAllocs);
+		pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "entities", aBuf);
+	}
+
+	str_format(aBuf, sizeof(aBuf), "%s: reserved=%lld bytes, large used=%d allocs=%lld", pName, (long long)ReservedBytes, m_NumLarge, (long long)m_NumLargeAllocs);
+	pConsole->Print(IConsole::OUTPUT_LEVEL_STANDARD, "entities", aBuf);
+}
@@ -0,0 +1,73 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#ifndef GAME_SERVER_ENTITY_ALLOCATOR_H
+#define GAME_SERVER_ENTITY_ALLOCATOR_H
+
+#include <base/system.h>
+
+#include <vector>
+
+/*
+	Class: Entity Allocator
+		Memory of the entities of one world. Entities are grouped by size
+		into slabs, a destroyed entity goes back to the free list of its
+		size and is reused by the next entity of that size. Every world is
+		ticked by one thread at a time, so no lock is needed.
+*/
+class CEntityAllocator
+{
+	enum
+	{
+		GRANULARITY = 16,
+		MAX_POOLED_SIZE = 4096,
+		NUM_CLASSES = MAX_POOLED_SIZE / GRANULARITY,
+		MIN_SLAB_SIZE = 16 * 1024,
+	};
+
+	// in front of every entity, so it finds its way back
+	struct alignas(16) CHeader
+	{
+		CEntityAllocator *m_pOwner;
+		int m_Class; // -1 for entities too large to be pooled
+	};
+
+	struct CFreeBlock
+	{
+		CFreeBlock *m_pNext;
+	};
+
+	struct CSizeClass
+	{
+		CFreeBlock *m_pFree = nullptr;
+		std::vector<void *> m_apSlabs;
+		int m_NumBlocks = 0;
+		int m_NumUsed = 0;
+		int m_PeakUsed = 0;
+		int64 m_NumAllocs = 0;
+	};
+
+	CSizeClass m_aClasses[NUM_CLASSES];
+	int m_NumLarge = 0;
+	int64 m_NumLargeAllocs = 0;
+
+	static int BlockSize(int Class) { return (int)sizeof(CHeader) + (Class + 1) * GRANULARITY; }
+	void AddSlab(int Class);
+
+public:
+	CEntityAllocator() = default;
+	~CEntityAllocator();
+
+	CEntityAllocator(const CEntityAllocator &) = delete;
+	CEntityAllocator &operator=(const CEntityAllocator &) = delete;
+
+	void *Allocate(size_t Size);
+	static void Free(void *pPtr);
+
+	/*
+		Function: PrintStats
+			Prints the used and reserved blocks of every size in use.
+	*/
+	void PrintStats(class IConsole *pConsole, const char *pName) const;
+};
+
+#endif
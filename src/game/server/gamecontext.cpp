@@ -24,6 +24,7 @@
 #include "mmocore/Components/Mails/MailBoxCore.h"
 #include "mmocore/Components/Guilds/GuildCore.h"
 #include "mmocore/Components/Houses/HouseCore.h"
+#include "mmocore/Components/Inventory/InventoryCore.h"
 #include "mmocore/Components/Quests/QuestCore.h"
 #include "mmocore/Components/Skills/SkillsCore.h"
 
@@ -34,7 +35,8 @@
 #include "mmocore/Components/Worlds/WorldData.h"
 
 // static data that have the same value in different objects
-std::unordered_map < std::string, int > CGS::ms_aEffects[MAX_PLAYERS];
+CEffectSet CGS::ms_aEffects[MAX_PLAYERS];
+std::vector<std::string> CGS::ms_aSentVotes[MAX_PLAYERS];
 int CGS::m_MultiplierExp = 100;
 
 CGS::CGS()
@@ -63,7 +65,7 @@ CGS::~CGS()
 {
 	m_Events.Clear();
 	for(auto& pEffects : ms_aEffects)
-		pEffects.clear();
+		pEffects.Clear();
 	for(auto* apPlayer : m_apPlayers)
 		delete apPlayer;
 
@@ -168,7 +170,7 @@ CEidolonInfoData* CGS::GetEidolonByItemID(ItemIdentifier ItemID) const
 
 CFlyingPoint* CGS::CreateFlyingPoint(vec2 Pos, vec2 InitialVel, int ClientID, int FromID)
 {
-	CFlyingPoint* pFlying = new CFlyingPoint(&m_World, Pos, InitialVel, ClientID, FromID);
+	CFlyingPoint* pFlying = new(&m_World) CFlyingPoint(&m_World, Pos, InitialVel, ClientID, FromID);
 	return pFlying;
 }
 
@@ -365,7 +367,7 @@ void CGS::Chat(int ClientID, const char* pText, ...)
 	{
 		if (m_apPlayers[i])
 		{
-			Server()->Localization()->Format_VL(Buffer, m_apPlayers[i]->GetLanguage(), pText, VarArgs);
+			Server()->Localization()->Format_VL(Buffer, m_apPlayers[i]->GetLanguageID(), pText, VarArgs);
 
 			Msg.m_pMessage = Buffer.buffer();
 			Server()->SendPackMsg(&Msg, MSGFLAG_VITAL, i);
@@ -390,7 +392,7 @@ bool CGS::ChatAccount(int AccountID, const char* pText, ...)
 	va_start(VarArgs, pText);
 
 	dynamic_string Buffer;
-	Server()->Localization()->Format_VL(Buffer, pPlayer->GetLanguage(), pText, VarArgs);
+	Server()->Localization()->Format_VL(Buffer, pPlayer->GetLanguageID(), pText, VarArgs);
 
 	Msg.m_pMessage = Buffer.buffer();
 	Server()->SendPackMsg(&Msg, MSGFLAG_VITAL, pPlayer->GetCID());
@@ -418,7 +420,7 @@ void CGS::ChatGuild(int GuildID, const char* pText, ...)
 		if(CPlayer *pPlayer = GetPlayer(i, true); pPlayer && pPlayer->Acc().IsGuild() && pPlayer->Acc().m_GuildID == GuildID)
 		{
 			Buffer.append("[Guild]");
-			Server()->Localization()->Format_VL(Buffer, m_apPlayers[i]->GetLanguage(), pText, VarArgs);
+			Server()->Localization()->Format_VL(Buffer, m_apPlayers[i]->GetLanguageID(), pText, VarArgs);
 
 			Msg.m_pMessage = Buffer.buffer();
 
@@ -447,7 +449,7 @@ void CGS::ChatWorldID(int WorldID, const char* Suffix, const char* pText, ...)
 			continue;
 
 		Buffer.append(Suffix);
-		Server()->Localization()->Format_VL(Buffer, pPlayer->GetLanguage(), pText, VarArgs);
+		Server()->Localization()->Format_VL(Buffer, pPlayer->GetLanguageID(), pText, VarArgs);
 
 		Msg.m_pMessage = Buffer.buffer();
 
@@ -499,7 +501,7 @@ void CGS::Motd(int ClientID, const char* Text, ...)
 	va_list VarArgs;
 	va_start(VarArgs, Text);
 	dynamic_string Buffer;
-	Server()->Localization()->Format_VL(Buffer, pPlayer->GetLanguage(), Text, VarArgs);
+	Server()->Localization()->Format_VL(Buffer, pPlayer->GetLanguageID(), Text, VarArgs);
 
 	CNetMsg_Sv_Motd Msg;
 	Msg.m_pMessage = Buffer.buffer();
@@ -538,7 +540,7 @@ void CGS::Broadcast(int ClientID, BroadcastPriority Priority, int LifeSpan, cons
 		if(m_apPlayers[i])
 		{
 			dynamic_string Buffer;
-			Server()->Localization()->Format_VL(Buffer, m_apPlayers[i]->GetLanguage(), pText, VarArgs);
+			Server()->Localization()->Format_VL(Buffer, m_apPlayers[i]->GetLanguageID(), pText, VarArgs);
 			AddBroadcast(i, Buffer.buffer(), Priority, LifeSpan);
 			Buffer.clear();
 		}
@@ -556,7 +558,7 @@ void CGS::BroadcastWorldID(int WorldID, BroadcastPriority Priority, int LifeSpan
 		if(m_apPlayers[i] && IsPlayerEqualWorld(i, WorldID))
 		{
 			dynamic_string Buffer;
-			Server()->Localization()->Format_VL(Buffer, m_apPlayers[i]->GetLanguage(), pText, VarArgs);
+			Server()->Localization()->Format_VL(Buffer, m_apPlayers[i]->GetLanguageID(), pText, VarArgs);
 			AddBroadcast(i, Buffer.buffer(), Priority, LifeSpan);
 			Buffer.clear();
 		}
@@ -697,6 +699,15 @@ void CGS::UpdateDiscordStatus()
 #endif
 }
 
+// only touches the world's own map, the server runs it for all worlds at once
+void CGS::OnInitMap(int WorldID)
+{
+	m_pLayers = new CLayers();
+	m_pLayers->Init(Kernel(), WorldID);
+	m_Collision.Init(m_pLayers);
+	m_pPathFinder = new CPathfinder(m_pLayers, &m_Collision);
+}
+
 void CGS::OnInit(int WorldID)
 {
 	m_pServer = Kernel()->RequestInterface<IServer>();
@@ -710,9 +721,6 @@ void CGS::OnInit(int WorldID)
 		Server()->SnapSetStaticsize(i, m_NetObjHandler.GetObjSize(i));
 
 	// create controller
-	m_pLayers = new CLayers();
-	m_pLayers->Init(Kernel(), WorldID);
-	m_Collision.Init(m_pLayers);
 	m_pMmoController = new MmoController(this);
 	m_pMmoController->LoadLogicWorld();
 
@@ -746,8 +754,6 @@ void CGS::OnInit(int WorldID)
 		}
 	}
 
-	// initialize pathfinder
-	m_pPathFinder = new CPathfinder(m_pLayers, &m_Collision);
 	Console()->Chain("sv_motd", ConchainSpecialMotdupdate, this);
 }
 
@@ -766,6 +772,7 @@ void CGS::OnConsoleInit()
 	Console()->Register("sync_lines_for_translate", "", CFGFLAG_SERVER, ConSyncLinesForTranslate, m_pServer, "Perform sync lines in translated files. Order non updated translated to up");
 	Console()->Register("afk_list", "", CFGFLAG_SERVER, ConListAfk, m_pServer, "List all afk players");
 	Console()->Register("is_afk", "i[cid]", CFGFLAG_SERVER, ConCheckAfk, m_pServer, "Check if player is afk");
+	Console()->Register("entity_stats", "?i[worldid]", CFGFLAG_SERVER, ConEntityStats, m_pServer, "Print the entity pools of all worlds or of one world");
 
     Console()->Register("ban_acc", "i[cid]s[time]r[reason]", CFGFLAG_SERVER, ConBanAcc  , m_pServer, "Ban account, time format: d - days, h - hours, m - minutes, s - seconds, example: 3d15m");
     Console()->Register("unban_acc", "i[banid]", CFGFLAG_SERVER, ConUnBanAcc  , m_pServer, "UnBan account, pass ban id from bans_acc");
@@ -774,6 +781,15 @@ void CGS::OnConsoleInit()
 
 void CGS::OnTick()
 {
+	m_Collision.ClearLineMemo();
+
+	// hand the found paths to the bots before they move
+	m_pPathFinder->Update([this](int ClientID, std::vector<vec2>&& aWayPoints)
+	{
+		if(CPlayerBot* pBot = dynamic_cast<CPlayerBot*>(m_apPlayers[ClientID]))
+			pBot->SetWayPoints(std::move(aWayPoints));
+	});
+
 	m_World.m_Core.m_Tuning = m_Tuning;
 	m_World.Tick();
 	m_pController->Tick();
@@ -794,9 +810,31 @@ void CGS::OnTick()
 	Mmo()->OnTick();
 }
 
+// The world was not ticked while it was empty. Respawns of bots and of the
+// farming and mining points are stored as deadline ticks and are simply due now,
+// only the counters that are decreased while ticking have to be advanced
+void CGS::OnWakeUp(int SleepTicks)
+{
+	const int Seconds = SleepTicks / Server()->TickSpeed();
+	for(int i = MAX_PLAYERS; i < MAX_CLIENTS; i++)
+	{
+		if(CPlayerBot* pBot = dynamic_cast<CPlayerBot*>(m_apPlayers[i]))
+			pBot->SkipEffects(Seconds);
+	}
+
+	char aBuf[128];
+	str_format(aBuf, sizeof(aBuf), "world '%s' woke up after %d seconds", Server()->GetWorldName(m_WorldID), Seconds);
+	Console()->Print(IConsole::OUTPUT_LEVEL_DEBUG, "game", aBuf);
+}
+
 // Here we use functions that can have static data or functions that don't need to be called in all worlds
 void CGS::OnTickMainWorld()
 {
+	// the items of all clients are written here, while no world is ticking
+	Mmo()->Item()->TickSleepItems();
+	if(Server()->Tick() % g_Config.m_SvItemsSaveInterval == 0)
+		CInventoryCore::SaveDirtyItems();
+
 	if(m_DayEnumType != Server()->GetEnumTypeDay())
 	{
 		m_DayEnumType = Server()->GetEnumTypeDay();
@@ -861,7 +899,17 @@ void CGS::OnSnap(int ClientID)
 	m_Events.Snap(ClientID);
 }
 
-void CGS::OnPreSnap() {}
+void CGS::OnPreSnap()
+{
+	// the snapshots of the clients are built concurrently, fill what they read lazily
+	for(auto* pPlayer : m_apPlayers)
+	{
+		if(pPlayer)
+			pPlayer->PrepareSnap();
+	}
+
+	m_World.PreSnap();
+}
 void CGS::OnPostSnap()
 {
 	m_World.PostSnap();
@@ -1272,7 +1320,8 @@ void CGS::ClearClientData(int ClientID)
 {
 	Mmo()->ResetClientData(ClientID);
 	m_aPlayerVotes[ClientID].clear();
-	ms_aEffects[ClientID].clear();
+	ms_aSentVotes[ClientID].clear();
+	ms_aEffects[ClientID].Clear();
 
 	// clear active snap bots for player
 	for(auto& pActiveSnap : DataBotInfo::ms_aDataBot)
@@ -1453,6 +1502,19 @@ void CGS::ConCheckAfk(IConsole::IResult* pResult, void* pUserData)
 	pSelf->Console()->Print(IConsole::OUTPUT_LEVEL_STANDARD, "AFK", "No such player or he's not afk");
 }
 
+void CGS::ConEntityStats(IConsole::IResult* pResult, void* pUserData)
+{
+	IServer* pServer = (IServer*)pUserData;
+	for(int i = 0; i < pServer->GetWorldsSize(); i++)
+	{
+		if(pResult->NumArguments() > 0 && pResult->GetInteger(0) != i)
+			continue;
+
+		CGS* pSelf = (CGS*)pServer->GameServer(i);
+		pSelf->m_World.Allocator()->PrintStats(pSelf->Console(), pServer->GetWorldName(i));
+	}
+}
+
 void CGS::ConBanAcc(IConsole::IResult* pResult, void* pUserData)
 {
 	const int ClientID = pResult->GetInteger(0);
@@ -1533,12 +1595,70 @@ void CGS::ConchainGameinfoUpdate(IConsole::IResult *pResult, void *pUserData, IC
 void CGS::ClearVotes(int ClientID)
 {
 	m_aPlayerVotes[ClientID].clear();
+	ms_aSentVotes[ClientID].clear();
 
 	// send vote options
 	CNetMsg_Sv_VoteClearOptions ClearMsg;
 	Server()->SendPackMsg(&ClearMsg, MSGFLAG_VITAL, ClientID);
 }
 
+void CGS::SendVotes(int ClientID)
+{
+	const std::deque<CVoteOptions>& aVotes = m_aPlayerVotes[ClientID];
+	std::vector<std::string>& aSent = ms_aSentVotes[ClientID];
+
+	// the client keeps the options up to the first difference
+	size_t Keep = 0;
+	while(Keep < aSent.size() && Keep < aVotes.size() && aSent[Keep] == aVotes[Keep].m_aDescription)
+		Keep++;
+	if(Keep == aSent.size() && Keep == aVotes.size())
+		return;
+
+	// the client removes the first option with the description, so an option can only
+	// be removed alone if none of the kept ones looks the same, else the list is sent again
+	const int NumRemove = (int)(aSent.size() - Keep);
+	const int NumAddMsgs = (int)(aVotes.size() - Keep + 14) / 15;
+	bool Resend = NumRemove + NumAddMsgs >= 1 + (int)(aVotes.size() + 14) / 15;
+	for(size_t i = Keep; i < aSent.size() && !Resend; i++)
+		Resend = std::find(aSent.begin(), aSent.begin() + Keep, aSent[i]) != aSent.begin() + Keep;
+
+	if(Resend)
+	{
+		CNetMsg_Sv_VoteClearOptions ClearMsg;
+		Server()->SendPackMsg(&ClearMsg, MSGFLAG_VITAL, ClientID);
+		Keep = 0;
+	}
+	else
+	{
+		for(size_t i = Keep; i < aSent.size(); i++)
+		{
+			CNetMsg_Sv_VoteOptionRemove RemoveMsg;
+			RemoveMsg.m_pDescription = aSent[i].c_str();
+			Server()->SendPackMsg(&RemoveMsg, MSGFLAG_VITAL, ClientID);
+		}
+	}
+	aSent.resize(Keep);
+
+	// the rest goes out fifteen options per message
+	CNetMsg_Sv_VoteOptionListAdd OptionMsg;
+	const char** apDescriptions[] = {
+		&OptionMsg.m_pDescription0, &OptionMsg.m_pDescription1, &OptionMsg.m_pDescription2, &OptionMsg.m_pDescription3, &OptionMsg.m_pDescription4,
+		&OptionMsg.m_pDescription5, &OptionMsg.m_pDescription6, &OptionMsg.m_pDescription7, &OptionMsg.m_pDescription8, &OptionMsg.m_pDescription9,
+		&OptionMsg.m_pDescription10, &OptionMsg.m_pDescription11, &OptionMsg.m_pDescription12, &OptionMsg.m_pDescription13, &OptionMsg.m_pDescription14,
+	};
+	for(size_t Start = Keep; Start < aVotes.size(); Start += 15)
+	{
+		const int NumOptions = (int)min<size_t>(15, aVotes.size() - Start);
+		for(int i = 0; i < 15; i++)
+			*apDescriptions[i] = i < NumOptions ? aVotes[Start + i].m_aDescription : "";
+		OptionMsg.m_NumOptions = NumOptions;
+		Server()->SendPackMsg(&OptionMsg, MSGFLAG_VITAL, ClientID);
+	}
+
+	for(size_t i = Keep; i < aVotes.size(); i++)
+		aSent.emplace_back(aVotes[i].m_aDescription);
+}
+
 // add a vote
 void CGS::AV(int ClientID, const char *pCmd, const char *pDesc, const int TempInt, const int TempInt2)
 {
@@ -1573,7 +1693,7 @@ void CGS::AVL(int ClientID, const char *pCmd, const char *pText, ...)
 		if(str_comp(pCmd, "null") != 0)
 			Buffer.append("- ");
 
-		Server()->Localization()->Format_VL(Buffer, m_apPlayers[ClientID]->GetLanguage(), pText, VarArgs);
+		Server()->Localization()->Format_VL(Buffer, m_apPlayers[ClientID]->GetLanguageID(), pText, VarArgs);
 		AV(ClientID, pCmd, Buffer.buffer());
 		Buffer.clear();
 
@@ -1596,7 +1716,7 @@ void CGS::AVH(int ClientID, const int HiddenID, const char *pText, ...)
 		dynamic_string Buffer;
 
 		Buffer.append(pSymbols);
-		Server()->Localization()->Format_VL(Buffer, m_apPlayers[ClientID]->GetLanguage(), pText, VarArgs);
+		Server()->Localization()->Format_VL(Buffer, m_apPlayers[ClientID]->GetLanguageID(), pText, VarArgs);
 		if(HiddenID > TAB_SETTINGS_MODULES && HiddenID < NUM_TAB_MENU) { Buffer.append(" (Press me for help)"); }
 
 		AV(ClientID, "HIDDEN", Buffer.buffer(), HiddenID, -1);
@@ -1621,7 +1741,7 @@ void CGS::AVM(int ClientID, const char *pCmd, const int TempInt, const int Hidde
 		dynamic_string Buffer;
 		if(TempInt != NOPE) { Buffer.append("- "); }
 
-		Server()->Localization()->Format_VL(Buffer, m_apPlayers[ClientID]->GetLanguage(), pText, VarArgs);
+		Server()->Localization()->Format_VL(Buffer, m_apPlayers[ClientID]->GetLanguageID(), pText, VarArgs);
 		AV(ClientID, pCmd, Buffer.buffer(), TempInt);
 		Buffer.clear();
 		va_end(VarArgs);
@@ -1643,7 +1763,7 @@ void CGS::AVD(int ClientID, const char *pCmd, const int TempInt, const int TempI
 		dynamic_string Buffer;
 		if(TempInt != NOPE) { Buffer.append("- "); }
 
-		Server()->Localization()->Format_VL(Buffer, m_apPlayers[ClientID]->GetLanguage(), pText, VarArgs);
+		Server()->Localization()->Format_VL(Buffer, m_apPlayers[ClientID]->GetLanguageID(), pText, VarArgs);
 		AV(ClientID, pCmd, Buffer.buffer(), TempInt, TempInt2);
 		Buffer.clear();
 		va_end(VarArgs);
@@ -1657,7 +1777,7 @@ void CGS::StartCustomVotes(int ClientID, int LastVoteMenu)
 	{
 		pPlayer->m_OpenVoteMenu = CUSTOM_MENU;
 		pPlayer->m_LastVoteMenu = LastVoteMenu;
-		ClearVotes(ClientID);
+		m_aPlayerVotes[ClientID].clear();
 	}
 }
 
@@ -1672,31 +1792,14 @@ void CGS::CallbackUpdateVotes(CGS* pGS, int ClientID, int Menulist, bool Prepare
 	if(!pPlayer)
 		return;
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(3));
-	if(Menulist == CUSTOM_MENU && PrepareCustom)
-	{
-		// send parsed votes
-		for(auto& p : pGS->m_aPlayerVotes[ClientID])
-		{
-			CNetMsg_Sv_VoteOptionAdd OptionMsg;
-			OptionMsg.m_pDescription = p.m_aDescription;
-			pGS->Server()->SendPackMsg(&OptionMsg, MSGFLAG_VITAL, ClientID);
-		}
-		return;
-	}
-
-	// parse votes
-	pPlayer->m_OpenVoteMenu = Menulist;
-	pGS->ClearVotes(ClientID);
-	pGS->Mmo()->OnPlayerHandleMainMenu(ClientID, Menulist);
-
-	// send parsed votes
-	for(auto& p : pGS->m_aPlayerVotes[ClientID])
+	// parse votes, only the difference to the options of the client is sent
+	if(Menulist != CUSTOM_MENU || !PrepareCustom)
 	{
-		CNetMsg_Sv_VoteOptionAdd OptionMsg;
-		OptionMsg.m_pDescription = p.m_aDescription;
-		pGS->Server()->SendPackMsg(&OptionMsg, MSGFLAG_VITAL, ClientID);
+		pPlayer->m_OpenVoteMenu = Menulist;
+		pGS->m_aPlayerVotes[ClientID].clear();
+		pGS->Mmo()->OnPlayerHandleMainMenu(ClientID, Menulist);
 	}
+	pGS->SendVotes(ClientID);
 }
 
 void CGS::UpdateVotes(int ClientID, int MenuList)
@@ -1877,8 +1980,7 @@ void CGS::CreateText(CEntity* pParent, bool Follow, vec2 Pos, vec2 Vel, int Life
 	if(!IsPlayersNearby(Pos, 800))
 		return;
 
-	CLoltext Text;
-	Text.Create(&m_World, pParent, Pos, Vel, Lifespan, pText, true, Follow);
+	new(&m_World) CLoltext(&m_World, pParent, Pos, Vel, Lifespan, pText, Follow);
 }
 
 // creates a particle of experience that follows the player
@@ -1898,7 +2000,7 @@ void CGS::CreateDropBonuses(vec2 Pos, int Type, int Value, int NumDrop, vec2 For
 	{
 		const vec2 Vel = Force + vec2(frandom() * 15.0f, frandom() * 15.0f);
 		const float Angle = Force.x * (0.15f + frandom() * 0.1f);
-		new CDropBonuses(&m_World, Pos, Vel, Angle, Type, Value);
+		new(&m_World) CDropBonuses(&m_World, Pos, Vel, Angle, Type, Value);
 	}
 }
 
@@ -1909,7 +2011,7 @@ void CGS::CreateDropItem(vec2 Pos, int ClientID, CItem DropItem, vec2 Force)
 		return;
 
 	const float Angle = angle(normalize(Force));
-	new CDropItem(&m_World, Pos, Force, Angle, DropItem, ClientID);
+	new(&m_World) CDropItem(&m_World, Pos, Force, Angle, DropItem, ClientID);
 }
 
 // random drop of the item with percentage
@@ -2017,9 +2119,11 @@ bool CGS::IsPlayerEqualWorld(int ClientID, int WorldID) const
 
 bool CGS::IsPlayersNearby(vec2 Pos, float Distance) const
 {
+	// players without a character are not counted
+	const std::bitset<MAX_CLIENTS> Nearby = m_World.FindCharactersNearby(Pos, Distance);
 	for(int i = 0; i < MAX_PLAYERS; i++)
 	{
-		if(m_apPlayers[i] && IsPlayerEqualWorld(i) && distance(Pos, m_apPlayers[i]->m_ViewPos) <= Distance)
+		if(Nearby[i] && m_apPlayers[i] && IsPlayerEqualWorld(i) && distance(Pos, m_apPlayers[i]->m_ViewPos) <= Distance)
 			return true;
 	}
 	return false;
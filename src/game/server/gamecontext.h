@@ -61,7 +61,7 @@ public:
 	/* #########################################################################
 		SWAP GAMECONTEX DATA
 	######################################################################### */
-	static std::unordered_map < std::string /* effect */, int /* seconds */ > ms_aEffects[MAX_PLAYERS];
+	static CEffectSet ms_aEffects[MAX_PLAYERS];
 	// - - - - - - - - - - - -
 
 	/* #########################################################################
@@ -141,12 +141,14 @@ public:
 	/* #########################################################################
 		ENGINE GAMECONTEXT
 	######################################################################### */
+	void OnInitMap(int WorldID) override;
 	void OnInit(int WorldID) override;
 	void OnConsoleInit() override;
 	void OnShutdown() override { delete this; }
 
 	void OnTick() override;
 	void OnTickMainWorld() override;
+	void OnWakeUp(int SleepTicks) override;
 	void OnPreSnap() override;
 	void OnSnap(int ClientID) override;
 	void OnPostSnap() override;
@@ -185,6 +187,7 @@ private:
 	static void ConSyncLinesForTranslate(IConsole::IResult *pResult, void *pUserData);
 	static void ConListAfk(IConsole::IResult *pResult, void *pUserData);
 	static void ConCheckAfk(IConsole::IResult *pResult, void *pUserData);
+	static void ConEntityStats(IConsole::IResult *pResult, void *pUserData);
 	static void ConBanAcc(IConsole::IResult *pResult, void *pUserData);
 	static void ConUnBanAcc(IConsole::IResult *pResult, void *pUserData);
 	static void ConBansAcc(IConsole::IResult *pResult, void *pUserData);
@@ -197,6 +200,10 @@ private:
 	std::deque<CVoteOptions> m_aPlayerVotes[MAX_PLAYERS];
 	static void CallbackUpdateVotes(CGS* pGS, int ClientID, int Menulist, bool PrepareCustom);
 
+	// the options the client shows, shared by the worlds as the client keeps its list when it changes the world
+	static std::vector<std::string> ms_aSentVotes[MAX_PLAYERS];
+	void SendVotes(int ClientID);
+
 public:
 	void AV(int ClientID , const char *pCmd, const char *pDesc = "\0", int TempInt = -1, int TempInt2 = -1);
 	void AVL(int ClientID, const char *pCmd, const char *pText, ...);
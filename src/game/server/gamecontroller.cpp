@@ -115,30 +115,30 @@ bool IGameController::OnEntity(int Index, vec2 Pos)
 
 	if(Type != -1)
 	{
-		new CPickup(&GS()->m_World, Type, SubType, Pos);
+		new(&GS()->m_World) CPickup(&GS()->m_World, Type, SubType, Pos);
 		return true;
 	}
 
 	// BOT'S WALLS
 	if(Index == ENTITY_NPC_WALLUP)
 	{
-		new CNPCWall(&GS()->m_World, Pos, false, CNPCWall::Flags::FRIENDLY_BOT);
+		new(&GS()->m_World) CNPCWall(&GS()->m_World, Pos, false, CNPCWall::Flags::FRIENDLY_BOT);
 		return true;
 	}
 
 	if(Index == ENTITY_NPC_WALLLEFT)
 	{
-		new CNPCWall(&GS()->m_World, Pos, true, CNPCWall::Flags::FRIENDLY_BOT);
+		new(&GS()->m_World) CNPCWall(&GS()->m_World, Pos, true, CNPCWall::Flags::FRIENDLY_BOT);
 		return true;
 	}
 	if(Index == ENTITY_MOB_WALLUP)
 	{
-		new CNPCWall(&GS()->m_World, Pos, false, CNPCWall::Flags::AGRESSED_BOT);
+		new(&GS()->m_World) CNPCWall(&GS()->m_World, Pos, false, CNPCWall::Flags::AGRESSED_BOT);
 		return true;
 	}
 	if(Index == ENTITY_MOB_WALLLEFT)
 	{
-		new CNPCWall(&GS()->m_World, Pos, true, CNPCWall::Flags::AGRESSED_BOT);
+		new(&GS()->m_World) CNPCWall(&GS()->m_World, Pos, true, CNPCWall::Flags::AGRESSED_BOT);
 		return true;
 	}
 
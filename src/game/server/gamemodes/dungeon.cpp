@@ -24,7 +24,7 @@ CGameControllerDungeon::CGameControllerDungeon(class CGS *pGS) : IGameController
 
 	// door creation to start
 	vec2 DoorPosition = vec2(CDungeonData::ms_aDungeon[m_DungeonID].m_DoorX, CDungeonData::ms_aDungeon[m_DungeonID].m_DoorY);
-	m_DungeonDoor = new DungeonDoor(&GS()->m_World, DoorPosition);
+	m_DungeonDoor = new(&GS()->m_World) DungeonDoor(&GS()->m_World, DoorPosition);
 	ChangeState(DUNGEON_WAITING);
 
 	// key door construction
@@ -33,7 +33,7 @@ CGameControllerDungeon::CGameControllerDungeon(class CGS *pGS) : IGameController
 	{
 		const int DungeonBotID = pRes->getInt("BotID");
 		DoorPosition = vec2(pRes->getInt("PosX"), pRes->getInt("PosY"));
-		new CLogicDungeonDoorKey(&GS()->m_World, DoorPosition, DungeonBotID);
+		new(&GS()->m_World) CLogicDungeonDoorKey(&GS()->m_World, DoorPosition, DungeonBotID);
 	}
 }
 
@@ -554,13 +554,13 @@ void CGameControllerDungeon::Snap()
 void CGameControllerDungeon::CreateLogic(int Type, int Mode, vec2 Pos, int ParseInt)
 {
 	if(Type == 1)
-		new CLogicWall(&GS()->m_World, Pos);
+		new(&GS()->m_World) CLogicWall(&GS()->m_World, Pos);
 
 	if(Type == 2)
-		new CLogicWallWall(&GS()->m_World, Pos, Mode, ParseInt);
+		new(&GS()->m_World) CLogicWallWall(&GS()->m_World, Pos, Mode, ParseInt);
 
 	if(Type == 3)
-		new CLogicDoorKey(&GS()->m_World, Pos, ParseInt, Mode);
+		new(&GS()->m_World) CLogicDoorKey(&GS()->m_World, Pos, ParseInt, Mode);
 }
 
 bool CGameControllerDungeon::OnEntity(int Index, vec2 Pos)
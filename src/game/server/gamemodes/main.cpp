@@ -25,15 +25,15 @@ void CGameControllerMain::CreateLogic(int Type, int Mode, vec2 Pos, int ParseInt
 {
 	if(Type == 1)
 	{
-		new CLogicWall(&GS()->m_World, Pos);
+		new(&GS()->m_World) CLogicWall(&GS()->m_World, Pos);
 	}
 	if(Type == 2)
 	{
-		new CLogicWallWall(&GS()->m_World, Pos, Mode, ParseInt);
+		new(&GS()->m_World) CLogicWallWall(&GS()->m_World, Pos, Mode, ParseInt);
 	}
 	if(Type == 3)
 	{
-		new CLogicDoorKey(&GS()->m_World, Pos, ParseInt, Mode);
+		new(&GS()->m_World) CLogicDoorKey(&GS()->m_World, Pos, ParseInt, Mode);
 	}
 }
 
@@ -47,13 +47,13 @@ bool CGameControllerMain::OnEntity(int Index, vec2 Pos)
 		CHouseData* pHouse = GS()->Mmo()->House()->GetHouseByPlantPos(Pos);
 		if(pHouse && pHouse->GetPlantItemID() > 0)
 		{
-			new CJobItems(&GS()->m_World, pHouse->GetPlantItemID(), 1, Pos, CJobItems::JOB_ITEM_FARMING, 100, pHouse->GetID());
+			new(&GS()->m_World) CJobItems(&GS()->m_World, pHouse->GetPlantItemID(), 1, Pos, CJobItems::JOB_ITEM_FARMING, 100, pHouse->GetID());
 			return true;
 		}
 
 		const int ItemID = GS()->Mmo()->PlantsAcc()->GetPlantItemID(Pos), Level = GS()->Mmo()->PlantsAcc()->GetPlantLevel(Pos);
 		if(ItemID > 0)
-			new CJobItems(&GS()->m_World, ItemID, Level, Pos, CJobItems::JOB_ITEM_FARMING, 100);
+			new(&GS()->m_World) CJobItems(&GS()->m_World, ItemID, Level, Pos, CJobItems::JOB_ITEM_FARMING, 100);
 
 		return true;
 	}
@@ -64,7 +64,7 @@ bool CGameControllerMain::OnEntity(int Index, vec2 Pos)
 		if(ItemID > 0)
 		{
 			const int Health = GS()->Mmo()->MinerAcc()->GetOreHealth(Pos);
-			new CJobItems(&GS()->m_World, ItemID, Level, Pos, CJobItems::JOB_ITEM_MINING, Health);
+			new(&GS()->m_World) CJobItems(&GS()->m_World, ItemID, Level, Pos, CJobItems::JOB_ITEM_MINING, Health);
 		}
 
 		return true;
@@ -6,25 +6,30 @@
 
 #include <engine/shared/config.h>
 
+#include <algorithm>
+
 //////////////////////////////////////////////////
 // game world
 //////////////////////////////////////////////////
-CGameWorld::CGameWorld(): m_pNextTraverseEntity(nullptr), m_Paused(false)
+CGameWorld::CGameWorld(): m_Paused(false)
 {
 	m_pGS = nullptr;
 	m_pServer = nullptr;
 
 	m_ResetRequested = false;
 	for (int i = 0; i < NUM_ENTTYPES; i++)
-		m_apFirstEntityTypes[i] = nullptr;
+	{
+		m_aNumHoles[i] = 0;
+		m_aGridReach[i] = 0.0f;
+	}
 }
 
 CGameWorld::~CGameWorld()
 {
 	// delete all entities
 	for(int i = 0; i < NUM_ENTTYPES; i++)
-		while(m_apFirstEntityTypes[i])
-			delete m_apFirstEntityTypes[i];
+		for(int j = 0; j < (int)m_aapEntities[i].size(); j++)
+			delete m_aapEntities[i][j];
 }
 
 void CGameWorld::SetGameServer(CGS *pGS)
@@ -33,62 +38,153 @@ void CGameWorld::SetGameServer(CGS *pGS)
 	m_pServer = m_pGS->Server();
 }
 
-CEntity *CGameWorld::FindFirst(int Type)
+CEntity *CGameWorld::FindFirst(int Type) const
 {
-	return Type < 0 || Type >= NUM_ENTTYPES ? nullptr : m_apFirstEntityTypes[Type];
+	if(Type < 0 || Type >= NUM_ENTTYPES)
+		return nullptr;
+
+	// the newest entity comes first, like in the old type lists
+	const std::vector<CEntity*> &apEntities = m_aapEntities[Type];
+	for(int i = (int)apEntities.size() - 1; i >= 0; i--)
+	{
+		if(apEntities[i])
+			return apEntities[i];
+	}
+	return nullptr;
 }
 
-int CGameWorld::FindEntities(vec2 Pos, float Radius, CEntity **ppEnts, int Max, int Type)
+CEntity *CGameWorld::NextEntity(const CEntity *pEnt) const
 {
-	if(Type < 0 || Type >= NUM_ENTTYPES)
-		return 0;
+	// a removed entity keeps its slot, so the traversal goes on behind it
+	const std::vector<CEntity*> &apEntities = m_aapEntities[pEnt->m_ObjType];
+	for(int i = pEnt->m_TypeSlot - 1; i >= 0; i--)
+	{
+		if(apEntities[i])
+			return apEntities[i];
+	}
+	return nullptr;
+}
+
+bool CGameWorld::IsInserted(const CEntity *pEnt) const
+{
+	const std::vector<CEntity*> &apEntities = m_aapEntities[pEnt->m_ObjType];
+	return pEnt->m_TypeSlot >= 0 && pEnt->m_TypeSlot < (int)apEntities.size() && apEntities[pEnt->m_TypeSlot] == pEnt;
+}
 
+void CGameWorld::CompactEntities(int Type)
+{
+	if(!m_aNumHoles[Type])
+		return;
+
+	std::vector<CEntity*> &apEntities = m_aapEntities[Type];
 	int Num = 0;
-	for(CEntity *pEnt = m_apFirstEntityTypes[Type];	pEnt; pEnt = pEnt->m_pNextTypeEntity)
+	for(CEntity *pEnt : apEntities)
 	{
-		if(distance(pEnt->m_Pos, Pos) < Radius+pEnt->m_ProximityRadius)
-		{
-			if(ppEnts)
-				ppEnts[Num] = pEnt;
-			Num++;
-			if(Num == Max)
-				break;
-		}
+		if(!pEnt)
+			continue;
+		pEnt->m_TypeSlot = Num;
+		apEntities[Num++] = pEnt;
 	}
-	return Num;
+	apEntities.resize(Num);
+	m_aNumHoles[Type] = 0;
+}
+
+const std::vector<CEntity*> *CGameWorld::FindCell(int Type, int X, int Y) const
+{
+	const auto Iter = m_aGridCells.find(GridKey(Type, X, Y));
+	return Iter == m_aGridCells.end() || Iter->second.empty() ? nullptr : &Iter->second;
+}
+
+void CGameWorld::GridInsert(CEntity *pEnt)
+{
+	const float Reach = pEnt->m_ProximityRadius + distance(pEnt->m_Pos, pEnt->m_PosTo);
+	if(Reach > m_aGridReach[pEnt->m_ObjType])
+		m_aGridReach[pEnt->m_ObjType] = Reach;
+
+	pEnt->m_GridKey = GridKey(pEnt->m_ObjType, GridCoord(pEnt->m_Pos.x), GridCoord(pEnt->m_Pos.y));
+	std::vector<CEntity*> &Cell = m_aGridCells[pEnt->m_GridKey];
+	pEnt->m_GridSlot = (int)Cell.size();
+	Cell.push_back(pEnt);
+}
+
+void CGameWorld::GridRemove(CEntity *pEnt)
+{
+	if(pEnt->m_GridKey == -1)
+		return;
+
+	// empty cells are kept, entities keep coming back to the same places
+	std::vector<CEntity*> &Cell = m_aGridCells[pEnt->m_GridKey];
+	CEntity *pLast = Cell.back();
+	Cell[pEnt->m_GridSlot] = pLast;
+	pLast->m_GridSlot = pEnt->m_GridSlot;
+	Cell.pop_back();
+
+	pEnt->m_GridKey = -1;
+	pEnt->m_GridSlot = -1;
+}
+
+void CGameWorld::UpdateEntityCell(CEntity *pEnt)
+{
+	if(pEnt->m_GridKey == -1)
+		return;
+
+	const float Reach = pEnt->m_ProximityRadius + distance(pEnt->m_Pos, pEnt->m_PosTo);
+	if(Reach > m_aGridReach[pEnt->m_ObjType])
+		m_aGridReach[pEnt->m_ObjType] = Reach;
+
+	if(pEnt->m_GridKey == GridKey(pEnt->m_ObjType, GridCoord(pEnt->m_Pos.x), GridCoord(pEnt->m_Pos.y)))
+		return;
+
+	GridRemove(pEnt);
+	GridInsert(pEnt);
+}
+
+std::bitset<MAX_CLIENTS> CGameWorld::FindCharactersNearby(vec2 Pos, float Radius) const
+{
+	std::bitset<MAX_CLIENTS> Nearby;
+	QueryEntities(Pos - vec2(Radius, Radius), Pos + vec2(Radius, Radius), ENTTYPE_CHARACTER, [&Nearby](CEntity *pEnt)
+	{
+		if(const CPlayer *pPlayer = ((CCharacter *)pEnt)->GetPlayer())
+			Nearby.set(pPlayer->GetCID());
+	});
+	return Nearby;
+}
+
+int CGameWorld::FindEntities(vec2 Pos, float Radius, CEntity **ppEnts, int Max, int Type)
+{
+	const std::vector<CEntity*> vEnts = FindEntities(Pos, Radius, Max, Type);
+	if(ppEnts)
+		std::copy(vEnts.begin(), vEnts.end(), ppEnts);
+	return (int)vEnts.size();
 }
 
 std::vector<CEntity*> CGameWorld::FindEntities(vec2 Pos, float Radius, int Max, int Type)
 {
-    if(Type < 0 || Type >= NUM_ENTTYPES)
-        return {};
-
-    std::vector<CEntity*> vEnts(Max);
-    for(CEntity *pEnt = m_apFirstEntityTypes[Type];	pEnt; pEnt = pEnt->m_pNextTypeEntity)
-    {
-        if(distance(pEnt->m_Pos, Pos) < Radius+pEnt->m_ProximityRadius)
-        {
-            vEnts.push_back(pEnt);
-            if(vEnts.size() == std::size_t(Max))
-                break;
-        }
-    }
-    return vEnts;
+	std::vector<CEntity*> vEnts;
+	QueryEntities(Pos - vec2(Radius, Radius), Pos + vec2(Radius, Radius), Type, [&](CEntity *pEnt)
+	{
+		if(distance(pEnt->m_Pos, Pos) < Radius+pEnt->m_ProximityRadius)
+			vEnts.push_back(pEnt);
+	});
+
+	// the cells come in no particular order, return the newest entities first
+	// like the type lists did, so the cap keeps the same ones
+	std::sort(vEnts.begin(), vEnts.end(), [](const CEntity *pA, const CEntity *pB) { return pA->m_TypeSlot > pB->m_TypeSlot; });
+	if(vEnts.size() > std::size_t(max(Max, 0)))
+		vEnts.resize(max(Max, 0));
+	return vEnts;
 }
 
 void CGameWorld::InsertEntity(CEntity *pEnt)
 {
-#ifdef CONF_DEBUG
-	for(CEntity *pCur = m_apFirstEntityTypes[pEnt->m_ObjType]; pCur; pCur = pCur->m_pNextTypeEntity)
-		dbg_assert(pCur != pEnt, "err");
-#endif
+	dbg_assert(!IsInserted(pEnt), "entity inserted twice");
 
 	// insert it
-	if(m_apFirstEntityTypes[pEnt->m_ObjType])
-		m_apFirstEntityTypes[pEnt->m_ObjType]->m_pPrevTypeEntity = pEnt;
-	pEnt->m_pNextTypeEntity = m_apFirstEntityTypes[pEnt->m_ObjType];
-	pEnt->m_pPrevTypeEntity = nullptr;
-	m_apFirstEntityTypes[pEnt->m_ObjType] = pEnt;
+	std::vector<CEntity*> &apEntities = m_aapEntities[pEnt->m_ObjType];
+	pEnt->m_TypeSlot = (int)apEntities.size();
+	apEntities.push_back(pEnt);
+
+	GridInsert(pEnt);
 }
 
 void CGameWorld::DestroyEntity(CEntity *pEnt)
@@ -99,59 +195,113 @@ void CGameWorld::DestroyEntity(CEntity *pEnt)
 void CGameWorld::RemoveEntity(CEntity *pEnt)
 {
 	// not in the list
-	if(!pEnt->m_pNextTypeEntity && !pEnt->m_pPrevTypeEntity && m_apFirstEntityTypes[pEnt->m_ObjType] != pEnt)
+	if(!IsInserted(pEnt))
 		return;
 
-	// remove
-	if(pEnt->m_pPrevTypeEntity)
-		pEnt->m_pPrevTypeEntity->m_pNextTypeEntity = pEnt->m_pNextTypeEntity;
-	else
-		m_apFirstEntityTypes[pEnt->m_ObjType] = pEnt->m_pNextTypeEntity;
-	if(pEnt->m_pNextTypeEntity)
-		pEnt->m_pNextTypeEntity->m_pPrevTypeEntity = pEnt->m_pPrevTypeEntity;
+	GridRemove(pEnt);
 
-	// keep list traversing valid
-	if(m_pNextTraverseEntity == pEnt)
-		m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
-
-	pEnt->m_pNextTypeEntity = nullptr;
-	pEnt->m_pPrevTypeEntity = nullptr;
+	// leave a hole, the traversals keep going
+	m_aapEntities[pEnt->m_ObjType][pEnt->m_TypeSlot] = nullptr;
+	m_aNumHoles[pEnt->m_ObjType]++;
 }
 
 //
 void CGameWorld::Snap(int SnappingClient)
 {
-	for(int i = 0; i < NUM_ENTTYPES; i++)
-		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
-		{
-			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
+	// several clients are snapped at once, nothing is removed while snapping
+	ForEachEntity([SnappingClient](CEntity *pEnt)
+	{
+		if(!pEnt->IsSnapShared())
 			pEnt->Snap(SnappingClient);
-			pEnt = m_pNextTraverseEntity;
+	});
+
+	SnapShared(SnappingClient);
+}
+
+void CGameWorld::PreSnap()
+{
+	for(auto& [Key, aFragments] : m_aSnapCells)
+		aFragments.clear();
+	m_aSnapFragmentData.clear();
+
+	// the clients that will be snapped in this world
+	int aViewers[MAX_PLAYERS];
+	int NumViewers = 0;
+	for(int ClientID = 0; ClientID < MAX_PLAYERS; ClientID++)
+	{
+		CPlayer *pPlayer = GS()->m_apPlayers[ClientID];
+		if(pPlayer && pPlayer->GetPlayerWorldID() == GS()->GetWorldID())
+			aViewers[NumViewers++] = ClientID;
+	}
+
+	ForEachEntity([&](CEntity *pEnt)
+	{
+		if(!pEnt->IsSnapShared())
+			return;
+
+		// only what at least one client sees is recorded
+		bool Visible = false;
+		for(int v = 0; v < NumViewers && !Visible; v++)
+			Visible = !pEnt->NetworkClipped(aViewers[v]);
+		if(!Visible)
+			return;
+
+		const void *pData;
+		Server()->SnapBeginFragment();
+		pEnt->Snap(-1);
+		const int Size = Server()->SnapEndFragment(&pData);
+		if(Size <= 0)
+			return;
+
+		const int Offset = (int)m_aSnapFragmentData.size();
+		m_aSnapFragmentData.insert(m_aSnapFragmentData.end(), (const char *)pData, (const char *)pData + Size);
+		m_aSnapCells[GridKey(0, GridCoord(pEnt->m_Pos.x), GridCoord(pEnt->m_Pos.y))].push_back({ pEnt, Offset, Size });
+	});
+}
+
+void CGameWorld::SnapShared(int SnappingClient)
+{
+	if(SnappingClient == -1)
+	{
+		for(const auto& [Key, aFragments] : m_aSnapCells)
+			for(const CSnapFragment& Fragment : aFragments)
+				Server()->SnapAddFragment(&m_aSnapFragmentData[Fragment.m_Offset], Fragment.m_Size);
+		return;
+	}
+
+	// the cells covering the clipping box of the client, the entity itself decides the rest
+	const vec2 ViewPos = GS()->m_apPlayers[SnappingClient]->m_ViewPos;
+	const int StartX = GridCoord(ViewPos.x - 1000.0f);
+	const int EndX = GridCoord(ViewPos.x + 1000.0f);
+	const int StartY = GridCoord(ViewPos.y - 800.0f);
+	const int EndY = GridCoord(ViewPos.y + 800.0f);
+	for(int y = StartY; y <= EndY; y++)
+	{
+		for(int x = StartX; x <= EndX; x++)
+		{
+			const auto Iter = m_aSnapCells.find(GridKey(0, x, y));
+			if(Iter == m_aSnapCells.end())
+				continue;
+
+			for(const CSnapFragment& Fragment : Iter->second)
+			{
+				if(!Fragment.m_pEntity->NetworkClipped(SnappingClient))
+					Server()->SnapAddFragment(&m_aSnapFragmentData[Fragment.m_Offset], Fragment.m_Size);
+			}
 		}
+	}
 }
 
 //
 void CGameWorld::PostSnap()
 {
-	for(int i = 0; i < NUM_ENTTYPES; i++)
-		for(CEntity* pEnt = m_apFirstEntityTypes[i]; pEnt; )
-		{
-			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
-			pEnt->PostSnap();
-			pEnt = m_pNextTraverseEntity;
-		}
+	ForEachEntity([](CEntity *pEnt) { pEnt->PostSnap(); });
 }
 
 void CGameWorld::Reset()
 {
 	// reset all entities
-	for(int i = 0; i < NUM_ENTTYPES; i++)
-		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
-		{
-			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
-			pEnt->Reset();
-			pEnt = m_pNextTraverseEntity;
-		}
+	ForEachEntity([](CEntity *pEnt) { pEnt->Reset(); });
 	RemoveEntities();
 
 	GS()->m_pController->OnReset();
@@ -163,18 +313,17 @@ void CGameWorld::Reset()
 void CGameWorld::RemoveEntities()
 {
 	// destroy objects marked for destruction
-	for(int i = 0; i < NUM_ENTTYPES; i++)
-		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
+	ForEachEntity([this](CEntity *pEnt)
+	{
+		if(pEnt->IsMarkedForDestroy())
 		{
-			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
-			if(pEnt->IsMarkedForDestroy())
-			{
-				RemoveEntity(pEnt);
-				pEnt->Destroy();
-				pEnt = nullptr;
-			}
-			pEnt = m_pNextTraverseEntity;
+			RemoveEntity(pEnt);
+			pEnt->Destroy();
 		}
+	});
+
+	for(int i = 0; i < NUM_ENTTYPES; i++)
+		CompactEntities(i);
 }
 
 void CGameWorld::Tick()
@@ -182,26 +331,18 @@ void CGameWorld::Tick()
 	if(m_ResetRequested)
 		Reset();
 
-	// update all objects
-	for(int i = 0; i < NUM_ENTTYPES; i++)
-		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
-		{
-			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
-			pEnt->Tick();
-			pEnt = m_pNextTraverseEntity;
-		}
+	TickEntities();
+	UpdatePlayerMaps();
+}
 
-	for(int i = 0; i < NUM_ENTTYPES; i++)
-		for(CEntity *pEnt = m_apFirstEntityTypes[i]; pEnt; )
-		{
-			m_pNextTraverseEntity = pEnt->m_pNextTypeEntity;
-			pEnt->TickDeferred();
-			pEnt = m_pNextTraverseEntity;
-		}
+void CGameWorld::TickEntities()
+{
+	// update all objects
+	ForEachEntity([](CEntity *pEnt) { pEnt->Tick(); });
+	ForEachEntity([](CEntity *pEnt) { pEnt->TickDeferred(); });
+	ForEachEntity([this](CEntity *pEnt) { UpdateEntityCell(pEnt); });
 
 	RemoveEntities();
-
-	UpdatePlayerMaps();
 }
 
 
@@ -212,11 +353,12 @@ CCharacter *CGameWorld::IntersectCharacter(vec2 Pos0, vec2 Pos1, float Radius, v
 	float ClosestLen = distance(Pos0, Pos1) * 100.0f;
 	CCharacter *pClosest = nullptr;
 
-	CCharacter *p = (CCharacter *)FindFirst(ENTTYPE_CHARACTER);
-	for(; p; p = (CCharacter *)p->TypeNext())
- 	{
+	const vec2 Min(min(Pos0.x, Pos1.x) - Radius, min(Pos0.y, Pos1.y) - Radius);
+	const vec2 Max(max(Pos0.x, Pos1.x) + Radius, max(Pos0.y, Pos1.y) + Radius);
+	QueryEntities(Min, Max, ENTTYPE_CHARACTER, [&](CEntity *p)
+	{
 		if(p == pNotThis)
-			continue;
+			return;
 
 		vec2 IntersectPos = closest_point_on_line(Pos0, Pos1, p->m_Pos);
 		float Len = distance(p->m_Pos, IntersectPos);
@@ -227,25 +369,26 @@ CCharacter *CGameWorld::IntersectCharacter(vec2 Pos0, vec2 Pos1, float Radius, v
 			{
 				NewPos = IntersectPos;
 				ClosestLen = Len;
-				pClosest = p;
+				pClosest = (CCharacter *)p;
 			}
 		}
-	}
+	});
 
 	return pClosest;
 }
 
 bool CGameWorld::IntersectClosestEntity(vec2 Pos, float Radius, int EnttypeID)
 {
-	for(CEntity *pDoor = FindFirst(EnttypeID); pDoor; pDoor = pDoor->TypeNext())
- 	{
+	bool Intersected = false;
+	QueryEntities(Pos - vec2(Radius, Radius), Pos + vec2(Radius, Radius), EnttypeID, [&](CEntity *pDoor)
+	{
 		vec2 IntersectPos = pDoor->m_PosTo;
 		if(pDoor->m_Pos != pDoor->m_PosTo)
 			IntersectPos = closest_point_on_line(pDoor->m_Pos, pDoor->m_PosTo, Pos);
 		if (distance(IntersectPos, Pos) <= Radius)
-			return true;
-	}
-	return false;
+			Intersected = true;
+	});
+	return Intersected;
 }
 
 bool CGameWorld::IntersectClosestDoorEntity(vec2 Pos, float Radius)
@@ -267,11 +410,10 @@ CEntity *CGameWorld::ClosestEntity(vec2 Pos, float Radius, int Type, CEntity *pN
 	float ClosestRange = Radius*2;
 	CEntity *pClosest = nullptr;
 
-	CEntity *p = GS()->m_World.FindFirst(Type);
-	for(; p; p = p->TypeNext())
- 	{
+	QueryEntities(Pos - vec2(Radius, Radius), Pos + vec2(Radius, Radius), Type, [&](CEntity *p)
+	{
 		if(p == pNotThis)
-			continue;
+			return;
 
 		const float Len = distance(Pos, p->m_Pos);
 		if(Len < p->m_ProximityRadius+Radius)
@@ -282,7 +424,7 @@ CEntity *CGameWorld::ClosestEntity(vec2 Pos, float Radius, int Type, CEntity *pN
 				pClosest = p;
 			}
 		}
-	}
+	});
 
 	return pClosest;
 }
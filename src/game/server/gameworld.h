@@ -5,6 +5,10 @@
 
 #include <game/gamecore.h>
 
+#include "entity_allocator.h"
+
+#include <bitset>
+
 class CEntity;
 class CCharacter;
 
@@ -55,18 +59,71 @@ public:
 	};
 
 private:
+	enum
+	{
+		GRID_CELL_SIZE = 256,
+		GRID_MAX_QUERY_CELLS = 64,
+	};
+
 	void Reset();
 	void RemoveEntities();
 
-	CEntity *m_pNextTraverseEntity;
-	CEntity *m_apFirstEntityTypes[NUM_ENTTYPES];
+	// entities by type in the order of insertion, they are traversed from the
+	// newest like the old type lists. A removed entity leaves a hole that is
+	// closed in RemoveEntities, so the slots stay valid while the world is
+	// traversed and entities are destroyed in the middle of it.
+	std::vector<CEntity*> m_aapEntities[NUM_ENTTYPES];
+	int m_aNumHoles[NUM_ENTTYPES];
+
+	bool IsInserted(const CEntity *pEnt) const;
+	void CompactEntities(int Type);
+
+	// calls the function for the entities that are in the world when the
+	// traversal of their type starts, those inserted meanwhile wait a tick
+	template<typename F>
+	void ForEachEntity(F&& Func)
+	{
+		for(int i = 0; i < NUM_ENTTYPES; i++)
+		{
+			for(int j = (int)m_aapEntities[i].size() - 1; j >= 0; j--)
+			{
+				if(CEntity *pEnt = m_aapEntities[i][j])
+					Func(pEnt);
+			}
+		}
+	}
+
+	// spatial hash of the entities by type and cell, the cell of an entity is
+	// updated when it is inserted and after every tick. The reach is the largest
+	// distance between the position of an entity and its farthest point.
+	std::unordered_map<int64, std::vector<CEntity*>> m_aGridCells;
+	float m_aGridReach[NUM_ENTTYPES];
+
+	static int GridCoord(float Value) { return (int)floorf(Value / GRID_CELL_SIZE); }
+	static int64 GridKey(int Type, int X, int Y) { return ((int64)Type << 48) | ((int64)(X & 0xffffff) << 24) | (int64)(Y & 0xffffff); }
+	const std::vector<CEntity*> *FindCell(int Type, int X, int Y) const;
+	void GridInsert(CEntity *pEnt);
+	void GridRemove(CEntity *pEnt);
+
+	// recorded snaps of the shared entities by cell, rebuilt before every snapshot tick
+	struct CSnapFragment
+	{
+		CEntity *m_pEntity;
+		int m_Offset;
+		int m_Size;
+	};
+	std::unordered_map<int64, std::vector<CSnapFragment>> m_aSnapCells;
+	std::vector<char> m_aSnapFragmentData;
+	void SnapShared(int SnappingClient);
 
 	class CGS *m_pGS;
 	class IServer *m_pServer;
+	CEntityAllocator m_Allocator;
 
 public:
 	class CGS *GS() const { return m_pGS; }
 	class IServer *Server() const { return m_pServer; }
+	CEntityAllocator *Allocator() { return &m_Allocator; }
 
 	bool m_ResetRequested;
 	bool m_Paused;
@@ -78,7 +135,67 @@ public:
 	void SetGameServer(CGS *pGS);
 	void UpdatePlayerMaps();
 
-	CEntity *FindFirst(int Type);
+	CEntity *FindFirst(int Type) const;
+	CEntity *NextEntity(const CEntity *pEnt) const;
+
+	/*
+		Function: UpdateEntityCell
+			Moves the entity to the cell of its current position. Has to be
+			called when an entity is moved outside of its tick.
+	*/
+	void UpdateEntityCell(CEntity *pEnt);
+
+	/*
+		Function: QueryEntities
+			Calls the function for every entity of a type that may be inside
+			of the box, the caller does the exact test. The function must not
+			insert or remove entities.
+	*/
+	template<typename F>
+	void QueryEntities(vec2 Min, vec2 Max, int Type, F&& Func) const
+	{
+		if(Type < 0 || Type >= NUM_ENTTYPES)
+			return;
+
+		// entities are found even if they moved by half a cell since their cell was updated
+		const float Margin = m_aGridReach[Type] + GRID_CELL_SIZE / 2;
+		const int StartX = GridCoord(Min.x - Margin);
+		const int StartY = GridCoord(Min.y - Margin);
+		const int EndX = GridCoord(Max.x + Margin);
+		const int EndY = GridCoord(Max.y + Margin);
+		if((int64)(EndX - StartX + 1) * (EndY - StartY + 1) > GRID_MAX_QUERY_CELLS)
+		{
+			const std::vector<CEntity*> &apEntities = m_aapEntities[Type];
+			for(int i = (int)apEntities.size() - 1; i >= 0; i--)
+			{
+				if(apEntities[i])
+					Func(apEntities[i]);
+			}
+			return;
+		}
+
+		for(int y = StartY; y <= EndY; y++)
+		{
+			for(int x = StartX; x <= EndX; x++)
+			{
+				if(const std::vector<CEntity*> *pCell = FindCell(Type, x, y))
+				{
+					for(CEntity *pEnt : *pCell)
+						Func(pEnt);
+				}
+			}
+		}
+	}
+
+	/*
+		Function: FindCharactersNearby
+			Finds the characters that may be close to a position.
+
+		Returns:
+			Bitmask by client id of the characters that may be within the
+			radius, the caller does the exact test.
+	*/
+	std::bitset<MAX_CLIENTS> FindCharactersNearby(vec2 Pos, float Radius) const;
 
 	/*
 		Function: find_entities
@@ -189,6 +306,15 @@ public:
 			is being created.
 	*/
 	void Snap(int SnappingClient);
+
+	/*
+		Function: PreSnap
+			Records the snaps of the shared entities that any client
+			in the world can see. Snaps of several clients are built
+			concurrently afterwards, so this is the last point where
+			the world is written before them.
+	*/
+	void PreSnap();
 	void PostSnap();
 	/*
 		Function: tick
@@ -197,6 +323,13 @@ public:
 
 	*/
 	void Tick();
+
+	/*
+		Function: TickEntities
+			The part of the tick that runs the entities, without the
+			reset and the player maps.
+	*/
+	void TickEntities();
 };
 
 #endif
@@ -1,96 +1,94 @@
 /* Binary heap class for pathfind by Sushi */
 #ifndef GAME_SERVER_BINARYHEAP_H
 #define GAME_SERVER_BINARYHEAP_H
-#include <base/tl/array.h>
+#include <vector>
 
+// Min heap of items identified by m_ID. The position of every queued id is kept,
+// so the key of a queued item is decreased in O(log n) without searching for it.
 template <class T>
 class CBinaryHeap
 {
 public:
-	CBinaryHeap()
+	// ids have to be in the range 0 .. NumIDs - 1
+	void SetSize(int NumIDs)
 	{
-		m_CurrentSize = 0;
-		m_lItems.clear();
+		if((int)m_aPosition.size() < NumIDs)
+			m_aPosition.resize(NumIDs);
 	}
 
-	void SetSize(int NewSize)
+	const T* GetMin() const
 	{
-		m_lItems.set_size(NewSize + 1);
-	}
-
-	const T* GetMin()
-	{
-		return &m_lItems[1];
+		return &m_aItems[0];
 	}
 
 	void RemoveMin()
 	{
-		m_lItems[1] = m_lItems[m_CurrentSize--];
-		PercolateDown(1);
+		const T Last = m_aItems.back();
+		m_aItems.pop_back();
+		if(!m_aItems.empty())
+		{
+			m_aItems[0] = Last;
+			PercolateDown(0);
+		}
 	}
 
 	void Insert(const T& Item)
 	{
-		// Percolate up
-		int Hole = ++m_CurrentSize;
-		for (; Hole > 1 && Item < m_lItems[Hole / 2]; Hole /= 2)
-			m_lItems[Hole] = m_lItems[Hole / 2];
-		m_lItems[Hole] = Item;
+		m_aItems.push_back(Item);
+		PercolateUp((int)m_aItems.size() - 1);
 	}
 
-	void Replace(const T& Item)
+	// the item has to be queued and its new key must not be greater
+	void DecreaseKey(const T& Item)
 	{
-		int Index = 0;
-		// replace
-		for (int i = 0; i < m_CurrentSize; i++)
-		{
-			if (Item == m_lItems[i])
-			{
-				m_lItems[i] = Item;
-				Index = i;
-				break;
-			}
-		}
-
-		// Percolate up
-		int Hole = Index;
-		for (; Hole > 1 && m_lItems[Index] < m_lItems[Hole / 2]; Hole /= 2)
-			m_lItems[Hole] = m_lItems[Hole / 2];
-		m_lItems[Hole] = m_lItems[Index];
+		const int Hole = m_aPosition[Item.m_ID];
+		m_aItems[Hole] = Item;
+		PercolateUp(Hole);
 	}
 
 	void MakeEmpty()
 	{
-		m_CurrentSize = 0;
+		m_aItems.clear();
 	}
 
 	int GetSize() const
 	{
-		return m_CurrentSize;
+		return (int)m_aItems.size();
 	}
 
 private:
-	array<T> m_lItems;
+	std::vector<T> m_aItems;
+	std::vector<int> m_aPosition;
 
-	// fake current size
-	int m_CurrentSize;
+	void PercolateUp(int Hole)
+	{
+		const T Item = m_aItems[Hole];
+		for(; Hole > 0 && Item < m_aItems[(Hole - 1) / 2]; Hole = (Hole - 1) / 2)
+		{
+			m_aItems[Hole] = m_aItems[(Hole - 1) / 2];
+			m_aPosition[m_aItems[Hole].m_ID] = Hole;
+		}
+		m_aItems[Hole] = Item;
+		m_aPosition[Item.m_ID] = Hole;
+	}
 
 	void PercolateDown(int Hole)
 	{
-		int Child;
-		T Tmp = m_lItems[Hole];
-
-		for (; Hole * 2 <= m_CurrentSize; Hole = Child)
+		const int Size = (int)m_aItems.size();
+		const T Item = m_aItems[Hole];
+		for(int Child; Hole * 2 + 1 < Size; Hole = Child)
 		{
-			Child = Hole * 2;
-			if (Child != m_CurrentSize && m_lItems[Child + 1] < m_lItems[Child])
+			Child = Hole * 2 + 1;
+			if(Child + 1 < Size && m_aItems[Child + 1] < m_aItems[Child])
 				Child++;
-			if (m_lItems[Child] < Tmp)
-				m_lItems[Hole] = m_lItems[Child];
-			else
+			if(!(m_aItems[Child] < Item))
 				break;
+
+			m_aItems[Hole] = m_aItems[Child];
+			m_aPosition[m_aItems[Hole].m_ID] = Hole;
 		}
-		m_lItems[Hole] = Tmp;
+		m_aItems[Hole] = Item;
+		m_aPosition[Item.m_ID] = Hole;
 	}
 };
 
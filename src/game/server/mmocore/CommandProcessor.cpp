@@ -239,8 +239,8 @@ void CCommandProcessor::ConChatGiveEffect(IConsole::IResult* pResult, void* pUse
 	CGS* pGS = (CGS*)pServer->GameServer(pServer->GetClientWorldID(ClientID));
 
 	CPlayer* pPlayer = pGS->m_apPlayers[ClientID];
-	if(pPlayer && pPlayer->IsAuthed())
-		pPlayer->GiveEffect(pResult->GetString(0), pResult->GetInteger(1));
+	if(pPlayer && pPlayer->IsAuthed() && !pPlayer->GiveEffect(pResult->GetString(0), pResult->GetInteger(1)))
+		pGS->Chat(ClientID, "There is no such effect.");
 }
 
 void CCommandProcessor::ConChatUseItem(IConsole::IResult* pResult, void* pUser)
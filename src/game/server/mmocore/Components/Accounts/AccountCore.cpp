@@ -8,6 +8,7 @@
 #include <game/server/mmocore/Components/Dungeons/DungeonCore.h>
 #include <game/server/mmocore/Components/Mails/MailBoxCore.h>
 #include <game/server/mmocore/Components/Quests/QuestCore.h>
+#include <game/server/mmocore/Components/Rankings/RankingCore.h>
 #include <game/server/mmocore/Components/Worlds/WorldData.h>
 
 #include <game/server/mmocore/Components/Houses/HouseCore.h>
@@ -61,6 +62,8 @@ AccountCodeResult CAccountCore::RegisterAccount(int ClientID, const char *Login,
 
 	Database->Execute<DB::INSERT>("tw_accounts", "(ID, Username, Password, PasswordSalt, RegisterDate, RegisteredIP) VALUES ('%d', '%s', '%s', '%s', UTC_TIMESTAMP(), '%s')", InitID, cClearLogin.cstr(), HashPassword(cClearPass.cstr(), aSalt).c_str(), aSalt, aAddrStr);
 	Database->Execute<DB::INSERT, 100>("tw_accounts_data", "(ID, Nick) VALUES ('%d', '%s')", InitID, cClearNick.cstr());
+	CRankingCore::UpdateAccountName(InitID, cClearNick.cstr());
+	CRankingCore::UpdateAccountLevel(InitID, 1, 0);
 
 	GS()->Chat(ClientID, "- - - - - - - [Successful registered!] - - - - - - -");
 	GS()->Chat(ClientID, "Don't forget your data, have a nice game!");
@@ -69,89 +72,224 @@ AccountCodeResult CAccountCore::RegisterAccount(int ClientID, const char *Login,
 	return AccountCodeResult::AOP_REGISTER_OK;
 }
 
-AccountCodeResult CAccountCore::LoginAccount(int ClientID, const char *Login, const char *Password)
+int CAccountCore::ms_aLoginSequence[MAX_PLAYERS];
+int64 CAccountCore::ms_aLoginStart[MAX_PLAYERS];
+
+struct CAccountCore::CLoginSnapshot
+{
+	int m_ClientID;
+	int m_Sequence;
+	int m_UserID;
+	int m_Pending;
+	char m_aLogin[32];
+	char m_aPassword[32];
+
+	ResultPtr m_pAccount;
+	ResultPtr m_pCredentials;
+	ResultPtr m_pBan;
+	std::vector<ResultPtr> m_apComponents;
+};
+
+bool CAccountCore::IsLoading(int ClientID)
+{
+	// a failed select never answers, so the login can be tried again after a while
+	return ms_aLoginStart[ClientID] && time_get() < ms_aLoginStart[ClientID] + time_freq() * 10;
+}
+
+// the player may have changed the world or left while the selects were running
+CAccountCore* CAccountCore::GetLoginCore(const CLoginSnapshot& Snapshot)
+{
+	if(ms_aLoginSequence[Snapshot.m_ClientID] != Snapshot.m_Sequence)
+		return nullptr;
+
+	CGS* pGS = (CGS*)Instance::GetServer()->GameServerPlayer(Snapshot.m_ClientID);
+	return pGS ? pGS->Mmo()->Account() : nullptr;
+}
+
+void CAccountCore::StopLoading(int ClientID) const
+{
+	ms_aLoginSequence[ClientID]++;
+	ms_aLoginStart[ClientID] = 0;
+}
+
+/*
+	A login never blocks the tick. The account, the credentials and the ban are selected
+	at the same time, after the check every component selects its rows of the account at
+	the same time, and when the last result arrived all of it is applied in one tick.
+*/
+void CAccountCore::LoginAccount(int ClientID, const char *Login, const char *Password)
 {
 	CPlayer *pPlayer = GS()->GetPlayer(ClientID, false);
 	if(!pPlayer)
-		return AccountCodeResult::AOP_UNKNOWN;
+		return;
 
 	const int LengthLogin = str_length(Login);
 	const int LengthPassword = str_length(Password);
 	if(LengthLogin > 12 || LengthLogin < 4 || LengthPassword > 12 || LengthPassword < 4)
 	{
 		GS()->Chat(ClientID, "Username / Password must contain 4-12 characters");
-		return AccountCodeResult::AOP_MISMATCH_LENGTH_SYMBOLS;
+		return;
+	}
+
+	if(IsLoading(ClientID))
+	{
+		GS()->Chat(ClientID, "Your account is still loading.");
+		return;
 	}
 
 	const CSqlString<32> cClearLogin = CSqlString<32>(Login);
 	const CSqlString<32> cClearPass = CSqlString<32>(Password);
 	const CSqlString<32> cClearNick = CSqlString<32>(Server()->ClientName(ClientID));
-	ResultPtr pResAccount = Database->Execute<DB::SELECT>("*", "tw_accounts_data", "WHERE Nick = '%s'", cClearNick.cstr());
-	if(pResAccount->next())
-	{
-		const int UserID = pResAccount->getInt("ID");
-		ResultPtr pResCheck = Database->Execute<DB::SELECT>("ID, LoginDate, Language, Password, PasswordSalt", "tw_accounts", "WHERE Username = '%s' AND ID = '%d'", cClearLogin.cstr(), UserID);
 
-		bool LoginSuccess = false;
-		if(pResCheck->next())
-		{
-			if(!str_comp(pResCheck->getString("Password").c_str(), HashPassword(cClearPass.cstr(), pResCheck->getString("PasswordSalt").c_str()).c_str()))
-				LoginSuccess = true;
-		}
+	auto pSnapshot = std::make_shared<CLoginSnapshot>();
+	pSnapshot->m_ClientID = ClientID;
+	pSnapshot->m_Sequence = ++ms_aLoginSequence[ClientID];
+	pSnapshot->m_UserID = 0;
+	pSnapshot->m_Pending = 3;
+	str_copy(pSnapshot->m_aLogin, cClearLogin.cstr(), sizeof(pSnapshot->m_aLogin));
+	str_copy(pSnapshot->m_aPassword, cClearPass.cstr(), sizeof(pSnapshot->m_aPassword));
+	ms_aLoginStart[ClientID] = time_get();
 
-		if(!LoginSuccess)
+	const auto Collect = [pSnapshot](ResultPtr CLoginSnapshot::*pField)
+	{
+		return [pSnapshot, pField](ResultPtr pRes)
 		{
-			GS()->Chat(ClientID, "Wrong login or password.");
-			return AccountCodeResult::AOP_LOGIN_WRONG;
-		}
+			pSnapshot.get()->*pField = std::move(pRes);
+			if(--pSnapshot->m_Pending > 0)
+				return;
 
-		if (GS()->GetPlayerFromUserID(UserID) != nullptr)
-		{
-			GS()->Chat(ClientID, "The account is already in the game.");
-			return AccountCodeResult::AOP_ALREADY_IN_GAME;
-		}
+			if(CAccountCore* pCore = GetLoginCore(*pSnapshot))
+				pCore->OnLoginChecked(pSnapshot);
+		};
+	};
+
+	Database->Prepare<DB::SELECT>("*", "tw_accounts_data", "WHERE Nick = '%s'", cClearNick.cstr())->AtExecute(Collect(&CLoginSnapshot::m_pAccount));
+	Database->Prepare<DB::SELECT>("ID, LoginDate, Language, Password, PasswordSalt", "tw_accounts",
+		"WHERE Username = '%s' AND ID IN (SELECT ID FROM tw_accounts_data WHERE Nick = '%s')", cClearLogin.cstr(), cClearNick.cstr())->AtExecute(Collect(&CLoginSnapshot::m_pCredentials));
+	Database->Prepare<DB::SELECT>("BannedUntil, Reason", "tw_accounts_bans",
+		"WHERE AccountId IN (SELECT ID FROM tw_accounts_data WHERE Nick = '%s') AND current_timestamp() < `BannedUntil`", cClearNick.cstr())->AtExecute(Collect(&CLoginSnapshot::m_pBan));
+
+	GS()->Broadcast(ClientID, BroadcastPriority::MAIN_INFORMATION, 100, "Loading account...");
+}
+
+void CAccountCore::OnLoginChecked(const std::shared_ptr<CLoginSnapshot>& pSnapshot)
+{
+	const int ClientID = pSnapshot->m_ClientID;
+	if(!GS()->GetPlayer(ClientID, false))
+	{
+		StopLoading(ClientID);
+		return;
+	}
+
+	ResultPtr& pResAccount = pSnapshot->m_pAccount;
+	if(!pResAccount->next())
+	{
+		StopLoading(ClientID);
+		GS()->Chat(ClientID, "Your nickname was not found in the Database.");
+		return;
+	}
 
-        ResultPtr pResBan = Database->Execute<DB::SELECT>("BannedUntil, Reason", "tw_accounts_bans", "WHERE AccountId = '%d' AND current_timestamp() < `BannedUntil`", UserID);
-        if(pResBan->next())
-        {
-            GS()->Chat(ClientID, "You account was suspended until \"{STR}\" with the reason of \"{STR}\"", pResBan->getString("BannedUntil").c_str(), pResBan->getString("Reason").c_str());
-            return AccountCodeResult::AOP_ACCOUNT_BANNED;
-        }
+	const int UserID = pResAccount->getInt("ID");
+	ResultPtr& pResCheck = pSnapshot->m_pCredentials;
+	bool LoginSuccess = false;
+	if(pResCheck->next() && pResCheck->getInt("ID") == UserID)
+	{
+		if(!str_comp(pResCheck->getString("Password").c_str(), HashPassword(pSnapshot->m_aPassword, pResCheck->getString("PasswordSalt").c_str()).c_str()))
+			LoginSuccess = true;
+	}
+	mem_zero(pSnapshot->m_aPassword, sizeof(pSnapshot->m_aPassword));
 
-		Server()->SetClientLanguage(ClientID, pResCheck->getString("Language").c_str());
-		str_copy(pPlayer->Acc().m_aLogin, cClearLogin.cstr(), sizeof(pPlayer->Acc().m_aLogin));
-		str_copy(pPlayer->Acc().m_aLastLogin, pResCheck->getString("LoginDate").c_str(), sizeof(pPlayer->Acc().m_aLastLogin));
+	if(!LoginSuccess)
+	{
+		StopLoading(ClientID);
+		GS()->Chat(ClientID, "Wrong login or password.");
+		return;
+	}
 
-		pPlayer->Acc().m_UserID = UserID;
-		pPlayer->Acc().m_Level = pResAccount->getInt("Level");
-		pPlayer->Acc().m_Exp = pResAccount->getInt("Exp");
-		pPlayer->Acc().m_GuildID = pResAccount->getInt("GuildID");
-		pPlayer->Acc().m_Upgrade = pResAccount->getInt("Upgrade");
-		pPlayer->Acc().m_GuildRank = pResAccount->getInt("GuildRank");
-		pPlayer->Acc().m_aHistoryWorld.push_front(pResAccount->getInt("WorldID"));
+	if(GS()->GetPlayerFromUserID(UserID) != nullptr)
+	{
+		StopLoading(ClientID);
+		GS()->Chat(ClientID, "The account is already in the game.");
+		return;
+	}
 
-		//pPlayer->Acc().SetHouse(CHouseCore::GetHouseByAccountID(UserID));
+	ResultPtr& pResBan = pSnapshot->m_pBan;
+	if(pResBan->next())
+	{
+		StopLoading(ClientID);
+		GS()->Chat(ClientID, "You account was suspended until \"{STR}\" with the reason of \"{STR}\"", pResBan->getString("BannedUntil").c_str(), pResBan->getString("Reason").c_str());
+		return;
+	}
 
-		for (const auto& [ID, pAttribute] : CAttributeDescription::Data())
+	// every component selects its rows of the account at the same time
+	const std::vector<const char*> apTables = Job()->GetAccountTables();
+	pSnapshot->m_UserID = UserID;
+	pSnapshot->m_Pending = (int)apTables.size();
+	pSnapshot->m_apComponents.resize(apTables.size());
+	for(size_t i = 0; i < apTables.size(); i++)
+	{
+		Database->Prepare<DB::SELECT>("*", apTables[i], "WHERE UserID = '%d'", UserID)->AtExecute([pSnapshot, i](ResultPtr pRes)
 		{
-			if(pAttribute->HasDatabaseField())
-				pPlayer->Acc().m_aStats[ID] = pResAccount->getInt(pAttribute->GetFieldName());
-		}
+			pSnapshot->m_apComponents[i] = std::move(pRes);
+			if(--pSnapshot->m_Pending > 0)
+				return;
+
+			if(CAccountCore* pCore = GetLoginCore(*pSnapshot))
+				pCore->OnLoginLoaded(pSnapshot);
+		});
+	}
+}
+
+void CAccountCore::OnLoginLoaded(const std::shared_ptr<CLoginSnapshot>& pSnapshot)
+{
+	const int ClientID = pSnapshot->m_ClientID;
+	const int UserID = pSnapshot->m_UserID;
+	StopLoading(ClientID);
+
+	CPlayer* pPlayer = GS()->GetPlayer(ClientID, false);
+	if(!pPlayer)
+		return;
+
+	// an other client could have logged in with this account in the meantime
+	if(GS()->GetPlayerFromUserID(UserID) != nullptr)
+	{
+		GS()->Chat(ClientID, "The account is already in the game.");
+		return;
+	}
+
+	ResultPtr& pResAccount = pSnapshot->m_pAccount;
+	ResultPtr& pResCheck = pSnapshot->m_pCredentials;
+	Server()->SetClientLanguage(ClientID, pResCheck->getString("Language").c_str());
+	str_copy(pPlayer->Acc().m_aLogin, pSnapshot->m_aLogin, sizeof(pPlayer->Acc().m_aLogin));
+	str_copy(pPlayer->Acc().m_aLastLogin, pResCheck->getString("LoginDate").c_str(), sizeof(pPlayer->Acc().m_aLastLogin));
+
+	pPlayer->Acc().m_UserID = UserID;
+	pPlayer->Acc().m_Level = pResAccount->getInt("Level");
+	pPlayer->Acc().m_Exp = pResAccount->getInt("Exp");
+	pPlayer->Acc().m_GuildID = pResAccount->getInt("GuildID");
+	pPlayer->Acc().m_Upgrade = pResAccount->getInt("Upgrade");
+	pPlayer->Acc().m_GuildRank = pResAccount->getInt("GuildRank");
+	pPlayer->Acc().m_aHistoryWorld.push_front(pResAccount->getInt("WorldID"));
 
-		GS()->Chat(ClientID, "- - - - - - - [Successful login!] - - - - - - -");
-		GS()->Chat(ClientID, "Don't forget that cl_motd_time must be set!");
-		GS()->Chat(ClientID, "Menu is available in call-votes!");
-		GS()->m_pController->DoTeamChange(pPlayer, false);
-		LoadAccount(pPlayer, true);
+	//pPlayer->Acc().SetHouse(CHouseCore::GetHouseByAccountID(UserID));
 
-		char aAddrStr[64];
-		Server()->GetClientAddr(ClientID, aAddrStr, sizeof(aAddrStr));
-		Database->Execute<DB::UPDATE>("tw_accounts", "LoginDate = CURRENT_TIMESTAMP, LoginIP = '%s' WHERE ID = '%d'", aAddrStr, UserID);
-		return AccountCodeResult::AOP_LOGIN_OK;
+	for (const auto& [ID, pAttribute] : CAttributeDescription::Data())
+	{
+		if(pAttribute->HasDatabaseField())
+			pPlayer->Acc().m_aStats[ID] = pResAccount->getInt(pAttribute->GetFieldName());
 	}
+	Job()->OnInitAccount(ClientID, pSnapshot->m_apComponents);
+	pPlayer->InvalidateAttributes();
+
+	GS()->Chat(ClientID, "- - - - - - - [Successful login!] - - - - - - -");
+	GS()->Chat(ClientID, "Don't forget that cl_motd_time must be set!");
+	GS()->Chat(ClientID, "Menu is available in call-votes!");
+	GS()->m_pController->DoTeamChange(pPlayer, false);
+	LoadAccount(pPlayer, true);
 
-	GS()->Chat(ClientID, "Your nickname was not found in the Database.");
-	return AccountCodeResult::AOP_NICKNAME_NOT_EXIST;
+	char aAddrStr[64];
+	Server()->GetClientAddr(ClientID, aAddrStr, sizeof(aAddrStr));
+	Database->Execute<DB::UPDATE>("tw_accounts", "LoginDate = CURRENT_TIMESTAMP, LoginIP = '%s' WHERE ID = '%d'", aAddrStr, UserID);
 }
 
 void CAccountCore::LoadAccount(CPlayer *pPlayer, bool FirstInitilize)
@@ -172,7 +310,6 @@ void CAccountCore::LoadAccount(CPlayer *pPlayer, bool FirstInitilize)
 		return;
 	}
 
-	Job()->OnInitAccount(ClientID);
 	const int Rank = GetRank(pPlayer->Acc().m_UserID);
 	GS()->Chat(-1, "{STR} logged to account. Rank #{INT}", Server()->ClientName(ClientID), Rank);
 #ifdef CONF_DISCORD
@@ -249,22 +386,14 @@ bool CAccountCore::ChangeNickname(int ClientID)
 		return false;
 
 	Database->Execute<DB::UPDATE>("tw_accounts_data", "Nick = '%s' WHERE ID = '%d'", cClearNick.cstr(), pPlayer->Acc().m_UserID);
+	CRankingCore::UpdateAccountName(pPlayer->Acc().m_UserID, cClearNick.cstr());
 	Server()->SetClientName(ClientID, Server()->GetClientNameChangeRequest(ClientID));
 	return true;
 }
 
 int CAccountCore::GetRank(int AccountID)
 {
-	int Rank = 0;
-	ResultPtr pRes = Database->Execute<DB::SELECT>("ID", "tw_accounts_data", "ORDER BY Level DESC, Exp DESC");
-	while(pRes->next())
-	{
-		Rank++;
-		const int ID = pRes->getInt("ID");
-		if(AccountID == ID)
-			return Rank;
-	}
-	return -1;
+	return CRankingCore::GetRank(ToplistType::PLAYERS_LEVELING, AccountID);
 }
 
 bool CAccountCore::OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool ReplaceMenu)
@@ -283,7 +412,7 @@ bool CAccountCore::OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool Replace
 		// game settings
 		GS()->AVH(ClientID, TAB_SETTINGS, "Some of the settings becomes valid after death");
 		GS()->AVM(ClientID, "MENU", MENU_SELECT_LANGUAGE, TAB_SETTINGS, "Settings language");
-		for(const auto& [ItemID, ItemData] : CPlayerItem::Data()[ClientID])
+		for(const auto& [ItemID, ItemData] : CPlayerItem::Data().Get(ClientID))
 		{
 			if(ItemData.Info()->IsType(ItemType::TYPE_SETTINGS) && ItemData.HasItem())
 				GS()->AVM(ClientID, "ISETTINGS", ItemID, TAB_SETTINGS, "[{STR}] {STR}", (ItemData.GetSettings() ? "Enabled" : "Disabled"), ItemData.Info()->GetName());
@@ -293,7 +422,7 @@ bool CAccountCore::OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool Replace
 		bool IsFoundModules = false;
 		GS()->AV(ClientID, "null");
 		GS()->AVH(ClientID, TAB_SETTINGS_MODULES, "Modules settings");
-		for (const auto& it : CPlayerItem::Data()[ClientID])
+		for (const auto& it : CPlayerItem::Data().Get(ClientID))
 		{
 			const CPlayerItem ItemData = it.second;
 			if (ItemData.Info()->IsType(ItemType::TYPE_MODULE) && ItemData.GetValue() > 0)
@@ -357,8 +486,10 @@ bool CAccountCore::OnHandleVoteCommands(CPlayer* pPlayer, const char* CMD, const
 
 void CAccountCore::OnResetClient(int ClientID)
 {
-	CAccountTempData::ms_aPlayerTempData.erase(ClientID);
-	CAccountData::ms_aData.erase(ClientID);
+	if(ClientID >= 0 && ClientID < MAX_PLAYERS)
+		StopLoading(ClientID);
+	CAccountTempData::ms_aPlayerTempData.Erase(ClientID);
+	CAccountData::ms_aData.Erase(ClientID);
 }
 
 std::string CAccountCore::HashPassword(const char* pPassword, const char* pSalt)
@@ -11,8 +11,8 @@ class CAccountCore : public MmoComponent
 {
 	~CAccountCore() override
 	{
-		CAccountData::ms_aData.clear();
-		CAccountTempData::ms_aPlayerTempData.clear();
+		CAccountData::ms_aData.Clear();
+		CAccountTempData::ms_aPlayerTempData.Clear();
 	};
 
 	bool OnHandleVoteCommands(CPlayer* pPlayer, const char* CMD, int VoteID, int VoteID2, int Get, const char* GetText) override;
@@ -27,9 +27,19 @@ class CAccountCore : public MmoComponent
         std::string reason;
     };
 
+	// the selects of a login, kept until the account is applied to the player
+	struct CLoginSnapshot;
+	static int ms_aLoginSequence[MAX_PLAYERS];
+	static int64 ms_aLoginStart[MAX_PLAYERS];
+
+	static CAccountCore* GetLoginCore(const CLoginSnapshot& Snapshot);
+	void StopLoading(int ClientID) const;
+	void OnLoginChecked(const std::shared_ptr<CLoginSnapshot>& pSnapshot);
+	void OnLoginLoaded(const std::shared_ptr<CLoginSnapshot>& pSnapshot);
+
 public:
 	AccountCodeResult RegisterAccount(int ClientID, const char *Login, const char *Password);
-	AccountCodeResult LoginAccount(int ClientID, const char *Login, const char *Password);
+	void LoginAccount(int ClientID, const char *Login, const char *Password);
 	void LoadAccount(CPlayer *pPlayer, bool FirstInitilize = false);
 	void DiscordConnect(int ClientID, const char *pDID) const;
 	bool ChangeNickname(int ClientID);
@@ -42,8 +52,9 @@ public:
 	static int GetRank(int AccountID);
 	static bool IsActive(int ClientID)
 	{
-		return CAccountData::ms_aData.find(ClientID) != CAccountData::ms_aData.end();
+		return CAccountData::ms_aData.Has(ClientID);
 	}
+	static bool IsLoading(int ClientID);
 
 	static std::string HashPassword(const char* pPassword, const char* pSalt);
 	void UseVoucher(int ClientID, const char* pVoucher) const;
@@ -4,8 +4,8 @@
 
 #include "game/server/mmocore/Components/Houses/HouseData.h"
 
-std::map < int, CAccountData > CAccountData::ms_aData;
-std::map < int, CAccountTempData > CAccountTempData::ms_aPlayerTempData;
+CClientDataMap < CAccountData > CAccountData::ms_aData;
+CClientDataMap < CAccountTempData > CAccountTempData::ms_aPlayerTempData;
 
 CHouseData* CAccountData::GetHouse() const
 {
@@ -45,7 +45,7 @@ struct CAccountData
 		{ CFieldData<int>(JOB_UPGRADES, "Upgrade", "Farmer upgrades") }
 	};
 
-	static std::map < int, CAccountData > ms_aData;
+	static CClientDataMap < CAccountData > ms_aData;
 };
 
 struct CAccountTempData
@@ -78,7 +78,7 @@ struct CAccountTempData
 	int m_TempTankVotingDungeon;
 	bool m_TempAlreadyVotedDungeon;
 
-	static std::map < int, CAccountTempData > ms_aPlayerTempData;
+	static CClientDataMap < CAccountTempData > ms_aPlayerTempData;
 };
 
 #endif
\ No newline at end of file
@@ -22,9 +22,8 @@ void CAccountMinerCore::OnInitWorld(const char* pWhereLocalWorld)
 	}
 }
 
-void CAccountMinerCore::OnInitAccount(CPlayer* pPlayer)
+void CAccountMinerCore::OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes)
 {
-	ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_accounts_mining", "WHERE UserID = '%d'", pPlayer->Acc().m_UserID);
 	if (pRes->next())
 	{
 		pPlayer->Acc().m_MiningData.initFields(&pRes);
@@ -22,7 +22,8 @@ class CAccountMinerCore : public MmoComponent
 	};
 	static std::map < int, StructOres > ms_aOre;
 
-	void OnInitAccount(CPlayer* pPlayer) override;
+	const char* GetAccountTable() const override { return "tw_accounts_mining"; }
+	void OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes) override;
 	void OnInitWorld(const char* pWhereLocalWorld) override;
 	bool OnHandleVoteCommands(CPlayer* pPlayer, const char* CMD, int VoteID, int VoteID2, int Get, const char* GetText) override;
 
@@ -24,9 +24,8 @@ void CAccountPlantCore::OnInitWorld(const char* pWhereLocalWorld)
 	}
 }
 
-void CAccountPlantCore::OnInitAccount(CPlayer *pPlayer)
+void CAccountPlantCore::OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes)
 {
-	ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_accounts_farming", "WHERE UserID = '%d'", pPlayer->Acc().m_UserID);
 	if(pRes->next())
 	{
 		pPlayer->Acc().m_FarmingData.initFields(&pRes);
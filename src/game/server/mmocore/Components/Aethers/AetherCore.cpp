@@ -25,9 +25,8 @@ void CAetherCore::OnInit()
 	});
 }
 
-void CAetherCore::OnInitAccount(CPlayer *pPlayer)
+void CAetherCore::OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes)
 {
-	ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_accounts_aethers", "WHERE UserID = '%d'", pPlayer->Acc().m_UserID);
 	while(pRes->next())
 	{
 		const int TeleportID = pRes->getInt("AetherID");
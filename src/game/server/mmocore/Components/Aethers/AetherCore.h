@@ -14,7 +14,8 @@ class CAetherCore : public MmoComponent
 	};
 
 	void OnInit() override;
-	void OnInitAccount(CPlayer* pPlayer) override;
+	const char* GetAccountTable() const override { return "tw_accounts_aethers"; }
+	void OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes) override;
 	bool OnHandleTile(CCharacter* pChr, int IndexCollision) override;
 	bool OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool ReplaceMenu) override;
 	bool OnHandleVoteCommands(CPlayer* pPlayer, const char* CMD, int VoteID, int VoteID2, int Get, const char* GetText) override;
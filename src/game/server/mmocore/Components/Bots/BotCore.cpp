@@ -112,6 +112,12 @@ void CBotCore::InitQuestBots(const char* pWhereLocalWorld)
 		QuestBot.m_InteractiveType = pRes->getInt("InteractionType");
 		QuestBot.m_InteractiveTemp = pRes->getInt("InteractionTemp");
 		QuestBot.m_EventJsonData = pRes->getString("EventData").c_str();
+		JsonTools::parseFromString(QuestBot.m_EventJsonData, [](nlohmann::json& pJson)
+		{
+			// the effect of the dialog events is given by name later
+			if(pJson.find("effect") != pJson.end())
+				CEffects::Register(pJson["effect"].value("name", "").c_str());
+		});
 		sscanf(pRes->getString("Amount").c_str(), "|%d|%d|%d|%d|%d|%d|",
 			&QuestBot.m_aItemSearchValue[0], &QuestBot.m_aItemSearchValue[1], &QuestBot.m_aItemGivesValue[0], &QuestBot.m_aItemGivesValue[1], &QuestBot.m_aNeedMobValue[0], &QuestBot.m_aNeedMobValue[1]);
 
@@ -177,7 +183,7 @@ void CBotCore::InitMobsBots(const char* pWhereLocalWorld)
 		MobBot.m_Level = pRes->getInt("Level");
 		MobBot.m_RespawnTick = pRes->getInt("Respawn");
 		MobBot.m_BotID = BotID;
-		str_copy(MobBot.m_aBehavior, pRes->getString("Behavior").c_str(), sizeof(MobBot.m_aBehavior));
+		MobBot.InitBehavior(pRes->getString("Behavior").c_str());
 		std::string BuffDebuff = pRes->getString("Effect").c_str();
 		MobBot.InitBuffDebuff(4, 4, 3.0f, BuffDebuff);
 
@@ -7,6 +7,15 @@ std::map< int, NpcBotInfo > NpcBotInfo::ms_aNpcBot;
 std::map< int, QuestBotInfo > QuestBotInfo::ms_aQuestBot;
 std::map< int, MobBotInfo > MobBotInfo::ms_aMobBot;
 
+void MobBotInfo::InitBehavior(const char* pBehavior)
+{
+	m_BehaviorFlags = 0;
+	if(str_find(pBehavior, "Sleepy"))
+		m_BehaviorFlags |= MOBBEHAVIOR_SLEEPY;
+	if(str_find(pBehavior, "Slower"))
+		m_BehaviorFlags |= MOBBEHAVIOR_SLOWER;
+}
+
 void MobBotInfo::InitBuffDebuff(int Seconds, int Range, float Chance, std::string& buffSets)
 {
 	if(!buffSets.empty())
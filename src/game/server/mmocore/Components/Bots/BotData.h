@@ -75,15 +75,21 @@ public:
 /*  Global data mob bot                                                 */
 /************************************************************************/
 
+enum
+{
+	MOBBEHAVIOR_SLEEPY = 1 << 0,
+	MOBBEHAVIOR_SLOWER = 1 << 1,
+};
+
 class CMobBuffDebuff
 {
 	float m_Chance{};
-	std::string m_Effect{};
+	int m_EffectID{};
 	std::tuple<int, int> m_Time{};
 
 public:
 	CMobBuffDebuff() = default;
-	CMobBuffDebuff(float Chance, std::string Effect, std::tuple<int, int> Time) : m_Chance(Chance), m_Effect(Effect), m_Time(Time) {}
+	CMobBuffDebuff(float Chance, const std::string& Effect, std::tuple<int, int> Time) : m_Chance(Chance), m_EffectID(CEffects::Register(Effect.c_str())), m_Time(Time) {}
 
 	enum
 	{
@@ -91,7 +97,8 @@ public:
 		RANGE
 	};
 
-	const char* getEffect() const { return m_Effect.c_str(); }
+	const char* getEffect() const { return CEffects::Name(m_EffectID); }
+	int getEffectID() const { return m_EffectID; }
 	int getTime() const
 	{
 		int Range = std::get<RANGE>(m_Time);
@@ -104,7 +111,7 @@ public:
 class MobBotInfo
 {
 	friend class CBotCore;
-	char m_aBehavior[512] {};
+	int m_BehaviorFlags{};
 
 	std::deque < CMobBuffDebuff > m_Effects;
 
@@ -124,7 +131,8 @@ public:
 	std::deque < CMobBuffDebuff >& GetEffects() { return m_Effects; }
 	[[nodiscard]] CMobBuffDebuff* GetRandomEffect() { return m_Effects.empty() ? nullptr : &m_Effects[random_int() % m_Effects.size()]; }
 
-	bool IsEnabledBehavior(const char* pBehavior) const { return str_find(m_aBehavior, pBehavior) != nullptr; }
+	bool IsEnabledBehavior(int Flag) const { return (m_BehaviorFlags & Flag) != 0; }
+	void InitBehavior(const char* pBehavior);
 	void InitBuffDebuff(int Seconds, int Range, float Chance, std::string& buffSets);
 
 	const char* GetName() const { return DataBotInfo::ms_aDataBot[m_BotID].m_aNameBot; }
@@ -302,7 +302,7 @@ void CPlayerDialog::FormatText(CDialogElem* pDialog, const char* pLeftNickname,
 	 */
 	char aBufText[1024]{};
 	{
-		str_copy(aBufText, GS()->Server()->Localization()->Localize(m_pPlayer->GetLanguage(), pDialog->GetText()), sizeof(aBufText));
+		str_copy(aBufText, GS()->Server()->Localization()->Localize(m_pPlayer->GetLanguageID(), pDialog->GetText()), sizeof(aBufText));
 
 		// arrays replacing dialogs
 		char aBufSearch[16];
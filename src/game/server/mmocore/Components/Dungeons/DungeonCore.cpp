@@ -142,7 +142,7 @@ bool DungeonCore::OnHandleVoteCommands(CPlayer* pPlayer, const char* CMD, const
 bool DungeonCore::IsDungeonWorld(int WorldID)
 {
 	return std::find_if(CDungeonData::ms_aDungeon.begin(), CDungeonData::ms_aDungeon.end(),
-	                    [WorldID](const std::pair<int, CDungeonData>& pDungeon) { return pDungeon.second.m_WorldID == WorldID; }) != CDungeonData::ms_aDungeon.end();
+	                    [WorldID](const auto& pDungeon) { return pDungeon.second.m_WorldID == WorldID; }) != CDungeonData::ms_aDungeon.end();
 }
 
 void DungeonCore::SaveDungeonRecord(CPlayer* pPlayer, int DungeonID, CPlayerDungeonRecord *pPlayerDungeonRecord)
@@ -188,7 +188,7 @@ void DungeonCore::ShowDungeonsList(CPlayer* pPlayer, bool Story) const
 
 		const int HideID = 7500 + dungeon.first;
 		GS()->AVH(ClientID, HideID, "Lvl{INT} {STR} : Players {INT} : {STR} [{INT}%]",
-			dungeon.second.m_Level, dungeon.second.m_aName, dungeon.second.m_Players, (dungeon.second.IsDungeonPlaying() ? "Active dungeon" : "Waiting players"), dungeon.second.m_Progress);
+			dungeon.second.m_Level, dungeon.second.m_aName, dungeon.second.m_Players.load(), (dungeon.second.IsDungeonPlaying() ? "Active dungeon" : "Waiting players"), dungeon.second.m_Progress.load());
 
 		ShowDungeonTop(pPlayer, dungeon.first, HideID);
 
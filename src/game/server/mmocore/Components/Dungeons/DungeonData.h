@@ -3,6 +3,8 @@
 #ifndef GAME_SERVER_COMPONENT_DUNGEON_DATA_H
 #define GAME_SERVER_COMPONENT_DUNGEON_DATA_H
 
+#include <atomic>
+
 struct CPlayerDungeonRecord
 {
 	CPlayerDungeonRecord()
@@ -27,11 +29,13 @@ struct CDungeonData
 	int m_DoorX;
 	int m_DoorY;
 	int m_WorldID;
-	int m_Players;
-	int m_Progress;
-	int m_State;
 	bool m_IsStory;
 
+	// written by the dungeon world while the others read them
+	std::atomic<int> m_Players{0};
+	std::atomic<int> m_Progress{0};
+	std::atomic<int> m_State{0};
+
 	bool IsDungeonPlaying() const { return m_State > 1; }
 
 	static std::map< int, CDungeonData > ms_aDungeon;
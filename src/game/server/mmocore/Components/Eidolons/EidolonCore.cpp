@@ -42,7 +42,7 @@ bool CEidolonCore::OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool Replace
 		{
 			CPlayerItem* pPlayerItem = pPlayer->GetItem(pEidolon.GetItemID());
 			const char* pCollectedInfo = (pPlayerItem->HasItem() ? "✔" : "\0");
-			const char* pUsedAtMoment = pPlayerItem->IsEquipped() ? Server()->Localization()->Localize(pPlayer->GetLanguage(), "[summoned by you]") : "\0";
+			const char* pUsedAtMoment = pPlayerItem->IsEquipped() ? Server()->Localization()->Localize(pPlayer->GetLanguageID(), "[summoned by you]") : "\0";
 			GS()->AVM(ClientID, "EIDOLON_SELECT", pEidolon.GetItemID(), TAB_EIDOLONS, "{STR} {STR} {STR}", pEidolon.GetDataBot()->m_aNameBot, pCollectedInfo, pUsedAtMoment);
 		}
 
@@ -71,7 +71,7 @@ bool CEidolonCore::OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool Replace
 
 			if(pPlayerItem->HasItem())
 			{
-				const char* pStateSummon = Server()->Localization()->Localize(pPlayer->GetLanguage(), pPlayerItem->IsEquipped() ? "Call off the summoned" : "Summon");
+				const char* pStateSummon = Server()->Localization()->Localize(pPlayer->GetLanguageID(), pPlayerItem->IsEquipped() ? "Call off the summoned" : "Summon");
 				GS()->AVM(ClientID, "ISETTINGS", pEidolonInfo->GetItemID(), NOPE, "{STR} {STR}", pStateSummon, pEidolonInfo->GetDataBot()->m_aNameBot);
 			}
 			else
@@ -89,9 +89,9 @@ std::pair<int, int> CEidolonCore::GetEidolonsSize(int ClientID) const
 	int Collect = 0;
 	int Max = static_cast<int>(CEidolonInfoData::Data().size());
 
-	if(CPlayerItem::Data().find(ClientID) != CPlayerItem::Data().end())
+	if(const auto* paItems = CPlayerItem::Data().Find(ClientID))
 	{
-		for(auto& p : CPlayerItem::Data()[ClientID])
+		for(auto& p : *paItems)
 		{
 			if(p.second.HasItem() && p.second.Info()->IsType(ItemType::TYPE_EQUIP) && p.second.Info()->IsFunctional(
 				EQUIP_EIDOLON))
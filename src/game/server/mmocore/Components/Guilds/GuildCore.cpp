@@ -6,9 +6,11 @@
 #include <game/server/gamecontext.h>
 
 #include <game/server/mmocore/GameEntities/decoration_houses.h>
+#include <game/server/mmocore/GameEntities/loltext.h>
 #include "Entities/GuildDoor.h"
 
 #include <game/server/mmocore/Components/Inventory/InventoryCore.h>
+#include <game/server/mmocore/Components/Rankings/RankingCore.h>
 
 #include <cstdarg>
 
@@ -68,7 +70,7 @@ void GuildCore::OnInitWorld(const char* pWhereLocalWorld)
 			if (CGuildHouseData::ms_aHouseGuild[HouseID].m_GuildID > 0 && !CGuildHouseData::ms_aHouseGuild[HouseID].m_pDoor)
 			{
 				CGuildHouseData::ms_aHouseGuild[HouseID].m_pDoor = 0;
-				CGuildHouseData::ms_aHouseGuild[HouseID].m_pDoor = new GuildDoor(&GS()->m_World, vec2(CGuildHouseData::ms_aHouseGuild[HouseID].m_DoorX, CGuildHouseData::ms_aHouseGuild[HouseID].m_DoorY), CGuildHouseData::ms_aHouseGuild[HouseID].m_GuildID);
+				CGuildHouseData::ms_aHouseGuild[HouseID].m_pDoor = new(&GS()->m_World) GuildDoor(&GS()->m_World, vec2(CGuildHouseData::ms_aHouseGuild[HouseID].m_DoorX, CGuildHouseData::ms_aHouseGuild[HouseID].m_DoorY), CGuildHouseData::ms_aHouseGuild[HouseID].m_GuildID);
 			}
 		}
 		Job()->ShowLoadingProgress("Houses", CGuildHouseData::ms_aHouseGuild.size());
@@ -80,7 +82,7 @@ void GuildCore::OnInitWorld(const char* pWhereLocalWorld)
 		while (pRes->next())
 		{
 			const int ID = pRes->getInt("ID");
-			m_DecorationHouse[ID] = new CDecorationHouses(&GS()->m_World, vec2(pRes->getInt("PosX"), pRes->getInt("PosY")), pRes->getInt("HouseID"), ID, pRes->getInt("ItemID"));
+			m_DecorationHouse[ID] = new(&GS()->m_World) CDecorationHouses(&GS()->m_World, vec2(pRes->getInt("PosX"), pRes->getInt("PosY")), pRes->getInt("HouseID"), ID, pRes->getInt("ItemID"));
 		}
 		Job()->ShowLoadingProgress("Guilds Houses Decorations", m_DecorationHouse.size());
 	});
@@ -125,8 +127,9 @@ bool GuildCore::OnHandleTile(CCharacter* pChr, int IndexCollision)
 			if(HouseID <= 0 || GuildID <= 0)
 				return true;
 
-			const int Exp = CGuildData::ms_aGuild[GuildID].m_UpgradeData(CGuildData::CHAIR_EXPERIENCE, 0).m_Value;
-			pPlayer->AddExp(Exp);
+			const int Exp = GetMemberChairBonus(GuildID, CGuildData::CHAIR_EXPERIENCE);
+			if(Exp > 0)
+				pPlayer->AddExp(Exp);
 		}
 		return true;
 	}
@@ -624,14 +627,19 @@ void GuildCore::TickHousingText()
 	if (Server()->Tick() % (Server()->TickSpeed() * 2) != 0)
 		return;
 
+	// the texts stay in the world and only change when the owner changes
 	for (const auto& [ID, House] : CGuildHouseData::ms_aHouseGuild)
 	{
-		if (House.m_WorldID == GS()->GetWorldID())
-		{
-			const int LifeTime = (Server()->TickSpeed() * 2) - 5;
-			const int GuildID = House.m_GuildID;
-			GS()->CreateText(nullptr, false, vec2(House.m_TextX, House.m_TextY), vec2(0, 0), LifeTime, (GuildID > 0 ? GuildName(GuildID) : "GUILD HOUSE"));
-		}
+		if (House.m_WorldID != GS()->GetWorldID())
+			continue;
+
+		const int GuildID = House.m_GuildID;
+		const char* pText = GuildID > 0 ? GuildName(GuildID) : "GUILD HOUSE";
+		const auto Iter = m_HouseText.find(ID);
+		if (Iter == m_HouseText.end())
+			m_HouseText[ID] = new(&GS()->m_World) CLoltext(&GS()->m_World, nullptr, vec2(House.m_TextX, House.m_TextY), vec2(0, 0), -1, pText, false);
+		else
+			Iter->second->SetText(pText);
 	}
 }
 
@@ -703,7 +711,7 @@ bool GuildCore::AddDecorationHouse(int ItemID, int GuildID, vec2 Position)
 	int InitID = (pRes2->next() ? pRes2->getInt("ID") + 1 : 1);
 	Database->Execute<DB::INSERT>("tw_guilds_decorations", "(ID, ItemID, HouseID, PosX, PosY, WorldID) VALUES ('%d', '%d', '%d', '%d', '%d', '%d')",
 		InitID, ItemID, HouseID, (int)Position.x, (int)Position.y, GS()->GetWorldID());
-	m_DecorationHouse[InitID] = new CDecorationHouses(&GS()->m_World, Position, HouseID, InitID, ItemID);
+	m_DecorationHouse[InitID] = new(&GS()->m_World) CDecorationHouses(&GS()->m_World, Position, HouseID, InitID, ItemID);
 	return true;
 }
 
@@ -783,6 +791,9 @@ void GuildCore::CreateGuild(CPlayer *pPlayer, const char *pGuildName)
 
 	// we create a guild in the table
 	Database->Execute<DB::INSERT>("tw_guilds", "(ID, Name, UserID) VALUES ('%d', '%s', '%d')", InitID, GuildName.cstr(), pPlayer->Acc().m_UserID);
+	CRankingCore::UpdateGuildName(InitID, GuildName.cstr());
+	CRankingCore::UpdateGuildLevel(InitID, 1, 0);
+	CRankingCore::UpdateGuildBank(InitID, 0);
 	Database->Execute<DB::UPDATE, 1000>("tw_accounts_data", "GuildID = '%d' WHERE ID = '%d'", InitID, pPlayer->Acc().m_UserID);
 	GS()->Chat(-1, "New guilds [{STR}] have been created!", GuildName.cstr());
 	GS()->StrongUpdateVotes(ClientID, MENU_MAIN);
@@ -806,6 +817,7 @@ void GuildCore::DisbandGuild(int GuildID)
 
 	GS()->SendInbox("System", LeaderUID, "Your guild was disbanded.", "We returned some gold from your guild.", itGold, ReturnsGold);
 	Database->Execute<DB::REMOVE>("tw_guilds", "WHERE ID = '%d'", GuildID);
+	CRankingCore::RemoveGuild(GuildID);
 	GS()->Chat(-1, "The {STR} Guild has been disbanded.", CGuildData::ms_aGuild[GuildID].m_aName);
 
 	// clear guild data
@@ -996,6 +1008,16 @@ void GuildCore::ShowGuildPlayers(CPlayer* pPlayer, int GuildID)
 }
 
 void GuildCore::AddExperience(int GuildID)
+{
+	// the guilds are shared by all worlds, count the experience after the world stage
+	Server()->ExecuteCrossWorld([this, GuildID]()
+	{
+		if(CGuildData::ms_aGuild.find(GuildID) != CGuildData::ms_aGuild.end())
+			AddExperienceImpl(GuildID);
+	});
+}
+
+void GuildCore::AddExperienceImpl(int GuildID)
 {
 	CGuildData::ms_aGuild[GuildID].m_Exp += 1;
 
@@ -1015,6 +1037,7 @@ void GuildCore::AddExperience(int GuildID)
 		AddHistoryGuild(GuildID, "Guild raised level to '%d'.", CGuildData::ms_aGuild[GuildID].m_Level);
 	}
 
+	CRankingCore::UpdateGuildLevel(GuildID, CGuildData::ms_aGuild[GuildID].m_Level, CGuildData::ms_aGuild[GuildID].m_Exp);
 	if(random_int()%10 == 2 || UpdateTable)
 		Database->Execute<DB::UPDATE>("tw_guilds", "Level = '%d', Experience = '%d' WHERE ID = '%d'", CGuildData::ms_aGuild[GuildID].m_Level, CGuildData::ms_aGuild[GuildID].m_Exp, GuildID);
 }
@@ -1028,6 +1051,7 @@ bool GuildCore::AddMoneyBank(int GuildID, int Money)
 	// add money
 	CGuildData::ms_aGuild[GuildID].m_Bank = pRes->getInt("Bank") + Money;
 	Database->Execute<DB::UPDATE>("tw_guilds", "Bank = '%d' WHERE ID = '%d'", CGuildData::ms_aGuild[GuildID].m_Bank, GuildID);
+	CRankingCore::UpdateGuildBank(GuildID, CGuildData::ms_aGuild[GuildID].m_Bank);
 	return true;
 }
 
@@ -1045,6 +1069,7 @@ bool GuildCore::RemoveMoneyBank(int GuildID, int Money)
 	// payment
 	CGuildData::ms_aGuild[GuildID].m_Bank -= Money;
 	Database->Execute<DB::UPDATE>("tw_guilds", "Bank = '%d' WHERE ID = '%d'", CGuildData::ms_aGuild[GuildID].m_Bank, GuildID);
+	CRankingCore::UpdateGuildBank(GuildID, CGuildData::ms_aGuild[GuildID].m_Bank);
 	return true;
 }
 
@@ -1066,6 +1091,7 @@ bool GuildCore::UpgradeGuild(int GuildID, int Field)
 		CGuildData::ms_aGuild[GuildID].m_UpgradeData(Field, 0).m_Value++;
 		CGuildData::ms_aGuild[GuildID].m_Bank -= PriceAvailable;
 		Database->Execute<DB::UPDATE>("tw_guilds", "Bank = '%d', %s = '%d' WHERE ID = '%d'", CGuildData::ms_aGuild[GuildID].m_Bank, pFieldName, CGuildData::ms_aGuild[GuildID].m_UpgradeData(Field, 0).m_Value, GuildID);
+		CRankingCore::UpdateGuildBank(GuildID, CGuildData::ms_aGuild[GuildID].m_Bank);
 		return true;
 	}
 	return false;
@@ -1422,6 +1448,7 @@ void GuildCore::BuyGuildHouse(int GuildID, int HouseID)
 		}
 		CGuildData::ms_aGuild[GuildID].m_Bank -= Price;
 		Database->Execute<DB::UPDATE>("tw_guilds", "Bank = '%d' WHERE ID = '%d'", CGuildData::ms_aGuild[GuildID].m_Bank, GuildID);
+		CRankingCore::UpdateGuildBank(GuildID, CGuildData::ms_aGuild[GuildID].m_Bank);
 
 		CGuildHouseData::ms_aHouseGuild[HouseID].m_GuildID = GuildID;
 		Database->Execute<DB::UPDATE>("tw_guilds_houses", "GuildID = '%d' WHERE ID = '%d'", GuildID, HouseID);
@@ -1515,7 +1542,7 @@ bool GuildCore::ChangeStateDoor(int GuildID)
 		CGuildHouseData::ms_aHouseGuild[HouseID].m_pDoor = 0;
 	}
 	else
-		CGuildHouseData::ms_aHouseGuild[HouseID].m_pDoor = new GuildDoor(&GS()->m_World, vec2(CGuildHouseData::ms_aHouseGuild[HouseID].m_DoorX, CGuildHouseData::ms_aHouseGuild[HouseID].m_DoorY), GuildID);
+		CGuildHouseData::ms_aHouseGuild[HouseID].m_pDoor = new(&GS()->m_World) GuildDoor(&GS()->m_World, vec2(CGuildHouseData::ms_aHouseGuild[HouseID].m_DoorX, CGuildHouseData::ms_aHouseGuild[HouseID].m_DoorY), GuildID);
 
 	const bool StateDoor = (bool)(CGuildHouseData::ms_aHouseGuild[HouseID].m_pDoor);
 	GS()->ChatGuild(GuildID, "{STR} the house for others.", (StateDoor ? "closed" : "opened"));
@@ -8,6 +8,7 @@
 
 class GuildDoor;
 class CDecorationHouses;
+class CLoltext;
 class GuildCore : public MmoComponent
 {
 	~GuildCore() override
@@ -18,6 +19,7 @@ class GuildCore : public MmoComponent
 	};
 
 	std::map < int, CDecorationHouses* > m_DecorationHouse;
+	std::map < int, CLoltext* > m_HouseText;
 
 	void OnInit() override;
 	void OnInitWorld(const char* pWhereLocalWorld) override;
@@ -55,6 +57,7 @@ public:
 	bool AddDecorationHouse(int ItemID, int GuildID, vec2 Position);
 
 private:
+	void AddExperienceImpl(int GuildID);
 	bool DeleteDecorationHouse(int ID);
 	void ShowDecorationList(CPlayer* pPlayer);
 
@@ -35,7 +35,7 @@ void CHouseData::InitDecorations()
 				int DecorationID = pRes->getInt("ID");
 				int ItemID = pRes->getInt("ItemID");
 				vec2 DecorationPos = vec2(pRes->getInt("PosX"), pRes->getInt("PosY"));
-				m_apDecorations[i] = new CDecorationHouses(&GS()->m_World, DecorationPos, m_ID, DecorationID, ItemID);
+				m_apDecorations[i] = new(&GS()->m_World) CDecorationHouses(&GS()->m_World, DecorationPos, m_ID, DecorationID, ItemID);
 				break;
 			}
 		}
@@ -62,7 +62,7 @@ bool CHouseData::AddDecoration(ItemIdentifier ItemID, vec2 DecorationPos)
 			Database->Execute<DB::INSERT>("tw_houses_decorations", "(ID, ItemID, HouseID, PosX, PosY, WorldID) VALUES ('%d', '%d', '%d', '%d', '%d', '%d')", InitID, ItemID, m_ID, (int)DecorationPos.x, (int)DecorationPos.y, GS()->GetWorldID());
 
 			// create new decoration on gameworld
-			m_apDecorations[i] = new CDecorationHouses(&GS()->m_World, DecorationPos, m_AccountID, InitID, ItemID);
+			m_apDecorations[i] = new(&GS()->m_World) CDecorationHouses(&GS()->m_World, DecorationPos, m_AccountID, InitID, ItemID);
 			return true;
 		}
 	}
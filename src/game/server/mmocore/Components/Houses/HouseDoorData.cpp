@@ -39,7 +39,7 @@ void CHouseDoorData::Open()
 void CHouseDoorData::Close()
 {
 	if(!m_pDoor)
-		m_pDoor = new HouseDoor(&m_pGS->m_World, m_Pos, this);
+		m_pDoor = new(&m_pGS->m_World) HouseDoor(&m_pGS->m_World, m_Pos, this);
 }
 
 void CHouseDoorData::Reverse()
@@ -2,11 +2,13 @@
 /* If you are missing that file, acquire a complete release at teeworlds.com.                */
 #include "InventoryCore.h"
 
+#include <engine/shared/config.h>
 #include <engine/shared/datafile.h>
 #include <game/server/gamecontext.h>
 
 #include <game/server/mmocore/Components/Houses/HouseCore.h>
 #include <game/server/mmocore/Components/Quests/QuestCore.h>
+#include <game/server/mmocore/Components/Rankings/RankingCore.h>
 
 template < typename T >
 bool ExecuteTemplateItemsTypes(T Type, std::map < int, CPlayerItem >& paItems, const std::function<void(const CPlayerItem&)> pFunc)
@@ -78,10 +80,9 @@ void CInventoryCore::OnInit()
 	});
 }
 
-void CInventoryCore::OnInitAccount(CPlayer *pPlayer)
+void CInventoryCore::OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes)
 {
 	const int ClientID = pPlayer->GetCID();
-	ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_accounts_items", "WHERE UserID = '%d'", pPlayer->Acc().m_UserID);
 	while(pRes->next())
 	{
 		ItemIdentifier ItemID = pRes->getInt("ItemID");
@@ -96,7 +97,8 @@ void CInventoryCore::OnInitAccount(CPlayer *pPlayer)
 
 void CInventoryCore::OnResetClient(int ClientID)
 {
-	CPlayerItem::Data().erase(ClientID);
+	SaveDirtyItems(ClientID);
+	CPlayerItem::Data().Erase(ClientID);
 }
 
 bool CInventoryCore::OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool ReplaceMenu)
@@ -273,7 +275,7 @@ void CInventoryCore::RepairDurabilityItems(CPlayer *pPlayer)
 {
 	const int ClientID = pPlayer->GetCID();
 	Database->Execute<DB::UPDATE>("tw_accounts_items", "Durability = '100' WHERE UserID = '%d'", pPlayer->Acc().m_UserID);
-	for(auto& [ID, Item] : CPlayerItem::Data()[ClientID])
+	for(auto& [ID, Item] : CPlayerItem::Data().Get(ClientID))
 		Item.m_Durability = 100;
 }
 
@@ -282,7 +284,7 @@ void CInventoryCore::ListInventory(int ClientID, ItemType Type)
 	if(Type >= ItemType::TYPE_USED && Type < ItemType::NUM_TYPES)
 	{
 		GS()->AV(ClientID, "null");
-		if(!ExecuteTemplateItemsTypes(Type, CPlayerItem::Data()[ClientID], [&](const CPlayerItem& pItem){ ItemSelected(GS()->m_apPlayers[ClientID], pItem); }))
+		if(!ExecuteTemplateItemsTypes(Type, CPlayerItem::Data().Get(ClientID), [&](const CPlayerItem& pItem){ ItemSelected(GS()->m_apPlayers[ClientID], pItem); }))
 			GS()->AVL(ClientID, "null", "There are no items in this tab");
 	}
 }
@@ -290,7 +292,7 @@ void CInventoryCore::ListInventory(int ClientID, ItemType Type)
 void CInventoryCore::ListInventory(int ClientID, ItemFunctional Type)
 {
 	GS()->AV(ClientID, "null");
-	if(!ExecuteTemplateItemsTypes(Type, CPlayerItem::Data()[ClientID], [&](const CPlayerItem& pItem){ ItemSelected(GS()->m_apPlayers[ClientID], pItem); }))
+	if(!ExecuteTemplateItemsTypes(Type, CPlayerItem::Data().Get(ClientID), [&](const CPlayerItem& pItem){ ItemSelected(GS()->m_apPlayers[ClientID], pItem); }))
 		GS()->AVL(ClientID, "null", "There are no items in this tab");
 }
 
@@ -395,40 +397,143 @@ void CInventoryCore::ItemSelected(CPlayer* pPlayer, const CPlayerItem& pItemPlay
 int CInventoryCore::GetCountItemsType(CPlayer *pPlayer, ItemType Type) const
 {
 	const int ClientID = pPlayer->GetCID();
-	return (int)std::count_if(CPlayerItem::Data()[ClientID].begin(), CPlayerItem::Data()[ClientID].end(), [Type](auto& pItem)
+	return (int)std::count_if(CPlayerItem::Data().Get(ClientID).begin(), CPlayerItem::Data().Get(ClientID).end(), [Type](auto& pItem)
 	{
 		return pItem.second.HasItem() && pItem.second.Info()->IsType(Type);
 	});
 }
 
-// TODO: FIX IT (lock .. unlock)
-std::mutex lock_sleep;
 void CInventoryCore::AddItemSleep(int AccountID, ItemIdentifier ItemID, int Value, int Milliseconds)
 {
-	std::thread Thread([this, AccountID, ItemID, Value, Milliseconds]()
+	// worlds running in parallel may give items at the same time
+	std::lock_guard<std::mutex> Lock(ms_SleepItemsLock);
+	const int Tick = Server()->Tick() + max(Milliseconds * Server()->TickSpeed() / 1000, 1);
+	ms_aSleepItems.push_back({ AccountID, ItemID, Value, Tick });
+}
+
+void CInventoryCore::TickSleepItems()
+{
+	std::vector<CSleepItem> aReady;
 	{
-		if(Milliseconds > 0)
-			std::this_thread::sleep_for(std::chrono::milliseconds(Milliseconds));
+		std::lock_guard<std::mutex> Lock(ms_SleepItemsLock);
+		for(auto Iter = ms_aSleepItems.begin(); Iter != ms_aSleepItems.end();)
+		{
+			if(Iter->m_Tick > Server()->Tick())
+			{
+				++Iter;
+				continue;
+			}
+			aReady.push_back(*Iter);
+			Iter = ms_aSleepItems.erase(Iter);
+		}
+	}
 
-		lock_sleep.lock();
-		CPlayer* pPlayer = GS()->GetPlayerFromUserID(AccountID);
+	for(const CSleepItem& Item : aReady)
+	{
+		CPlayer* pPlayer = GS()->GetPlayerFromUserID(Item.m_AccountID);
 		if(pPlayer)
 		{
-			pPlayer->GetItem(ItemID)->Add(Value);
-			lock_sleep.unlock();
-			return;
+			pPlayer->GetItem(Item.m_ItemID)->Add(Item.m_Value);
+			continue;
 		}
 
-		ResultPtr pRes = Database->Execute<DB::SELECT>("Value", "tw_accounts_items", "WHERE ItemID = '%d' AND UserID = '%d'", ItemID, AccountID);
-		if(pRes->next())
+		// the player left, the row is changed behind the last write of the items
+		Database->ExecuteBind<DB::INSERT>("tw_accounts_items", "(ItemID, UserID, Value, Settings, Enchant) VALUES (?, ?, ?, 0, 0) ON DUPLICATE KEY UPDATE Value = Value + VALUES(Value)",
+			Item.m_ItemID, Item.m_AccountID, Item.m_Value);
+		if(Item.m_ItemID == itGold)
 		{
-			const int ReallyValue = pRes->getInt("Value") + Value;
-			Database->Execute<DB::UPDATE>("tw_accounts_items", "Value = '%d' WHERE UserID = '%d' AND ItemID = '%d'", ReallyValue, AccountID, ItemID);
-			lock_sleep.unlock();
-			return;
+			const int AccountID = Item.m_AccountID;
+			Database->Prepare<DB::SELECT>("Value", "tw_accounts_items", "WHERE ItemID = '%d' AND UserID = '%d'", (int)itGold, AccountID)->AtExecute([AccountID](ResultPtr pRes)
+			{
+				if(pRes->next())
+					CRankingCore::UpdateAccountGold(AccountID, pRes->getInt("Value"));
+			});
 		}
-		Database->Execute<DB::INSERT>("tw_accounts_items", "(ItemID, UserID, Value, Settings, Enchant) VALUES ('%d', '%d', '%d', '0', '0')", ItemID, AccountID, Value);
-		lock_sleep.unlock();
-	});
-	Thread.detach();
-}
\ No newline at end of file
+	}
+}
+
+void CInventoryCore::MarkDirtyItem(int ClientID, int UserID, ItemIdentifier ItemID)
+{
+	// worlds running in parallel share the set
+	std::lock_guard<std::recursive_mutex> Lock(ms_DirtyItemsLock);
+	auto Iter = ms_aDirtyItems.find(ClientID);
+	if(Iter != ms_aDirtyItems.end() && Iter->second.m_UserID != UserID)
+		SaveDirtyItems(ClientID);
+
+	CDirtyItems& Dirty = ms_aDirtyItems[ClientID];
+	Dirty.m_UserID = UserID;
+	Dirty.m_aItems.insert(ItemID);
+}
+
+void CInventoryCore::SaveDirtyItems(int ClientID)
+{
+	// rows per statement, keeps the amount of different prepared templates small
+	constexpr int MAX_ROWS = 32;
+
+	std::lock_guard<std::recursive_mutex> Lock(ms_DirtyItemsLock);
+	auto Iter = ms_aDirtyItems.find(ClientID);
+	if(Iter == ms_aDirtyItems.end())
+		return;
+
+	const auto* paItems = CPlayerItem::Data().Find(ClientID);
+	if(!paItems)
+	{
+		ms_aDirtyItems.erase(Iter);
+		return;
+	}
+
+	const int UserID = Iter->second.m_UserID;
+	std::vector<const CPlayerItem*> apUpdate;
+	std::vector<ItemIdentifier> aRemove;
+	for(const ItemIdentifier ItemID : Iter->second.m_aItems)
+	{
+		const auto pItem = paItems->find(ItemID);
+		if(pItem == paItems->end())
+			continue;
+
+		if(pItem->second.GetValue() > 0)
+			apUpdate.push_back(&pItem->second);
+		else
+			aRemove.push_back(ItemID);
+	}
+	ms_aDirtyItems.erase(Iter);
+
+	for(size_t Begin = 0; Begin < apUpdate.size(); Begin += MAX_ROWS)
+	{
+		const size_t End = min(apUpdate.size(), Begin + MAX_ROWS);
+		std::string Template = "INSERT INTO tw_accounts_items (ItemID, UserID, Value, Settings, Enchant, Durability) VALUES ";
+		for(size_t i = Begin; i < End; i++)
+			Template += (i == Begin ? "(?, ?, ?, ?, ?, ?)" : ", (?, ?, ?, ?, ?, ?)");
+		Template += " ON DUPLICATE KEY UPDATE Value = VALUES(Value), Settings = VALUES(Settings), Enchant = VALUES(Enchant), Durability = VALUES(Durability)";
+
+		auto pQuery = Database->PrepareBind<DB::OTHER>(Template.c_str());
+		for(size_t i = Begin; i < End; i++)
+		{
+			const CPlayerItem* pItem = apUpdate[i];
+			pQuery->Add(pItem->GetID()).Add(UserID).Add(pItem->GetValue()).Add(pItem->GetSettings()).Add(pItem->GetEnchant()).Add(pItem->GetDurability());
+		}
+		pQuery->Execute();
+	}
+
+	for(size_t Begin = 0; Begin < aRemove.size(); Begin += MAX_ROWS)
+	{
+		const size_t End = min(aRemove.size(), Begin + MAX_ROWS);
+		std::string Template = "WHERE UserID = ? AND ItemID IN (";
+		for(size_t i = Begin; i < End; i++)
+			Template += (i == Begin ? "?" : ", ?");
+		Template += ")";
+
+		auto pQuery = Database->PrepareBind<DB::REMOVE>("tw_accounts_items", Template.c_str());
+		pQuery->Add(UserID);
+		for(size_t i = Begin; i < End; i++)
+			pQuery->Add(aRemove[i]);
+		pQuery->Execute();
+	}
+}
+
+void CInventoryCore::SaveDirtyItems()
+{
+	std::lock_guard<std::recursive_mutex> Lock(ms_DirtyItemsLock);
+	while(!ms_aDirtyItems.empty())
+		SaveDirtyItems(ms_aDirtyItems.begin()->first);
+}
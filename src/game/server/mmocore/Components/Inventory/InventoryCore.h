@@ -6,17 +6,41 @@
 
 #include "ItemData.h"
 
+#include <set>
+
 class CInventoryCore : public MmoComponent
 {
+	// items changed since the last write, grouped by client
+	struct CDirtyItems
+	{
+		int m_UserID;
+		std::set<ItemIdentifier> m_aItems;
+	};
+	inline static std::map<int, CDirtyItems> ms_aDirtyItems;
+	inline static std::recursive_mutex ms_DirtyItemsLock;
+
+	// items given after a delay, handed out in the main world tick
+	struct CSleepItem
+	{
+		int m_AccountID;
+		ItemIdentifier m_ItemID;
+		int m_Value;
+		int m_Tick;
+	};
+	inline static std::vector<CSleepItem> ms_aSleepItems;
+	inline static std::mutex ms_SleepItemsLock;
+
 	~CInventoryCore() override
 	{
+		SaveDirtyItems();
 		CAttributeDescription::Data().clear();
 		CItemDescription::Data().clear();
-		CPlayerItem::Data().clear();
+		CPlayerItem::Data().Clear();
 	}
 
 	void OnInit() override;
-	void OnInitAccount(class CPlayer* pPlayer) override;
+	const char* GetAccountTable() const override { return "tw_accounts_items"; }
+	void OnInitAccount(class CPlayer* pPlayer, ResultPtr& pRes) override;
 	void OnResetClient(int ClientID) override;
 	bool OnHandleVoteCommands(class CPlayer* pPlayer, const char* CMD, int VoteID, int VoteID2, int Get, const char* GetText) override;
 	bool OnHandleMenulist(class CPlayer* pPlayer, int Menulist, bool ReplaceMenu) override;
@@ -32,6 +56,12 @@ public:
 	int GetCountItemsType(class CPlayer* pPlayer, ItemType Type) const;
 
 	void AddItemSleep(int AccountID, ItemIdentifier ItemID, int Value, int Milliseconds);
+	void TickSleepItems();
+
+	// write-behind for player items
+	static void MarkDirtyItem(int ClientID, int UserID, ItemIdentifier ItemID);
+	static void SaveDirtyItems(int ClientID);
+	static void SaveDirtyItems();
 };
 
 #endif
\ No newline at end of file
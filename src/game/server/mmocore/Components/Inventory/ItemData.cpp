@@ -5,6 +5,8 @@
 #include <game/server/gamecontext.h>
 
 #include "game/server/mmocore/Components/Eidolons/EidolonCore.h"
+#include "game/server/mmocore/Components/Rankings/RankingCore.h"
+#include "InventoryCore.h"
 
 CGS* CPlayerItem::GS() const
 {
@@ -88,6 +90,7 @@ bool CPlayerItem::Add(int Value, int StartSettings, int StartEnchant, bool Messa
 	{
 		m_Enchant = StartEnchant;
 		m_Settings = StartSettings;
+		m_Durability = 100;
 	}
 	m_Value += Value;
 
@@ -139,6 +142,7 @@ bool CPlayerItem::Equip(bool SaveItem)
 		return false;
 
 	m_Settings ^= true;
+	GetPlayer()->InvalidateAttributes();
 
 	if(Info()->IsType(ItemType::TYPE_EQUIP))
 	{
@@ -169,7 +173,7 @@ bool CPlayerItem::Use(int Value)
 	// potion mana regen
 	if(m_ID == itPotionManaRegen && Remove(Value))
 	{
-		GetPlayer()->GiveEffect("RegenMana", 15);
+		GetPlayer()->GiveEffect(EFFECT_REGEN_MANA, 15);
 		GS()->Chat(ClientID, "You used {STR}x{VAL}", Info()->GetName(), Value);
 		return true;
 	}
@@ -222,6 +226,7 @@ bool CPlayerItem::Use(int Value)
 
 		GS()->Chat(-1, "{STR} used {STR} returned {INT} upgrades.", GS()->Server()->ClientName(ClientID), Info()->GetName(), BackUpgrades);
 		GetPlayer()->Acc().m_Upgrade += BackUpgrades;
+		GetPlayer()->InvalidateAttributes();
 		GS()->Mmo()->SaveAccount(GetPlayer(), SAVE_UPGRADES);
 		return true;
 	}
@@ -253,6 +258,7 @@ bool CPlayerItem::Use(int Value)
 
 		GS()->Chat(-1, "{STR} used {STR} returned {INT} upgrades.", GS()->Server()->ClientName(ClientID), Info()->GetName(), BackUpgrades);
 		GetPlayer()->Acc().m_Upgrade += BackUpgrades;
+		GetPlayer()->InvalidateAttributes();
 		GS()->Mmo()->SaveAccount(GetPlayer(), SAVE_UPGRADES);
 		return true;
 	}
@@ -272,7 +278,7 @@ bool CPlayerItem::Use(int Value)
 		if(Remove(Value))
 		{
 			int PotionTime = pHeal->getTime();
-			GetPlayer()->GiveEffect(pHeal->getEffect(), PotionTime);
+			GetPlayer()->GiveEffect(pHeal->getEffectID(), PotionTime);
 			GetPlayer()->m_aPlayerTick[PotionRecast] = Server()->Tick() + ((PotionTime + POTION_RECAST_APPEND_TIME) * Server()->TickSpeed());
 
 			GS()->Chat(ClientID, "You used {STR}x{VAL}", Info()->GetName(), Value);
@@ -309,33 +315,12 @@ bool CPlayerItem::Save()
 {
 	if(GetPlayer() && GetPlayer()->IsAuthed())
 	{
-		int UserID = GetPlayer()->Acc().m_UserID;
-		const auto pResCheck = Database->Prepare<DB::SELECT>("ItemID, UserID", "tw_accounts_items", "WHERE ItemID = '%d' AND UserID = '%d'", m_ID, UserID);
-		pResCheck->AtExecute([this, UserID](ResultPtr pRes)
-		{
-			// check database value
-			if(pRes->next())
-			{
-				// remove item
-				if(!m_Value)
-				{
-					Database->Execute<DB::REMOVE>("tw_accounts_items", "WHERE ItemID = '%d' AND UserID = '%d'", m_ID, UserID);
-					return;
-				}
-
-				// update an item
-				Database->Execute<DB::UPDATE>("tw_accounts_items", "Value = '%d', Settings = '%d', Enchant = '%d', Durability = '%d' WHERE UserID = '%d' AND ItemID = '%d'",
-					m_Value, m_Settings, m_Enchant, m_Durability, GetPlayer()->Acc().m_UserID, m_ID);
-				return;
-			}
+		GetPlayer()->InvalidateAttributes();
 
-			// insert item
-			if(m_Value)
-			{
-				m_Durability = 100;
-				Database->Execute<DB::INSERT>("tw_accounts_items", "(ItemID, UserID, Value, Settings, Enchant) VALUES ('%d', '%d', '%d', '%d', '%d')", m_ID, UserID, m_Value, m_Settings, m_Enchant);
-			}
-		});
+		// the write is deferred, changes of the same item are merged until the next flush
+		CInventoryCore::MarkDirtyItem(m_ClientID, GetPlayer()->Acc().m_UserID, m_ID);
+		if(m_ID == itGold)
+			CRankingCore::UpdateAccountGold(GetPlayer()->Acc().m_UserID, m_Value);
 		return true;
 	}
 	return false;
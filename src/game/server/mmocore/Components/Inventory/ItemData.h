@@ -45,7 +45,7 @@ public:
 	[[nodiscard]] static CItemsContainer FromArrayJSON(const std::string& json);
 };
 
-class CPlayerItem : public CItem, public MultiworldIdentifiableStaticData< std::map < int, std::map < int, CPlayerItem > > >
+class CPlayerItem : public CItem, public MultiworldIdentifiableStaticData< CClientDataMap < std::map < int, CPlayerItem > > >
 {
 	friend class CInventoryCore;
 	int m_ClientID{};
@@ -63,7 +63,7 @@ public:
 		m_Enchant = Enchant;
 		m_Durability = Durability;
 		m_Settings = Settings;
-		CPlayerItem::m_pData[m_ClientID][m_ID] = *this;
+		CPlayerItem::m_pData.Get(m_ClientID)[m_ID] = *this;
 	}
 	
 	// getters
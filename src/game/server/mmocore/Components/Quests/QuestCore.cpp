@@ -18,32 +18,35 @@ void QuestCore::OnInit()
 	}
 }
 
-void QuestCore::OnInitAccount(CPlayer* pPlayer)
+void QuestCore::OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes)
 {
 	const int ClientID = pPlayer->GetCID();
-	ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_accounts_quests", "WHERE UserID = '%d'", pPlayer->Acc().m_UserID);
 	while(pRes->next())
 	{
 		const int QuestID = pRes->getInt("QuestID");
-		CQuestData::ms_aPlayerQuests[ClientID][QuestID].m_pPlayer = pPlayer;
-		CQuestData::ms_aPlayerQuests[ClientID][QuestID].m_QuestID = QuestID;
-		CQuestData::ms_aPlayerQuests[ClientID][QuestID].m_State = (QuestState)pRes->getInt("Type");
-		CQuestData::ms_aPlayerQuests[ClientID][QuestID].LoadSteps();
+		CQuestData& Quest = CQuestData::ms_aPlayerQuests.Get(ClientID)[QuestID];
+		Quest.m_pPlayer = pPlayer;
+		Quest.m_QuestID = QuestID;
+		Quest.m_State = (QuestState)pRes->getInt("Type");
+		Quest.LoadSteps();
 	}
 }
 
 void QuestCore::OnResetClient(int ClientID)
 {
-	for(auto& qp : CQuestData::ms_aPlayerQuests[ClientID])
+	if(auto* paQuests = CQuestData::ms_aPlayerQuests.Find(ClientID))
 	{
-		for(auto& pStepBot : qp.second.m_StepsQuestBot)
+		for(auto& qp : *paQuests)
 		{
-			pStepBot.second.m_ClientQuitting = true;
-			pStepBot.second.UpdateBot();
+			for(auto& pStepBot : qp.second.m_StepsQuestBot)
+			{
+				pStepBot.second.m_ClientQuitting = true;
+				pStepBot.second.UpdateBot();
+			}
 		}
 	}
 
-	CQuestData::ms_aPlayerQuests.erase(ClientID);
+	CQuestData::ms_aPlayerQuests.Erase(ClientID);
 }
 
 bool QuestCore::OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool ReplaceMenu)
@@ -280,7 +283,7 @@ void QuestCore::AddMobProgressQuests(CPlayer* pPlayer, int BotID)
 {
 	// TODO Optimize algoritm check complected steps
 	const int ClientID = pPlayer->GetCID();
-	for(auto& pPlayerQuest : CQuestData::ms_aPlayerQuests[ClientID])
+	for(auto& pPlayerQuest : CQuestData::ms_aPlayerQuests.Get(ClientID))
 	{
 		if(pPlayerQuest.second.m_State != QuestState::ACCEPT)
 			continue;
@@ -297,7 +300,7 @@ void QuestCore::UpdateArrowStep(CPlayer *pPlayer)
 {
 	// TODO Optimize algoritm check complected steps
 	const int ClientID = pPlayer->GetCID();
-	for (auto& pPlayerQuest : CQuestData::ms_aPlayerQuests[ClientID])
+	for (auto& pPlayerQuest : CQuestData::ms_aPlayerQuests.Get(ClientID))
 	{
 		if(pPlayerQuest.second.m_State != QuestState::ACCEPT)
 			continue;
@@ -330,7 +333,7 @@ void QuestCore::AcceptNextStoryQuestStep(CPlayer* pPlayer)
 {
 	// check first quest story step search active quests
 	std::list < std::string /*stories was checked*/ > StoriesChecked;
-	for(const auto& pPlayerQuest : CQuestData::ms_aPlayerQuests[pPlayer->GetCID()])
+	for(const auto& pPlayerQuest : CQuestData::ms_aPlayerQuests.Get(pPlayer->GetCID()))
 	{
 		// allow accept next story quest only for complected some quest on story
 		if(pPlayerQuest.second.GetState() != QuestState::FINISHED)
@@ -351,7 +354,7 @@ int QuestCore::GetUnfrozenItemValue(CPlayer *pPlayer, int ItemID) const
 {
 	const int ClientID = pPlayer->GetCID();
 	int AvailableValue = pPlayer->GetItem(ItemID)->GetValue();
-	for (const auto& pPlayerQuest : CQuestData::ms_aPlayerQuests[ClientID])
+	for (const auto& pPlayerQuest : CQuestData::ms_aPlayerQuests.Get(ClientID))
 	{
 		if(pPlayerQuest.second.m_State != QuestState::ACCEPT)
 			continue;
@@ -369,7 +372,7 @@ int QuestCore::GetClientComplectedQuestsSize(int ClientID) const
 {
 	int Total = 0;
 
-	for(auto& [QuestID, Data] : CQuestData::ms_aPlayerQuests[ClientID])
+	for(auto& [QuestID, Data] : CQuestData::ms_aPlayerQuests.Get(ClientID))
 	{
 		if(Data.IsComplected())
 			Total++;
@@ -18,11 +18,12 @@ class QuestCore : public MmoComponent
 	~QuestCore() override
 	{
 		CQuestDataInfo::ms_aDataQuests.clear();
-		CQuestData::ms_aPlayerQuests.clear();
+		CQuestData::ms_aPlayerQuests.Clear();
 	}
 
 	void OnInit() override;
-	void OnInitAccount(CPlayer* pPlayer) override;
+	const char* GetAccountTable() const override { return "tw_accounts_quests"; }
+	void OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes) override;
 	void OnResetClient(int ClientID) override;
 	bool OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool ReplaceMenu) override;
 	bool OnHandleVoteCommands(CPlayer* pPlayer, const char* CMD, int VoteID, int VoteID2, int Get, const char* GetText) override;
@@ -34,7 +35,8 @@ public:
 		{
 			if (ClientID < 0 || ClientID >= MAX_PLAYERS)
 				return true;
-			if (CQuestData::ms_aPlayerQuests[ClientID].find(QuestID) != CQuestData::ms_aPlayerQuests[ClientID].end())
+			const auto* paQuests = CQuestData::ms_aPlayerQuests.Find(ClientID);
+			if (paQuests && paQuests->find(QuestID) != paQuests->end())
 				return true;
 		}
 		return false;
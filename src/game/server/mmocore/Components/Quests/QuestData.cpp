@@ -10,7 +10,7 @@
 CQuestDataInfo& CQuestData::Info() const { return CQuestDataInfo::ms_aDataQuests[m_QuestID]; }
 std::string CQuestData::GetJsonFileName() const { return Info().GetJsonFileName(m_pPlayer->Acc().m_UserID); }
 
-std::map < int, std::map <int, CQuestData > > CQuestData::ms_aPlayerQuests;
+CClientDataMap < std::map < int, CQuestData > > CQuestData::ms_aPlayerQuests;
 void CQuestData::InitSteps()
 {
 	if(m_State != QuestState::ACCEPT || !m_pPlayer)
@@ -32,7 +32,7 @@ private:
 	void Finish();
 
 public:
-	static std::map < int, std::map <int, CQuestData > > ms_aPlayerQuests;
+	static CClientDataMap < std::map < int, CQuestData > > ms_aPlayerQuests;
 };
 
 #endif
\ No newline at end of file
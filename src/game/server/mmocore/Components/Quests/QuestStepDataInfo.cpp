@@ -134,11 +134,12 @@ bool CPlayerQuestStepDataInfo::Finish(CPlayer* pPlayer, bool FinalStepTalking)
 
 	// update state complete
 	m_StepComplete = true;
-	DataBotInfo::ms_aDataBot[m_Bot.m_BotID].m_aVisibleActive[ClientID] = false;
-	CQuestData::ms_aPlayerQuests[ClientID][QuestID].SaveSteps();
+	const int BotID = m_Bot.m_BotID;
+	pGS->Server()->ExecuteCrossWorld([BotID, ClientID]() { DataBotInfo::ms_aDataBot[BotID].m_aVisibleActive[ClientID] = false; });
+	CQuestData::ms_aPlayerQuests.Get(ClientID)[QuestID].SaveSteps();
 	UpdateBot();
 
-	CQuestData::ms_aPlayerQuests[ClientID][QuestID].CheckAvailableNewStep();
+	CQuestData::ms_aPlayerQuests.Get(ClientID)[QuestID].CheckAvailableNewStep();
 	pGS->StrongUpdateVotes(ClientID, MENU_JOURNAL_MAIN);
 	return true;
 }
@@ -217,7 +218,7 @@ void CPlayerQuestStepDataInfo::AddMobProgress(CPlayer* pPlayer, int BotID)
 		if(m_MobProgress[i] >= m_Bot.m_aNeedMobValue[i])
 			pGS->Chat(ClientID, "[Done] Defeat the {STR}'s for the {STR}!", DataBotInfo::ms_aDataBot[BotID].m_aNameBot, m_Bot.GetName());
 
-		CQuestData::ms_aPlayerQuests[ClientID][QuestID].SaveSteps();
+		CQuestData::ms_aPlayerQuests.Get(ClientID)[QuestID].SaveSteps();
 		break;
 	}
 }
@@ -231,7 +232,7 @@ void CPlayerQuestStepDataInfo::CreateStepArrow(int ClientID)
 		return;
 
 	if(pPlayer->GetQuest(m_Bot.m_QuestID).GetState() == QuestState::ACCEPT && pPlayer->GetQuest(m_Bot.m_QuestID).m_Step == m_Bot.m_Step)
-		new CQuestPathFinder(&pGS->m_World, pPlayer->GetCharacter()->m_Core.m_Pos, ClientID, m_Bot);
+		new(&pGS->m_World) CQuestPathFinder(&pGS->m_World, pPlayer->GetCharacter()->m_Core.m_Pos, ClientID, m_Bot);
 }
 
 void CPlayerQuestStepDataInfo::CreateStepDropTakeItems(CPlayer* pPlayer)
@@ -253,7 +254,7 @@ void CPlayerQuestStepDataInfo::CreateStepDropTakeItems(CPlayer* pPlayer)
 	{
 		const vec2 Vel = vec2(frandom() * 40.0f - frandom() * 80.0f, frandom() * 40.0f - frandom() * 80.0f);
 		const float AngleForce = Vel.x * (0.15f + frandom() * 0.1f);
-		new CDropQuestItem(&pGS->m_World, m_Bot.m_Position, Vel, AngleForce, m_Bot, ClientID);
+		new(&pGS->m_World) CDropQuestItem(&pGS->m_World, m_Bot.m_Position, Vel, AngleForce, m_Bot, ClientID);
 	}
 }
 
@@ -271,7 +272,7 @@ void CPlayerQuestStepDataInfo::ShowRequired(CPlayer* pPlayer, char* aBufQuestTas
 		if(BotID > 0 && ValueMob > 0 && DataBotInfo::ms_aDataBot.find(BotID) != DataBotInfo::ms_aDataBot.end())
 		{
 			Buffer.append_at(Buffer.length(), "\n");
-			pGS->Server()->Localization()->Format(Buffer, pPlayer->GetLanguage(), "- Defeat {STR} ({INT}/{INT})", DataBotInfo::ms_aDataBot[BotID].m_aNameBot, m_MobProgress[i], ValueMob);
+			pGS->Server()->Localization()->Format(Buffer, pPlayer->GetLanguageID(), "- Defeat {STR} ({INT}/{INT})", DataBotInfo::ms_aDataBot[BotID].m_aNameBot, m_MobProgress[i], ValueMob);
 		}
 
 		const int ItemID = m_Bot.m_aItemSearch[i];
@@ -282,8 +283,8 @@ void CPlayerQuestStepDataInfo::ShowRequired(CPlayer* pPlayer, char* aBufQuestTas
 			Buffer.append_at(Buffer.length(), "\n");
 
 			const char* pInteractiveType = m_Bot.m_InteractiveType == (int)INTERACTIVE_SHOW_ITEMS ? "Show" : "Need";
-			pGS->Server()->Localization()->Format(Buffer, pPlayer->GetLanguage(), "- {STR} {STR} ({VAL}/{VAL})", 
-				pGS->Server()->Localization()->Localize(pPlayer->GetLanguage(), pInteractiveType), pPlayerItem->Info()->GetName(), pPlayerItem->GetValue(), ValueItem);
+			pGS->Server()->Localization()->Format(Buffer, pPlayer->GetLanguageID(), "- {STR} {STR} ({VAL}/{VAL})", 
+				pGS->Server()->Localization()->Localize(pPlayer->GetLanguageID(), pInteractiveType), pPlayerItem->Info()->GetName(), pPlayerItem->GetValue(), ValueItem);
 		}
 	}
 
@@ -295,7 +296,7 @@ void CPlayerQuestStepDataInfo::ShowRequired(CPlayer* pPlayer, char* aBufQuestTas
 		if(ItemID > 0 && ValueItem > 0)
 		{
 			Buffer.append_at(Buffer.length(), "\n");
-			pGS->Server()->Localization()->Format(Buffer, pPlayer->GetLanguage(), "- Receive {STR} ({VAL})", pPlayer->GetItem(ItemID)->Info()->GetName(), ValueItem);
+			pGS->Server()->Localization()->Format(Buffer, pPlayer->GetLanguageID(), "- Receive {STR} ({VAL})", pPlayer->GetItem(ItemID)->Info()->GetName(), ValueItem);
 		}
 	}
 
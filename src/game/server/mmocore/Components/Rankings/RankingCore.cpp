@@ -0,0 +1,115 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include "RankingCore.h"
+
+#include <game/server/gamecontext.h>
+
+std::mutex CRankingCore::ms_Lock;
+CLeaderboard CRankingCore::ms_aBoards[(int)ToplistType::NUM_TOPLIST_TYPES];
+std::unordered_map<int, std::string> CRankingCore::ms_aAccountNames;
+std::unordered_map<int, std::string> CRankingCore::ms_aGuildNames;
+
+void CRankingCore::OnInit()
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	for(auto& Board : ms_aBoards)
+		Board.Clear();
+	ms_aAccountNames.clear();
+	ms_aGuildNames.clear();
+
+	ResultPtr pRes = Database->Execute<DB::SELECT>("ID, Nick, Level, Exp", "tw_accounts_data");
+	while(pRes->next())
+	{
+		const int AccountID = pRes->getInt("ID");
+		ms_aAccountNames[AccountID] = pRes->getString("Nick").c_str();
+		ms_aBoards[(int)ToplistType::PLAYERS_LEVELING].Set(AccountID, LevelScore(pRes->getInt("Level"), pRes->getInt("Exp")));
+	}
+
+	ResultPtr pResGold = Database->Execute<DB::SELECT>("UserID, Value", "tw_accounts_items", "WHERE ItemID = '%d'", (ItemIdentifier)itGold);
+	while(pResGold->next())
+		ms_aBoards[(int)ToplistType::PLAYERS_WEALTHY].Set(pResGold->getInt("UserID"), pResGold->getInt("Value"));
+
+	ResultPtr pResGuilds = Database->Execute<DB::SELECT>("ID, Name, Level, Experience, Bank", "tw_guilds");
+	while(pResGuilds->next())
+	{
+		const int GuildID = pResGuilds->getInt("ID");
+		ms_aGuildNames[GuildID] = pResGuilds->getString("Name").c_str();
+		ms_aBoards[(int)ToplistType::GUILDS_LEVELING].Set(GuildID, LevelScore(pResGuilds->getInt("Level"), pResGuilds->getInt("Experience")));
+		ms_aBoards[(int)ToplistType::GUILDS_WEALTHY].Set(GuildID, pResGuilds->getInt("Bank"));
+	}
+
+	dbg_msg("ranking", "loaded %d accounts and %d guilds", ms_aBoards[(int)ToplistType::PLAYERS_LEVELING].GetSize(), ms_aBoards[(int)ToplistType::GUILDS_LEVELING].GetSize());
+}
+
+void CRankingCore::UpdateAccountName(int AccountID, const char* pName)
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	ms_aAccountNames[AccountID] = pName;
+}
+
+void CRankingCore::UpdateAccountLevel(int AccountID, int Level, int Exp)
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	ms_aBoards[(int)ToplistType::PLAYERS_LEVELING].Set(AccountID, LevelScore(Level, Exp));
+}
+
+void CRankingCore::UpdateAccountGold(int AccountID, int Gold)
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	ms_aBoards[(int)ToplistType::PLAYERS_WEALTHY].Set(AccountID, Gold);
+}
+
+void CRankingCore::UpdateGuildName(int GuildID, const char* pName)
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	ms_aGuildNames[GuildID] = pName;
+}
+
+void CRankingCore::UpdateGuildLevel(int GuildID, int Level, int Exp)
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	ms_aBoards[(int)ToplistType::GUILDS_LEVELING].Set(GuildID, LevelScore(Level, Exp));
+}
+
+void CRankingCore::UpdateGuildBank(int GuildID, int Bank)
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	ms_aBoards[(int)ToplistType::GUILDS_WEALTHY].Set(GuildID, Bank);
+}
+
+void CRankingCore::RemoveGuild(int GuildID)
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	ms_aBoards[(int)ToplistType::GUILDS_LEVELING].Remove(GuildID);
+	ms_aBoards[(int)ToplistType::GUILDS_WEALTHY].Remove(GuildID);
+	ms_aGuildNames.erase(GuildID);
+}
+
+int CRankingCore::GetRank(ToplistType Type, int ID)
+{
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	return ms_aBoards[(int)Type].GetRank(ID);
+}
+
+std::vector<CRankingCore::CEntry> CRankingCore::GetTop(ToplistType Type, int Limit)
+{
+	const bool IsGuilds = (Type == ToplistType::GUILDS_LEVELING || Type == ToplistType::GUILDS_WEALTHY);
+	const bool IsLeveling = (Type == ToplistType::GUILDS_LEVELING || Type == ToplistType::PLAYERS_LEVELING);
+
+	std::vector<CEntry> aEntries;
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	const auto& aNames = IsGuilds ? ms_aGuildNames : ms_aAccountNames;
+	ms_aBoards[(int)Type].ForTop(Limit, [&](int Rank, int ID, int64_t Score)
+	{
+		CEntry Entry;
+		Entry.m_Rank = Rank;
+		Entry.m_ID = ID;
+		Entry.m_Level = IsLeveling ? (int)(Score >> 32) : 0;
+		Entry.m_Value = IsLeveling ? (int)(uint32_t)Score : (int)Score;
+
+		const auto Iter = aNames.find(ID);
+		str_copy(Entry.m_aName, Iter != aNames.end() ? Iter->second.c_str() : "No found!", sizeof(Entry.m_aName));
+		aEntries.push_back(Entry);
+	});
+	return aEntries;
+}
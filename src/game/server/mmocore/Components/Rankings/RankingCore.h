@@ -0,0 +1,51 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#ifndef GAME_SERVER_COMPONENT_RANKING_CORE_H
+#define GAME_SERVER_COMPONENT_RANKING_CORE_H
+#include <game/server/mmocore/MmoComponent.h>
+#include <game/server/mmocore/GameContext.h>
+
+#include "RankingData.h"
+
+/*
+	The top lists are loaded once when the server starts and then kept up to
+	date by the places that write levels, gold and guild banks, so no ranking
+	ever sorts a table. Worlds tick in parallel, every access takes the lock.
+*/
+class CRankingCore : public MmoComponent
+{
+	~CRankingCore() override = default;
+
+	void OnInit() override;
+
+	static std::mutex ms_Lock;
+	static CLeaderboard ms_aBoards[(int)ToplistType::NUM_TOPLIST_TYPES];
+	static std::unordered_map<int, std::string> ms_aAccountNames;
+	static std::unordered_map<int, std::string> ms_aGuildNames;
+
+	static int64_t LevelScore(int Level, int Exp) { return ((int64_t)Level << 32) | (uint32_t)Exp; }
+
+public:
+	struct CEntry
+	{
+		int m_Rank;
+		int m_ID;
+		char m_aName[32];
+		int m_Level;
+		int m_Value; // experience for the leveling lists, gold for the wealthy lists
+	};
+
+	static void UpdateAccountName(int AccountID, const char* pName);
+	static void UpdateAccountLevel(int AccountID, int Level, int Exp);
+	static void UpdateAccountGold(int AccountID, int Gold);
+
+	static void UpdateGuildName(int GuildID, const char* pName);
+	static void UpdateGuildLevel(int GuildID, int Level, int Exp);
+	static void UpdateGuildBank(int GuildID, int Bank);
+	static void RemoveGuild(int GuildID);
+
+	static int GetRank(ToplistType Type, int ID);
+	static std::vector<CEntry> GetTop(ToplistType Type, int Limit);
+};
+
+#endif
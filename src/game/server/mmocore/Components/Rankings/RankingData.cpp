@@ -0,0 +1,182 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include "RankingData.h"
+
+CLeaderboard::CLeaderboard()
+{
+	m_Head.m_ID = -1;
+	m_Head.m_Score = 0;
+	m_Head.m_aLinks.assign(MAX_LEVEL, { nullptr, 0 });
+	m_Level = 1;
+	m_Size = 0;
+	m_Seed = 0x2545F491;
+}
+
+CLeaderboard::~CLeaderboard()
+{
+	Clear();
+}
+
+void CLeaderboard::Clear()
+{
+	CNode* pNode = m_Head.m_aLinks[0].m_pNext;
+	while(pNode)
+	{
+		CNode* pNext = pNode->m_aLinks[0].m_pNext;
+		delete pNode;
+		pNode = pNext;
+	}
+
+	m_Head.m_aLinks.assign(MAX_LEVEL, { nullptr, 0 });
+	m_Level = 1;
+	m_Size = 0;
+	m_aScores.clear();
+}
+
+int CLeaderboard::RandomLevel()
+{
+	// every level holds a quarter of the level below
+	int Level = 1;
+	while(Level < MAX_LEVEL)
+	{
+		m_Seed ^= m_Seed << 13;
+		m_Seed ^= m_Seed >> 17;
+		m_Seed ^= m_Seed << 5;
+		if((m_Seed & 3) != 0)
+			break;
+		Level++;
+	}
+	return Level;
+}
+
+void CLeaderboard::Set(int ID, int64_t Score)
+{
+	const auto Iter = m_aScores.find(ID);
+	if(Iter != m_aScores.end())
+	{
+		if(Iter->second == Score)
+			return;
+		Erase(ID, Iter->second);
+	}
+
+	Insert(ID, Score);
+	m_aScores[ID] = Score;
+}
+
+void CLeaderboard::Remove(int ID)
+{
+	const auto Iter = m_aScores.find(ID);
+	if(Iter == m_aScores.end())
+		return;
+
+	Erase(ID, Iter->second);
+	m_aScores.erase(Iter);
+}
+
+void CLeaderboard::Insert(int ID, int64_t Score)
+{
+	CNode* apUpdate[MAX_LEVEL];
+	int aRank[MAX_LEVEL];
+
+	CNode* pNode = &m_Head;
+	for(int i = m_Level - 1; i >= 0; i--)
+	{
+		aRank[i] = (i == m_Level - 1) ? 0 : aRank[i + 1];
+		while(pNode->m_aLinks[i].m_pNext && Before(pNode->m_aLinks[i].m_pNext, ID, Score))
+		{
+			aRank[i] += pNode->m_aLinks[i].m_Span;
+			pNode = pNode->m_aLinks[i].m_pNext;
+		}
+		apUpdate[i] = pNode;
+	}
+
+	const int Level = RandomLevel();
+	if(Level > m_Level)
+	{
+		for(int i = m_Level; i < Level; i++)
+		{
+			aRank[i] = 0;
+			apUpdate[i] = &m_Head;
+			m_Head.m_aLinks[i].m_Span = m_Size;
+		}
+		m_Level = Level;
+	}
+
+	CNode* pNew = new CNode;
+	pNew->m_ID = ID;
+	pNew->m_Score = Score;
+	pNew->m_aLinks.resize(Level);
+	for(int i = 0; i < Level; i++)
+	{
+		CNode::CLink& Prev = apUpdate[i]->m_aLinks[i];
+		pNew->m_aLinks[i].m_pNext = Prev.m_pNext;
+		pNew->m_aLinks[i].m_Span = Prev.m_Span - (aRank[0] - aRank[i]);
+		Prev.m_pNext = pNew;
+		Prev.m_Span = (aRank[0] - aRank[i]) + 1;
+	}
+
+	// links above the new node pass over one more entry
+	for(int i = Level; i < m_Level; i++)
+		apUpdate[i]->m_aLinks[i].m_Span++;
+
+	m_Size++;
+}
+
+void CLeaderboard::Erase(int ID, int64_t Score)
+{
+	CNode* apUpdate[MAX_LEVEL];
+
+	CNode* pNode = &m_Head;
+	for(int i = m_Level - 1; i >= 0; i--)
+	{
+		while(pNode->m_aLinks[i].m_pNext && Before(pNode->m_aLinks[i].m_pNext, ID, Score))
+			pNode = pNode->m_aLinks[i].m_pNext;
+		apUpdate[i] = pNode;
+	}
+
+	CNode* pFound = pNode->m_aLinks[0].m_pNext;
+	if(!pFound || pFound->m_ID != ID)
+		return;
+
+	for(int i = 0; i < m_Level; i++)
+	{
+		CNode::CLink& Prev = apUpdate[i]->m_aLinks[i];
+		if(Prev.m_pNext == pFound)
+		{
+			Prev.m_Span += pFound->m_aLinks[i].m_Span - 1;
+			Prev.m_pNext = pFound->m_aLinks[i].m_pNext;
+		}
+		else
+			Prev.m_Span--;
+	}
+
+	while(m_Level > 1 && !m_Head.m_aLinks[m_Level - 1].m_pNext)
+		m_Level--;
+
+	delete pFound;
+	m_Size--;
+}
+
+int CLeaderboard::GetRank(int ID) const
+{
+	const auto Iter = m_aScores.find(ID);
+	if(Iter == m_aScores.end())
+		return -1;
+
+	// walk to the entry itself while adding the skipped entries
+	const int64_t Score = Iter->second;
+	int Rank = 0;
+	const CNode* pNode = &m_Head;
+	for(int i = m_Level - 1; i >= 0; i--)
+	{
+		while(pNode->m_aLinks[i].m_pNext && (Before(pNode->m_aLinks[i].m_pNext, ID, Score) || pNode->m_aLinks[i].m_pNext->m_ID == ID))
+		{
+			Rank += pNode->m_aLinks[i].m_Span;
+			pNode = pNode->m_aLinks[i].m_pNext;
+		}
+
+		if(pNode->m_ID == ID)
+			return Rank;
+	}
+	return -1;
+}
@@ -0,0 +1,74 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#ifndef GAME_SERVER_COMPONENT_RANKING_DATA_H
+#define GAME_SERVER_COMPONENT_RANKING_DATA_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/*
+	Indexable skiplist ordered by score descending, equal scores by id ascending.
+	Every link knows how many entries it skips, so the rank of an entry and
+	the entry at a rank are found in O(log n), the top is read from the head.
+*/
+class CLeaderboard
+{
+	enum
+	{
+		MAX_LEVEL = 24,
+	};
+
+	struct CNode
+	{
+		struct CLink
+		{
+			CNode* m_pNext;
+			int m_Span;
+		};
+
+		int m_ID;
+		int64_t m_Score;
+		std::vector<CLink> m_aLinks;
+	};
+
+	CNode m_Head;
+	int m_Level;
+	int m_Size;
+	unsigned m_Seed;
+	std::unordered_map<int, int64_t> m_aScores;
+
+	int RandomLevel();
+	static bool Before(const CNode* pNode, int ID, int64_t Score)
+	{
+		return pNode->m_Score > Score || (pNode->m_Score == Score && pNode->m_ID < ID);
+	}
+	void Insert(int ID, int64_t Score);
+	void Erase(int ID, int64_t Score);
+
+public:
+	CLeaderboard();
+	~CLeaderboard();
+
+	CLeaderboard(const CLeaderboard&) = delete;
+	CLeaderboard& operator=(const CLeaderboard&) = delete;
+
+	void Set(int ID, int64_t Score);
+	void Remove(int ID);
+	void Clear();
+
+	// 1 for the best entry, -1 if the id is not ranked
+	int GetRank(int ID) const;
+	int GetSize() const { return m_Size; }
+
+	// calls Func(Rank, ID, Score) for the first Limit entries
+	template<typename F>
+	void ForTop(int Limit, F&& Func) const
+	{
+		int Rank = 0;
+		for(const CNode* pNode = m_Head.m_aLinks[0].m_pNext; pNode && Rank < Limit; pNode = pNode->m_aLinks[0].m_pNext)
+			Func(++Rank, pNode->m_ID, pNode->m_Score);
+	}
+};
+
+#endif
@@ -59,7 +59,7 @@ void CHealthHealer::Tick()
 		if(p && distance(m_Pos, p->m_Core.m_Pos) < 620.0f && (m_pPlayer->GetCID() == p->GetPlayer()->GetCID() || !p->IsAllowedPVP(m_pPlayer->GetCID())))
 		{
 			ShowHealthRestore = true;
-			new CHearth(&GS()->m_World, m_Pos, p->GetPlayer(), HealthRestore, p->m_Core.m_Vel);
+			new(&GS()->m_World) CHearth(&GS()->m_World, m_Pos, p->GetPlayer(), HealthRestore, p->m_Core.m_Vel);
 		}
 	}
 
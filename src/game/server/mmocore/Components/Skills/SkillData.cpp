@@ -63,7 +63,7 @@ bool CSkill::Use()
 
 		// create healt turret
 		const int PowerLevel = ManaCost;
-		new CHealthHealer(&GS()->m_World, GetPlayer(), GetBonus(), PowerLevel, PlayerPosition);
+		new(&GS()->m_World) CHealthHealer(&GS()->m_World, GetPlayer(), GetBonus(), PowerLevel, PlayerPosition);
 		return true;
 	}
 
@@ -81,13 +81,13 @@ bool CSkill::Use()
 
 		// create sleepy
 		const int PowerLevel = ManaCost;
-		new CSleepyGravity(&GS()->m_World, GetPlayer(), GetBonus(), PowerLevel, PlayerPosition);
+		new(&GS()->m_World) CSleepyGravity(&GS()->m_World, GetPlayer(), GetBonus(), PowerLevel, PlayerPosition);
 		return true;
 	}
 
 	if(m_ID == Skill::SkillAttackTeleport)
 	{
-		new CAttackTeleport(&GS()->m_World, PlayerPosition, pChr, GetBonus());
+		new(&GS()->m_World) CAttackTeleport(&GS()->m_World, PlayerPosition, pChr, GetBonus());
 		return true;
 	}
 
@@ -110,7 +110,7 @@ bool CSkill::Use()
 
 			// create healt
 			const int PowerLevel = max(ManaCost + translate_to_percent_rest(ManaCost, min(GetBonus(), 100)), 1);
-			new CHearth(&GS()->m_World, PlayerPosition, pPlayer, PowerLevel, pPlayer->GetCharacter()->m_Core.m_Vel, true);
+			new(&GS()->m_World) CHearth(&GS()->m_World, PlayerPosition, pPlayer, PowerLevel, pPlayer->GetCharacter()->m_Core.m_Vel, true);
 			GS()->CreateDeath(pPlayer->GetCharacter()->GetPos(), i);
 		}
 
@@ -5,7 +5,7 @@
 
 #include "SkillDataInfo.h"
 
-class CSkill : public MultiworldIdentifiableStaticData< std::map< int, std::map < int, CSkill > > >
+class CSkill : public MultiworldIdentifiableStaticData< CClientDataMap < std::map < int, CSkill > > >
 {
 	friend class CSkillsCore;
 
@@ -25,7 +25,7 @@ public:
 	{
 		m_Level = Level;
 		m_SelectedEmoticion = SelectedEmoticion;
-		CSkill::m_pData[m_ClientID][m_ID] = *this;
+		CSkill::m_pData.Get(m_ClientID)[m_ID] = *this;
 	}
 
 	void SetID(SkillIdentifier ID) { m_ID = ID; }
@@ -24,10 +24,9 @@ void CSkillsCore::OnInit()
 	}
 }
 
-void CSkillsCore::OnInitAccount(CPlayer *pPlayer)
+void CSkillsCore::OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes)
 {
 	const int ClientID = pPlayer->GetCID();
-	ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_accounts_skills", "WHERE UserID = '%d'", pPlayer->Acc().m_UserID);
 	while(pRes->next())
 	{
 		int Level = pRes->getInt("Level");
@@ -40,7 +39,7 @@ void CSkillsCore::OnInitAccount(CPlayer *pPlayer)
 
 void CSkillsCore::OnResetClient(int ClientID)
 {
-	CSkill::Data().erase(ClientID);
+	CSkill::Data().Erase(ClientID);
 }
 
 bool CSkillsCore::OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool ReplaceMenu)
@@ -171,7 +170,7 @@ void CSkillsCore::ParseEmoticionSkill(CPlayer *pPlayer, int EmoticionID)
 	if(pPlayer && pPlayer->IsAuthed() && pPlayer->GetCharacter())
 	{
 		const int ClientID = pPlayer->GetCID();
-		for(auto& [ID, Skill] : CSkill::Data()[ClientID])
+		for(auto& [ID, Skill] : CSkill::Data().Get(ClientID))
 		{
 			if (Skill.m_SelectedEmoticion == EmoticionID)
 				Skill.Use();
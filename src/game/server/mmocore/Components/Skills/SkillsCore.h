@@ -11,11 +11,12 @@ class CSkillsCore : public MmoComponent
 	~CSkillsCore() override
 	{
 		CSkillDescription::Data().clear();
-		CSkill::Data().clear();
+		CSkill::Data().Clear();
 	};
 
 	void OnInit() override;
-	void OnInitAccount(CPlayer* pPlayer) override;
+	const char* GetAccountTable() const override { return "tw_accounts_skills"; }
+	void OnInitAccount(CPlayer* pPlayer, ResultPtr& pRes) override;
 	void OnResetClient(int ClientID) override;
 	bool OnHandleTile(CCharacter* pChr, int IndexCollision) override;
 	bool OnHandleMenulist(CPlayer* pPlayer, int Menulist, bool ReplaceMenu) override;
@@ -0,0 +1,78 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include "Effects.h"
+
+#include <base/system.h>
+
+char CEffects::ms_aaNames[MAX_EFFECTS][MAX_EFFECT_NAME_LENGTH] = { "Slowdown", "Fire", "Poison", "RegenMana" };
+std::atomic<int> CEffects::ms_NumEffects{ NUM_BUILTIN_EFFECTS };
+std::mutex CEffects::ms_Lock;
+
+int CEffects::Find(const char* pName)
+{
+	char aName[MAX_EFFECT_NAME_LENGTH];
+	str_copy(aName, pName, sizeof(aName));
+
+	const int NumEffects = ms_NumEffects.load(std::memory_order_acquire);
+	for(int i = 0; i < NumEffects; i++)
+	{
+		if(str_comp(ms_aaNames[i], aName) == 0)
+			return i;
+	}
+	return -1;
+}
+
+int CEffects::Register(const char* pName)
+{
+	int EffectID = Find(pName);
+	if(EffectID >= 0 || !pName[0])
+		return EffectID;
+
+	std::lock_guard<std::mutex> Lock(ms_Lock);
+	EffectID = Find(pName);
+	if(EffectID >= 0)
+		return EffectID;
+
+	const int NumEffects = ms_NumEffects.load(std::memory_order_relaxed);
+	if(NumEffects >= MAX_EFFECTS)
+	{
+		dbg_msg("effects", "no room for the effect '%s', the data has more than %d effects", pName, (int)MAX_EFFECTS);
+		return -1;
+	}
+
+	str_copy(ms_aaNames[NumEffects], pName, sizeof(ms_aaNames[NumEffects]));
+	ms_NumEffects.store(NumEffects + 1, std::memory_order_release);
+	return NumEffects;
+}
+
+const char* CEffects::Name(int EffectID)
+{
+	if(EffectID < 0 || EffectID >= ms_NumEffects.load(std::memory_order_acquire))
+		return "";
+	return ms_aaNames[EffectID];
+}
+
+void CEffectSet::Set(int EffectID, int Seconds)
+{
+	if(EffectID < 0 || EffectID >= MAX_EFFECTS)
+		return;
+
+	m_Active |= 1u << EffectID;
+	m_aSeconds[EffectID] = Seconds;
+}
+
+unsigned CEffectSet::Elapse(int Seconds)
+{
+	unsigned Expired = 0;
+	for(int i = 0; i < MAX_EFFECTS; i++)
+	{
+		if(!IsActive(i))
+			continue;
+
+		m_aSeconds[i] -= Seconds;
+		if(m_aSeconds[i] <= 0)
+			Expired |= 1u << i;
+	}
+	m_Active &= ~Expired;
+	return Expired;
+}
@@ -0,0 +1,56 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#ifndef GAME_SERVER_EFFECTS_H
+#define GAME_SERVER_EFFECTS_H
+
+#include <atomic>
+#include <mutex>
+
+// the effects the game code checks itself, the other names come from the database
+enum
+{
+	EFFECT_SLOWDOWN = 0,
+	EFFECT_FIRE,
+	EFFECT_POISON,
+	EFFECT_REGEN_MANA,
+	NUM_BUILTIN_EFFECTS,
+
+	MAX_EFFECTS = 32,
+	MAX_EFFECT_NAME_LENGTH = 32,
+};
+
+/*
+	Effect names are compiled to small ids when they are loaded. Only the
+	loading of bots, potions and dialog events registers names, names from
+	players are looked up. Names are only ever added, so the worlds look
+	them up without taking the lock.
+*/
+class CEffects
+{
+	static char ms_aaNames[MAX_EFFECTS][MAX_EFFECT_NAME_LENGTH];
+	static std::atomic<int> ms_NumEffects;
+	static std::mutex ms_Lock;
+
+public:
+	static int Find(const char* pName);
+	static int Register(const char* pName);
+	static const char* Name(int EffectID);
+};
+
+// the effects of one player, seconds left indexed by the effect id
+class CEffectSet
+{
+	unsigned m_Active{};
+	int m_aSeconds[MAX_EFFECTS]{};
+
+public:
+	bool Empty() const { return m_Active == 0; }
+	bool IsActive(int EffectID) const { return EffectID >= 0 && (m_Active & (1u << EffectID)) != 0; }
+	void Set(int EffectID, int Seconds);
+	void Clear() { m_Active = 0; }
+
+	// counts the effects down, returns the mask of those that ran out
+	unsigned Elapse(int Seconds);
+};
+
+#endif
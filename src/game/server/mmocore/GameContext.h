@@ -4,6 +4,11 @@
 #ifndef GAME_ENUM_CONTEXT_H
 #define GAME_ENUM_CONTEXT_H
 
+#include <map>
+#include <shared_mutex>
+
+#include "Effects.h"
+
 #define GRAY_COLOR vec3(40, 42, 45)
 #define LIGHT_GRAY_COLOR vec3(15, 15, 16)
 #define SMALL_LIGHT_GRAY_COLOR vec3(10, 11, 11)
@@ -287,12 +292,13 @@ public:
 	{
 		int m_ItemID{};
 		std::string m_Effect{};
+		int m_EffectID{};
 		int m_Recovery{};
 		int m_Time{};
 
 	public:
 		Heal() = delete;
-		Heal(int ItemID, std::string Effect, int Recovery, int Time) : m_ItemID(ItemID), m_Effect(Effect), m_Recovery(Recovery), m_Time(Time) {}
+		Heal(int ItemID, std::string Effect, int Recovery, int Time) : m_ItemID(ItemID), m_Effect(Effect), m_EffectID(CEffects::Register(Effect.c_str())), m_Recovery(Recovery), m_Time(Time) {}
 
 		static const Heal* getHealInfo(int ItemID)
 		{
@@ -303,6 +309,7 @@ public:
 
 		int getItemID() const { return m_ItemID; }
 		const char* getEffect() const { return m_Effect.c_str(); }
+		int getEffectID() const { return m_EffectID; }
 		int getRecovery() const { return m_Recovery; }
 		int getTime() const { return m_Time; }
 	};
@@ -490,4 +497,49 @@ public:
 	static T& Data() { return m_pData; }
 };
 
+// per-client data shared by all worlds. The map itself is searched and changed under a lock,
+// an entry is only used by the world of its client and stays valid until that client is erased
+template < typename T >
+class CClientDataMap
+{
+	std::map < int, T > m_aData;
+	mutable std::shared_mutex m_Lock;
+
+public:
+	T* Find(int ClientID)
+	{
+		std::shared_lock Lock(m_Lock);
+		const auto Iter = m_aData.find(ClientID);
+		return Iter != m_aData.end() ? &Iter->second : nullptr;
+	}
+
+	bool Has(int ClientID) const
+	{
+		std::shared_lock Lock(m_Lock);
+		return m_aData.find(ClientID) != m_aData.end();
+	}
+
+	// finds the entry of the client or creates an empty one
+	T& Get(int ClientID)
+	{
+		if(T* pData = Find(ClientID))
+			return *pData;
+
+		std::unique_lock Lock(m_Lock);
+		return m_aData[ClientID];
+	}
+
+	void Erase(int ClientID)
+	{
+		std::unique_lock Lock(m_Lock);
+		m_aData.erase(ClientID);
+	}
+
+	void Clear()
+	{
+		std::unique_lock Lock(m_Lock);
+		m_aData.clear();
+	}
+};
+
 #endif
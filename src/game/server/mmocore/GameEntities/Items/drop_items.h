@@ -19,6 +19,7 @@ public:
 
 	void Tick() override;
 	void Snap(int SnappingClient) override;
+	bool IsSnapShared() const override { return true; }
 
 	bool TakeItem(int ClientID);
 };
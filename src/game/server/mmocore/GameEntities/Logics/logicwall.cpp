@@ -9,7 +9,7 @@ CLogicWall::CLogicWall(CGameWorld *pGameWorld, vec2 Pos)
 : CEntity(pGameWorld, CGameWorld::ENTTYPE_EYES, Pos)
 {
 	m_RespawnTick = Server()->TickSpeed()*10;
-	pLogicWallLine = new CLogicWallLine(&GS()->m_World, m_Pos);
+	pLogicWallLine = new(&GS()->m_World) CLogicWallLine(&GS()->m_World, m_Pos);
 	GameWorld()->InsertEntity(this);
 }
 
@@ -52,7 +52,7 @@ void CLogicWall::Tick()
 	{
 		pLogicWallLine->SetClientID(pPlayer->GetCID());
 		vec2 Dir = normalize(m_Pos - pPlayer->GetCharacter()->m_Core.m_Pos);
-		new CLogicWallFire(&GS()->m_World, m_Pos, Dir, this);
+		new(&GS()->m_World) CLogicWallFire(&GS()->m_World, m_Pos, Dir, this);
 	}
 }
 
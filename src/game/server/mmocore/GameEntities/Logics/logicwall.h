@@ -14,6 +14,7 @@ class CLogicWallLine : public CEntity
 public:
 	CLogicWallLine(CGameWorld *pGameWorld, vec2 Pos);
 	virtual void Snap(int SnappingClient);
+	virtual bool IsSnapShared() const { return true; }
 	virtual void Tick();
 	void Respawn(bool Spawn);
 	void SetClientID(int ClientID);
@@ -27,6 +28,7 @@ class CLogicWall : public CEntity
 public:
 	CLogicWall(CGameWorld *pGameWorld, vec2 Pos);
 	virtual void Snap(int SnappingClient);
+	virtual bool IsSnapShared() const { return true; }
 	virtual void Tick();
 	void SetDestroy(int Sec);
 private:
@@ -42,6 +44,7 @@ class CLogicWallFire : public CEntity
 public:
 	CLogicWallFire(CGameWorld *pGameWorld, vec2 Pos, vec2 Direction, CLogicWall *Eyes);
 	virtual void Snap(int SnappingClient);
+	virtual bool IsSnapShared() const { return true; }
 	virtual void Tick();
 };
 
@@ -54,6 +57,7 @@ class CLogicWallWall : public CEntity
 public:
 	CLogicWallWall(CGameWorld *pGameWorld, vec2 Pos, int Mode, int Health);
 	virtual void Snap(int SnappingClient);
+	virtual bool IsSnapShared() const { return true; }
 	virtual void Tick();
 
 	void TakeDamage();
@@ -69,6 +73,7 @@ class CLogicDoorKey : public CEntity
 public:
 	CLogicDoorKey(CGameWorld *pGameWorld, vec2 Pos, int ItemID, int Mode);
 	virtual void Snap(int SnappingClient);
+	virtual bool IsSnapShared() const { return true; }
 	virtual void Tick();
 
 };
@@ -81,6 +86,7 @@ class CLogicDungeonDoorKey : public CEntity
 public:
 	CLogicDungeonDoorKey(CGameWorld *pGameWorld, vec2 Pos, int BotID);
 	virtual void Snap(int SnappingClient);
+	virtual bool IsSnapShared() const { return true; }
 	virtual void Tick();
 
 	bool SyncStateChanges();
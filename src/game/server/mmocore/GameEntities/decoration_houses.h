@@ -26,6 +26,7 @@ public:
 	int GetItemID() const { return m_ItemID; }
 
 	void Snap(int SnappingClient) override;
+	bool IsSnapShared() const override { return true; }
 };
 
 #endif
\ No newline at end of file
@@ -75,7 +75,7 @@ bool CJobItems::Interaction(const char* pTool, AttributeIdentifier AttributeDmg,
 	// check equipped
 	if(EquipItem <= 0)
 	{
-		GS()->Broadcast(ClientID, BroadcastPriority::GAME_WARNING, 100, "Need equip {STR}!", Server()->Localization()->Localize(pPlayer->GetLanguage(), pTool));
+		GS()->Broadcast(ClientID, BroadcastPriority::GAME_WARNING, 100, "Need equip {STR}!", Server()->Localization()->Localize(pPlayer->GetLanguageID(), pTool));
 		return false;
 	}
 
@@ -3,47 +3,6 @@
 #include <engine/server.h>
 #include <engine/shared/config.h>
 
-CLolPlasma::CLolPlasma(CGameWorld* pGameWorld, CEntity* pParent, vec2 Pos, vec2 Vel, int Lifespan)
-	: CEntity(pGameWorld, CGameWorld::ENTTYPE_WORLD_TEXT, Pos)
-{
-	m_LocalPos = vec2(0.0f, 0.0f);
-	m_StartOff = Pos;
-	m_Pos = (pParent ? pParent->GetPos() : vec2(0.0f, 0.0f)) + m_StartOff;
-	m_Vel = Vel;
-	m_Life = Lifespan;
-	m_StartTick = Server()->Tick();
-	m_pParent = pParent;
-	GameWorld()->InsertEntity(this);
-}
-
-void CLolPlasma::Tick()
-{
-	m_Life--;
-	if(!m_Life)
-	{
-		GameWorld()->DestroyEntity(this);
-		return;
-	}
-	m_Pos = (m_pParent ? m_pParent->GetPos() : vec2(0.0f, 0.0f)) + m_StartOff + (m_LocalPos += m_Vel);
-}
-
-void CLolPlasma::Snap(int SnappingClient)
-{
-	if(NetworkClipped(SnappingClient))
-		return;
-
-	CNetObj_Projectile* pObj = static_cast<CNetObj_Projectile*>(Server()->SnapNewItem(NETOBJTYPE_PROJECTILE, GetID(), sizeof(CNetObj_Projectile)));
-	if(!pObj)
-		return;
-
-	pObj->m_X = (int)m_Pos.x;
-	pObj->m_Y = (int)m_Pos.y;
-	pObj->m_VelX = 0;
-	pObj->m_VelY = 0;
-	pObj->m_StartTick = Server()->Tick();
-	pObj->m_Type = WEAPON_HAMMER;
-}
-
 static bool s_aaaChars[256][5][3] = {
 	{ {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0} }, // ascii 0
 	{ {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0}, {0,0,0} }, // ascii 1
@@ -307,7 +266,7 @@ inline static bool HasRepr(char c) // can be removed when we have a full charact
 {
 	for(int y = 0; y < 5; ++y)
 		for(int x = 0; x < 3; ++x)
-			if(s_aaaChars[(unsigned)c][y][x])
+			if(s_aaaChars[(unsigned char)c][y][x])
 				return true;
 	return false;
 }
@@ -327,21 +286,42 @@ inline static vec2 TextSize(const char* pText)
 	return vec2(Count * g_Config.m_SvLoltextHspace * 4.0f, g_Config.m_SvLoltextVspace);
 }
 
-void CLoltext::Create(CGameWorld* pGameWorld, CEntity* pParent, vec2 Pos, vec2 Vel, int Lifespan, const char* pText, bool Center, bool Follow)
+CLoltext::CLoltext(CGameWorld* pGameWorld, CEntity* pParent, vec2 Pos, vec2 Vel, int Lifespan, const char* pText, bool Follow)
+	: CEntity(pGameWorld, CGameWorld::ENTTYPE_WORLD_TEXT, Pos)
 {
-	vec2 CurPos = Pos;
-	if(Center)
-		CurPos -= TextSize(pText) * 0.5f;
+	m_pParent = Follow ? pParent : nullptr;
+	m_StartOff = (pParent && !Follow) ? pParent->GetPos() + Pos : Pos;
+	m_LocalPos = vec2(0.0f, 0.0f);
+	m_Vel = Vel;
+	m_CenterOff = vec2(0.0f, 0.0f);
+	m_Life = Lifespan;
+	m_aText[0] = '\0';
+	SetText(pText);
+	GameWorld()->InsertEntity(this);
+}
 
-	if(pParent && !Follow)
+CLoltext::~CLoltext()
+{
+	for(const int ID : m_aIDs)
+		Server()->SnapFreeID(ID);
+}
+
+void CLoltext::SetText(const char* pText)
+{
+	if(str_comp(m_aText, pText) == 0)
 	{
-		CurPos += pParent->GetPos();
-		pParent = 0;
+		m_Pos = AnchorPos() + m_CenterOff;
+		return;
 	}
 
-	char c;
-	while((c = *pText++))
+	str_copy(m_aText, pText, sizeof(m_aText));
+	m_aPoints.clear();
+
+	// the text is centered on the anchor
+	vec2 CurPos = -TextSize(m_aText) * 0.5f;
+	for(const char* pChar = m_aText; *pChar; pChar++)
 	{
+		char c = *pChar;
 		if(c >= 'a' && c <= 'z')
 			c -= ('a' - 'A');
 		if(c != ' ' && !HasRepr(c))
@@ -349,8 +329,57 @@ void CLoltext::Create(CGameWorld* pGameWorld, CEntity* pParent, vec2 Pos, vec2 V
 
 		for(int y = 0; y < 5/*XXX*/; ++y)
 			for(int x = 0; x < 3/*XXX*/; ++x)
-				if(s_aaaChars[(unsigned)c][y][x])
-					new CLolPlasma(pGameWorld, pParent, CurPos + vec2(x * g_Config.m_SvLoltextHspace, y * g_Config.m_SvLoltextVspace), Vel, Lifespan);
+				if(s_aaaChars[(unsigned char)c][y][x])
+					m_aPoints.push_back(CurPos + vec2(x * g_Config.m_SvLoltextHspace, y * g_Config.m_SvLoltextVspace));
 		CurPos.x += 4 * g_Config.m_SvLoltextHspace;
 	}
-}
\ No newline at end of file
+
+	// the entity is in the middle of its points, so it is clipped like them
+	vec2 Min = m_aPoints.empty() ? vec2(0.0f, 0.0f) : m_aPoints[0];
+	vec2 Max = Min;
+	for(const vec2& Point : m_aPoints)
+	{
+		Min = vec2(min(Min.x, Point.x), min(Min.y, Point.y));
+		Max = vec2(max(Max.x, Point.x), max(Max.y, Point.y));
+	}
+	m_CenterOff = (Min + Max) * 0.5f;
+	for(vec2& Point : m_aPoints)
+		Point -= m_CenterOff;
+
+	while(m_aIDs.size() < m_aPoints.size())
+		m_aIDs.push_back(Server()->SnapNewID());
+	m_Pos = AnchorPos() + m_CenterOff;
+}
+
+void CLoltext::Tick()
+{
+	if(m_Life > 0 && --m_Life == 0)
+	{
+		GameWorld()->DestroyEntity(this);
+		return;
+	}
+
+	m_LocalPos += m_Vel;
+	m_Pos = AnchorPos() + m_CenterOff;
+}
+
+void CLoltext::Snap(int SnappingClient)
+{
+	for(size_t i = 0; i < m_aPoints.size(); i++)
+	{
+		const vec2 Pos = m_Pos + m_aPoints[i];
+		if(NetworkClipped(SnappingClient, Pos))
+			continue;
+
+		CNetObj_Projectile* pObj = static_cast<CNetObj_Projectile*>(Server()->SnapNewItem(NETOBJTYPE_PROJECTILE, m_aIDs[i], sizeof(CNetObj_Projectile)));
+		if(!pObj)
+			return;
+
+		pObj->m_X = (int)Pos.x;
+		pObj->m_Y = (int)Pos.y;
+		pObj->m_VelX = 0;
+		pObj->m_VelY = 0;
+		pObj->m_StartTick = Server()->Tick();
+		pObj->m_Type = WEAPON_HAMMER;
+	}
+}
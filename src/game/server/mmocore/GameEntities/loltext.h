@@ -2,27 +2,33 @@
 #define GAME_SERVER_ENTITIES_LOLTEXT_H
 #include <game/server/entity.h>
 
-class CLolPlasma : public CEntity
+/*
+	Text drawn with projectiles. The points of the glyphs are computed when
+	the text changes and keep their snap ids, the entity snaps all of them
+	itself. A text with a lifespan below one stays until it is destroyed.
+*/
+class CLoltext : public CEntity
 {
-	vec2 m_LocalPos; // local coordinate system is origin'd wherever we actually start (i.e. this is (0,0) after creation)
+	CEntity* m_pParent;
+	vec2 m_StartOff; // from the parent or the world origin to the anchor of the text
+	vec2 m_LocalPos; // distance moved since creation
 	vec2 m_Vel;
+	vec2 m_CenterOff; // from the anchor to the middle of the glyphs
 	int m_Life; // remaining ticks
-	int m_StartTick; // tick created
-	vec2 m_StartOff; // initial offset from parent, for proper following
-	CEntity* m_pParent;
+	char m_aText[64];
+	std::vector<vec2> m_aPoints; // relative to m_Pos
+	std::vector<int> m_aIDs;
+
+	vec2 AnchorPos() const { return (m_pParent ? m_pParent->GetPos() : vec2(0.0f, 0.0f)) + m_StartOff + m_LocalPos; }
 
 public:
-	CLolPlasma(CGameWorld* pGameWorld, CEntity* pParent, vec2 Pos, vec2 Vel, int Lifespan);
+	CLoltext(CGameWorld* pGameWorld, CEntity* pParent, vec2 Pos, vec2 Vel, int Lifespan, const char* pText, bool Follow);
+	~CLoltext() override;
+
+	void SetText(const char* pText);
 
 	void Tick() override;
 	void Snap(int SnappingClient) override;
 };
 
-class CLoltext
-{
-public:
-	void Create(CGameWorld *pGameWorld, CEntity *pParent, vec2 Pos, vec2 Vel, int Lifespan, const char *pText, bool Center, bool Follow);
-};
-
 #endif
-
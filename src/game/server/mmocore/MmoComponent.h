@@ -24,7 +24,9 @@ public:
 private:
 	virtual void OnInitWorld(const char* pWhereLocalWorld) {};
 	virtual void OnInit() {};
-	virtual void OnInitAccount(class CPlayer* pPlayer) {};
+	// rows of this table owned by the account are selected off the tick thread while the account loads
+	virtual const char* GetAccountTable() const { return nullptr; }
+	virtual void OnInitAccount(class CPlayer* pPlayer, ResultPtr& pRes) {};
 	virtual void OnTick() {};
 	virtual void OnResetClient(int ClientID) {};
 	virtual bool OnMessage(int MsgID, void* pRawMsg, int ClientID) { return false; };
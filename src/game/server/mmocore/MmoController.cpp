@@ -20,6 +20,7 @@
 #include "Components/Inventory/InventoryCore.h"
 #include "Components/Mails/MailBoxCore.h"
 #include "Components/Quests/QuestCore.h"
+#include "Components/Rankings/RankingCore.h"
 #include "Components/Skills/SkillsCore.h"
 #include "Components/Warehouse/WarehouseCore.h"
 #include "Components/Worlds/WorldCore.h"
@@ -45,6 +46,7 @@ MmoController::MmoController(CGS *pGameServer) : m_pGameServer(pGameServer)
 	m_Components.add(m_pAccMiner = new CAccountMinerCore);
 	m_Components.add(m_pAccPlant = new CAccountPlantCore);
 	m_Components.add(m_pMailBoxJob = new CMailBoxCore);
+	m_Components.add(new CRankingCore);
 
 	for(auto& pComponent : m_Components.m_paComponents)
 	{
@@ -86,14 +88,30 @@ bool MmoController::OnMessage(int MsgID, void* pRawMsg, int ClientID)
 	return false;
 }
 
-void MmoController::OnInitAccount(int ClientID)
+std::vector<const char*> MmoController::GetAccountTables() const
+{
+	std::vector<const char*> apTables;
+	for(const auto& pComponent : m_Components.m_paComponents)
+	{
+		if(const char* pTable = pComponent->GetAccountTable())
+			apTables.push_back(pTable);
+	}
+	return apTables;
+}
+
+// the results are in the order of GetAccountTables()
+void MmoController::OnInitAccount(int ClientID, std::vector<ResultPtr>& apResults)
 {
 	CPlayer *pPlayer = GS()->GetPlayer(ClientID);
 	if(!pPlayer || !pPlayer->IsAuthed())
 		return;
 
+	size_t Result = 0;
 	for(auto& pComponent : m_Components.m_paComponents)
-		pComponent->OnInitAccount(pPlayer);
+	{
+		if(pComponent->GetAccountTable())
+			pComponent->OnInitAccount(pPlayer, apResults[Result++]);
+	}
 }
 
 bool MmoController::OnPlayerHandleMainMenu(int ClientID, int Menulist)
@@ -324,7 +342,8 @@ void MmoController::SaveAccount(CPlayer *pPlayer, int Table) const
 
 	if(Table == SAVE_STATS)
 	{
-		Database->Execute<DB::UPDATE>("tw_accounts_data", "Level = '%d', Exp = '%d' WHERE ID = '%d'", pPlayer->Acc().m_Level, pPlayer->Acc().m_Exp, pPlayer->Acc().m_UserID);
+		Database->ExecuteBind<DB::UPDATE>("tw_accounts_data", "Level = ?, Exp = ? WHERE ID = ?", pPlayer->Acc().m_Level, pPlayer->Acc().m_Exp, pPlayer->Acc().m_UserID);
+		CRankingCore::UpdateAccountLevel(pPlayer->Acc().m_UserID, pPlayer->Acc().m_Level, pPlayer->Acc().m_Exp);
 	}
 	else if(Table == SAVE_UPGRADES)
 	{
@@ -354,16 +373,16 @@ void MmoController::SaveAccount(CPlayer *pPlayer, int Table) const
 	}
 	else if(Table == SAVE_GUILD_DATA)
 	{
-		Database->Execute<DB::UPDATE>("tw_accounts_data", "GuildID = '%d', GuildRank = '%d' WHERE ID = '%d'", pPlayer->Acc().m_GuildID, pPlayer->Acc().m_GuildRank, pPlayer->Acc().m_UserID);
+		Database->ExecuteBind<DB::UPDATE>("tw_accounts_data", "GuildID = ?, GuildRank = ? WHERE ID = ?", pPlayer->Acc().m_GuildID, pPlayer->Acc().m_GuildRank, pPlayer->Acc().m_UserID);
 	}
 	else if(Table == SAVE_POSITION)
 	{
 		const int LatestCorrectWorldID = Account()->GetHistoryLatestCorrectWorldID(pPlayer);
-		Database->Execute<DB::UPDATE>("tw_accounts_data", "WorldID = '%d' WHERE ID = '%d'", LatestCorrectWorldID, pPlayer->Acc().m_UserID);
+		Database->ExecuteBind<DB::UPDATE>("tw_accounts_data", "WorldID = ? WHERE ID = ?", LatestCorrectWorldID, pPlayer->Acc().m_UserID);
 	}
 	else if(Table == SAVE_LANGUAGE)
 	{
-		Database->Execute<DB::UPDATE>("tw_accounts", "Language = '%s' WHERE ID = '%d'", pPlayer->GetLanguage(), pPlayer->Acc().m_UserID);
+		Database->ExecuteBind<DB::UPDATE>("tw_accounts", "Language = ? WHERE ID = ?", pPlayer->GetLanguage(), pPlayer->Acc().m_UserID);
 	}
 	else
 	{
@@ -403,72 +422,22 @@ void MmoController::ShowLoadingProgress(const char* pLoading, int Size) const
 
 void MmoController::ShowTopList(int ClientID, ToplistType Type, bool ChatGlobalMode, int Limit) const
 {
-	if(Type == ToplistType::GUILDS_LEVELING)
+	const bool IsLeveling = (Type == ToplistType::GUILDS_LEVELING || Type == ToplistType::PLAYERS_LEVELING);
+	for(const auto& Entry : CRankingCore::GetTop(Type, Limit))
 	{
-		ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_guilds", "ORDER BY Level DESC, Experience DESC LIMIT %d", Limit);
-		while (pRes->next())
+		if(IsLeveling)
 		{
-			char NameGuild[64];
-			const int Rank = pRes->getRow();
-			const int Level = pRes->getInt("Level");
-			const int Experience = pRes->getInt("Experience");
-			str_copy(NameGuild, pRes->getString("Name").c_str(), sizeof(NameGuild));
-
 			if(ChatGlobalMode)
-				GS()->Chat(-1, "{INT}. {STR} :: Level {INT} : Exp {INT}", Rank, NameGuild, Level, Experience);
+				GS()->Chat(-1, "{INT}. {STR} :: Level {INT} : Exp {INT}", Entry.m_Rank, Entry.m_aName, Entry.m_Level, Entry.m_Value);
 			else
-				GS()->AVL(ClientID, "null", "{INT}. {STR} :: Level {INT} : Exp {INT}", Rank, NameGuild, Level, Experience);
+				GS()->AVL(ClientID, "null", "{INT}. {STR} :: Level {INT} : Exp {INT}", Entry.m_Rank, Entry.m_aName, Entry.m_Level, Entry.m_Value);
 		}
-	}
-	else if (Type == ToplistType::GUILDS_WEALTHY)
-	{
-		ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_guilds", "ORDER BY Bank DESC LIMIT %d", Limit);
-		while (pRes->next())
-		{
-			char NameGuild[64];
-			const int Rank = pRes->getRow();
-			const int Gold = pRes->getInt("Bank");
-			str_copy(NameGuild, pRes->getString("Name").c_str(), sizeof(NameGuild));
-
-			if(ChatGlobalMode)
-				GS()->Chat(-1, "{INT}. {STR} :: Gold {VAL}", Rank, NameGuild, Gold);
-			else
-				GS()->AVL(ClientID, "null", "{INT}. {STR} :: Gold {VAL}", Rank, NameGuild, Gold);
-		}
-	}
-	else if (Type == ToplistType::PLAYERS_LEVELING)
-	{
-		ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_accounts_data", "ORDER BY Level DESC, Exp DESC LIMIT %d", Limit);
-		while (pRes->next())
-		{
-			char Nick[64];
-			const int Rank = pRes->getRow();
-			const int Level = pRes->getInt("Level");
-			const int Experience = pRes->getInt("Exp");
-			str_copy(Nick, pRes->getString("Nick").c_str(), sizeof(Nick));
-
-			if(ChatGlobalMode)
-				GS()->Chat(-1, "{INT}. {STR} :: Level {INT} : Exp {INT}", Rank, Nick, Level, Experience);
-			else
-				GS()->AVL(ClientID, "null", "{INT}. {STR} :: Level {INT} : Exp {INT}", Rank, Nick, Level, Experience);
-
-		}
-	}
-	else if (Type == ToplistType::PLAYERS_WEALTHY)
-	{
-		ResultPtr pRes = Database->Execute<DB::SELECT>("*", "tw_accounts_items", "WHERE ItemID = '%d' ORDER BY Value DESC LIMIT %d", (ItemIdentifier)itGold, Limit);
-		while (pRes->next())
+		else
 		{
-			char Nick[64];
-			const int Rank = pRes->getRow();
-			const int Gold = pRes->getInt("Value");
-			const int UserID = pRes->getInt("UserID");
-			str_copy(Nick, PlayerName(UserID), sizeof(Nick));
-
 			if(ChatGlobalMode)
-				GS()->Chat(-1, "{INT}. {STR} :: Gold {VAL}", Rank, Nick, Gold);
+				GS()->Chat(-1, "{INT}. {STR} :: Gold {VAL}", Entry.m_Rank, Entry.m_aName, Entry.m_Value);
 			else
-				GS()->AVL(ClientID, "null", "{INT}. {STR} :: Gold {VAL}", Rank, Nick, Gold);
+				GS()->AVL(ClientID, "null", "{INT}. {STR} :: Gold {VAL}", Entry.m_Rank, Entry.m_aName, Entry.m_Value);
 		}
 	}
 }
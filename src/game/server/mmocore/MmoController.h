@@ -76,7 +76,8 @@ public:
 	bool OnMessage(int MsgID, void* pRawMsg, int ClientID);
 	bool OnPlayerHandleTile(CCharacter *pChr, int IndexCollision);
 	bool OnPlayerHandleMainMenu(int ClientID, int Menulist);
-	void OnInitAccount(int ClientID);
+	std::vector<const char*> GetAccountTables() const;
+	void OnInitAccount(int ClientID, std::vector<ResultPtr>& apResults);
 	bool OnParsingVoteCommands(CPlayer *pPlayer, const char *CMD, int VoteID, int VoteID2, int Get, const char *GetText);
 	void ResetClientData(int ClientID);
 
@@ -1,203 +1,713 @@
 /* Pathfind class by Sushi */
 #include "PathFinder.h"
 
+#include <engine/shared/config.h>
+
 #include <game/collision.h>
 #include <game/layers.h>
 #include <game/mapitems.h>
 
-CPathfinder::CPathfinder(CLayers* Layers, CCollision* Collision) : m_pLayers(Layers), m_pCollision(Collision)
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+
+static constexpr int CLUSTER_SIZE = 16;
+static constexpr int MAX_CACHED_ROUTES = 64;
+
+// the threads are shared by all worlds and live as long as any world does
+class CPathfinderWorkers
 {
-	m_ClosedNodes = 0;
-	m_FinalSize = 0;
-	m_StartIndex = -1;
-	m_EndIndex = -1;
+	struct CJob
+	{
+		CPathfinder* m_pPathfinder;
+		int m_ClientID;
+	};
+
+	std::vector<std::thread> m_aThreads;
+	std::deque<CJob> m_aJobs;
+	bool m_Shutdown;
+
+	void WorkerThread();
+
+public:
+	std::mutex m_Lock;
+	std::condition_variable m_WakeUp;
+	std::condition_variable m_Finished;
+
+	CPathfinderWorkers(int NumThreads);
+	~CPathfinderWorkers();
+
+	void Push(CPathfinder* pPathfinder, int ClientID);
+	void RemoveAll(CPathfinder* pPathfinder);
+
+	static std::shared_ptr<CPathfinderWorkers> Get();
+};
+
+std::shared_ptr<CPathfinderWorkers> CPathfinderWorkers::Get()
+{
+	static std::mutex s_Lock;
+	static std::weak_ptr<CPathfinderWorkers> s_pWorkers;
+
+	std::lock_guard<std::mutex> Lock(s_Lock);
+	std::shared_ptr<CPathfinderWorkers> pWorkers = s_pWorkers.lock();
+	if(!pWorkers)
+	{
+		pWorkers = std::make_shared<CPathfinderWorkers>(g_Config.m_SvPathfinderThreads);
+		s_pWorkers = pWorkers;
+	}
+	return pWorkers;
+}
+
+CPathfinderWorkers::CPathfinderWorkers(int NumThreads)
+{
+	m_Shutdown = false;
+	for(int i = 0; i < NumThreads; i++)
+		m_aThreads.emplace_back(&CPathfinderWorkers::WorkerThread, this);
+}
+
+CPathfinderWorkers::~CPathfinderWorkers()
+{
+	{
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		m_Shutdown = true;
+	}
+	m_WakeUp.notify_all();
+
+	for(auto& Thread : m_aThreads)
+		Thread.join();
+}
 
-	m_LayerWidth = m_pLayers->GameLayer()->m_Width;
-	m_LayerHeight = m_pLayers->GameLayer()->m_Height;
+void CPathfinderWorkers::Push(CPathfinder* pPathfinder, int ClientID)
+{
+	m_aJobs.push_back({ pPathfinder, ClientID });
+	m_WakeUp.notify_one();
+}
 
-	// set size for array
-	m_lMap.set_size(m_LayerWidth * m_LayerHeight);
-	m_lNodes.set_size(m_LayerWidth * m_LayerHeight);
-	m_lFinalPath.set_size(MAX_WAY_CALC);
+void CPathfinderWorkers::RemoveAll(CPathfinder* pPathfinder)
+{
+	for(auto pJob = m_aJobs.begin(); pJob != m_aJobs.end();)
+	{
+		if(pJob->m_pPathfinder == pPathfinder)
+		{
+			pJob = m_aJobs.erase(pJob);
+			continue;
+		}
+		++pJob;
+	}
+}
 
-	// init size for heap
-	m_Open.SetSize(4 * MAX_WAY_CALC);
+void CPathfinderWorkers::WorkerThread()
+{
+	CPathfinder::CScratch Scratch;
+	std::vector<vec2> aWayPoints;
 
-	int ID = 0;
-	for (int i = 0; i < m_LayerHeight; i++)
+	while(true)
 	{
-		for (int j = 0; j < m_LayerWidth; j++)
+		CJob Job;
+		CPathfinder::CRequest Request;
 		{
-			CNode Node;
-			Node.m_Pos = vec2(j, i);
-			Node.m_Parent = -1;
-			Node.m_ID = ID;
-			Node.m_G = 0;
-			Node.m_H = 0;
-			Node.m_F = 0;
-			Node.m_IsClosed = false;
-			Node.m_IsOpen = false;
-			if (m_pCollision->CheckPoint(j * 32 + 16, i * 32 + 16))
-				Node.m_IsCol = true;
-			else
-				Node.m_IsCol = false;
-
-			// add the node to the list
-			m_lMap[i * m_LayerWidth + j] = Node;
-			ID++;
+			std::unique_lock<std::mutex> Lock(m_Lock);
+			m_WakeUp.wait(Lock, [this]() { return m_Shutdown || !m_aJobs.empty(); });
+			if(m_Shutdown)
+				return;
+
+			Job = m_aJobs.front();
+			m_aJobs.pop_front();
+
+			// the request may have been replaced by a newer one or cancelled while it was queued
+			CPathfinder::CRequest& QueuedRequest = Job.m_pPathfinder->m_aRequests[Job.m_ClientID];
+			if(!QueuedRequest.m_Queued)
+				continue;
+
+			Request = QueuedRequest;
+			QueuedRequest.m_Queued = false;
+			Job.m_pPathfinder->m_NumRunning++;
+		}
+
+		aWayPoints.clear();
+		Job.m_pPathfinder->FindPath(Scratch, Request.m_StartPos, Request.m_EndPos, aWayPoints);
+
+		{
+			std::lock_guard<std::mutex> Lock(Job.m_pPathfinder->m_ResultsLock);
+			Job.m_pPathfinder->m_aResults.push_back({ Job.m_ClientID, Request.m_Sequence, aWayPoints });
 		}
+
+		std::lock_guard<std::mutex> Lock(m_Lock);
+		if(--Job.m_pPathfinder->m_NumRunning == 0)
+			m_Finished.notify_all();
+	}
+}
+
+void CPathfinder::CNodeSet::Begin(int Size)
+{
+	if((int)m_aNodes.size() < Size)
+		m_aNodes.resize(Size, CNode{ 0 });
+
+	// nodes of the previous searches become invalid without touching them
+	if(++m_Generation == 0)
+	{
+		for(auto& Node : m_aNodes)
+			Node.m_Stamp = 0;
+		m_Generation = 1;
 	}
 }
 
+CPathfinder::CNode& CPathfinder::CNodeSet::Node(int Index)
+{
+	CNode& Node = m_aNodes[Index];
+	if(Node.m_Stamp != m_Generation)
+	{
+		Node.m_Stamp = m_Generation;
+		Node.m_Parent = -1;
+		Node.m_G = 0;
+		Node.m_H = 0;
+		Node.m_F = 0;
+		Node.m_IsClosed = false;
+		Node.m_IsOpen = false;
+	}
+	return Node;
+}
+
+CPathfinder::CPathfinder(CLayers* Layers, CCollision* Collision)
+{
+	m_LayerWidth = Layers->GameLayer()->m_Width;
+	m_LayerHeight = Layers->GameLayer()->m_Height;
+	m_NumRunning = 0;
+
+	m_aCollision.resize(m_LayerWidth * m_LayerHeight);
+	for(int i = 0; i < m_LayerHeight; i++)
+	{
+		for(int j = 0; j < m_LayerWidth; j++)
+			m_aCollision[i * m_LayerWidth + j] = Collision->CheckPoint(j * 32 + 16, i * 32 + 16);
+	}
+
+	for(int i = 0; i < MAX_CLIENTS; i++)
+	{
+		m_aRequests[i].m_Queued = false;
+		m_aSequence[i] = 0;
+		m_aPending[i] = false;
+	}
+
+	BuildClusters();
+	m_pWorkers = CPathfinderWorkers::Get();
+}
+
 CPathfinder::~CPathfinder()
 {
-	m_lMap.clear();
-	m_lFinalPath.clear();
-	m_lNodes.clear();
+	std::unique_lock<std::mutex> Lock(m_pWorkers->m_Lock);
+	m_pWorkers->RemoveAll(this);
+	m_pWorkers->m_Finished.wait(Lock, [this]() { return m_NumRunning == 0; });
 }
 
-void CPathfinder::Init()
+void CPathfinder::RequestPath(int ClientID, vec2 StartPos, vec2 EndPos)
 {
-	m_ClosedNodes = 0;
-	m_FinalSize = 0;
-	m_Open.MakeEmpty();
-	m_lNodes = m_lMap;
+	if(ClientID < 0 || ClientID >= MAX_CLIENTS || length(StartPos) <= 0 || length(EndPos) <= 0)
+		return;
+
+	m_aPending[ClientID] = true;
+	const int Sequence = ++m_aSequence[ClientID];
+
+	std::lock_guard<std::mutex> Lock(m_pWorkers->m_Lock);
+	CRequest& Request = m_aRequests[ClientID];
+	Request.m_Sequence = Sequence;
+	Request.m_StartPos = StartPos;
+	Request.m_EndPos = EndPos;
+	if(!Request.m_Queued)
+	{
+		Request.m_Queued = true;
+		m_pWorkers->Push(this, ClientID);
+	}
 }
 
-void CPathfinder::SetStart(vec2 Pos)
+void CPathfinder::CancelRequest(int ClientID)
 {
-	int StartX = clamp((int)(Pos.x / 32.0f), 0, m_LayerWidth);
-	int StartY = clamp((int)(Pos.y / 32.0f), 0, m_LayerHeight);
+	if(ClientID < 0 || ClientID >= MAX_CLIENTS || !m_aPending[ClientID])
+		return;
+
+	// a result of a search that is already running is dropped by its sequence
+	m_aPending[ClientID] = false;
+	m_aSequence[ClientID]++;
 
-	int Index = GetIndex(StartX, StartY);
-	m_lNodes[Index].m_Parent = START;
-	m_lNodes[Index].m_IsClosed = true;
-	m_ClosedNodes++;
-	m_StartIndex = Index;
+	// the queued job is skipped by the worker
+	std::lock_guard<std::mutex> Lock(m_pWorkers->m_Lock);
+	m_aRequests[ClientID].m_Queued = false;
 }
 
-void CPathfinder::SetEnd(vec2 Pos)
+void CPathfinder::Update(const PathCallback& Callback)
 {
-	int EndX = clamp((int)(Pos.x / 32.0f), 0, m_LayerWidth);
-	int EndY = clamp((int)(Pos.y / 32.0f), 0, m_LayerHeight);
+	std::vector<CResult> aResults;
+	{
+		std::lock_guard<std::mutex> Lock(m_ResultsLock);
+		if(m_aResults.empty())
+			return;
+		aResults.swap(m_aResults);
+	}
+
+	for(auto& Result : aResults)
+	{
+		if(Result.m_Sequence != m_aSequence[Result.m_ClientID])
+			continue;
 
-	int Index = GetIndex(EndX, EndY);
-	m_lNodes[Index].m_Parent = END;
-	m_EndIndex = Index;
+		m_aPending[Result.m_ClientID] = false;
+		Callback(Result.m_ClientID, std::move(Result.m_aWayPoints));
+	}
 }
 
+int CPathfinder::GetIndex(vec2 Pos) const
+{
+	const int X = clamp((int)(Pos.x / 32.0f), 0, m_LayerWidth - 1);
+	const int Y = clamp((int)(Pos.y / 32.0f), 0, m_LayerHeight - 1);
+	return X + m_LayerWidth * Y;
+}
 
-int CPathfinder::GetIndex(int XPos, int YPos) const
+int CPathfinder::GetCluster(int Index) const
 {
-	return XPos + m_pLayers->GameLayer()->m_Width * YPos;
+	return (Index % m_LayerWidth) / CLUSTER_SIZE + ((Index / m_LayerWidth) / CLUSTER_SIZE) * m_ClustersX;
 }
 
-void CPathfinder::FindPath()
+int CPathfinder::AddPortal(int Tile)
 {
-	int CurrentIndex = m_StartIndex;
-	if (m_StartIndex > -1 && m_EndIndex > -1)
+	if(const auto Iter = m_aTilePortal.find(Tile); Iter != m_aTilePortal.end())
+		return Iter->second;
+
+	const int Portal = (int)m_aPortals.size();
+	m_aPortals.push_back({ Tile, GetCluster(Tile), {} });
+	m_aClusterPortals[m_aPortals.back().m_Cluster].push_back(Portal);
+	m_aTilePortal[Tile] = Portal;
+	return Portal;
+}
+
+void CPathfinder::BuildClusters()
+{
+	m_ClustersX = (m_LayerWidth + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	m_ClustersY = (m_LayerHeight + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+	m_aClusterPortals.resize(m_ClustersX * m_ClustersY);
+
+	// every free run along the border of two clusters is an entrance, short runs get
+	// one portal pair in the middle and long runs one at each end
+	auto AddEntrances = [this](int FirstA, int FirstB, int Step, int Length)
 	{
-		while (m_ClosedNodes < MAX_WAY_CALC && m_lNodes[CurrentIndex].m_ID != m_EndIndex)
+		int RunStart = -1;
+		for(int i = 0; i <= Length; i++)
 		{
-			for (int i = 0; i < 4; i++)
+			const bool Free = i < Length && !m_aCollision[FirstA + i * Step] && !m_aCollision[FirstB + i * Step];
+			if(Free && RunStart < 0)
+				RunStart = i;
+			if(Free || RunStart < 0)
+				continue;
+
+			const int RunEnd = i - 1;
+			const int aOffsets[2] = { RunStart, RunEnd };
+			const bool Long = RunEnd - RunStart + 1 >= CLUSTER_SIZE / 2;
+			for(int j = 0; j < (Long ? 2 : 1); j++)
 			{
-				// get the working index
-				int WorkingIndex = -1;
-
-				switch (i)
-				{
-				case 0:
-					if (CurrentIndex + 1 < m_lNodes.size())
-						WorkingIndex = CurrentIndex + 1;
-					break;
-				case 1:
-					if (CurrentIndex - 1 >= 0)
-						WorkingIndex = CurrentIndex - 1;
-					break;
-				case 2:
-					if (CurrentIndex + m_LayerWidth < m_lNodes.size())
-						WorkingIndex = CurrentIndex + m_LayerWidth;
-					break;
-				case 3:
-					if (CurrentIndex - m_LayerWidth >= 0)
-						WorkingIndex = CurrentIndex - m_LayerWidth;
-				}
-
-				if (WorkingIndex > -1 && !m_lNodes[WorkingIndex].m_IsCol && !m_lNodes[WorkingIndex].m_IsClosed)
-				{
-					if (!m_lNodes[WorkingIndex].m_IsOpen)
-					{
-						// set its parent
-						m_lNodes[WorkingIndex].m_Parent = CurrentIndex;
-
-						// calculate the important values
-						m_lNodes[WorkingIndex].m_G = m_lNodes[CurrentIndex].m_G + 1;
-						m_lNodes[WorkingIndex].m_H = (abs((int)(m_lNodes[WorkingIndex].m_Pos.x - m_lNodes[m_EndIndex].m_Pos.x)) + abs((int)(m_lNodes[WorkingIndex].m_Pos.y - m_lNodes[m_EndIndex].m_Pos.y)));
-						m_lNodes[WorkingIndex].m_F = m_lNodes[WorkingIndex].m_G + m_lNodes[WorkingIndex].m_H;
-
-						m_lNodes[WorkingIndex].m_IsOpen = true;
-
-						m_Open.Insert(m_lNodes[WorkingIndex]);
-					}
-					else
-					{
-						// recalculate the G and F Value
-						if (m_lNodes[WorkingIndex].m_G > m_lNodes[CurrentIndex].m_G + 1)
-						{
-							// set new parent
-							m_lNodes[WorkingIndex].m_Parent = CurrentIndex;
-
-							// important values (H value wont change)
-							m_lNodes[WorkingIndex].m_G = m_lNodes[CurrentIndex].m_G + 1;
-							m_lNodes[WorkingIndex].m_F = m_lNodes[WorkingIndex].m_G + m_lNodes[WorkingIndex].m_H;
-
-							m_Open.Replace(m_lNodes[WorkingIndex]);
-						}
-					}
-				}
+				const int Offset = Long ? aOffsets[j] : (RunStart + RunEnd) / 2;
+				const int PortalA = AddPortal(FirstA + Offset * Step);
+				const int PortalB = AddPortal(FirstB + Offset * Step);
+				m_aPortals[PortalA].m_aEdges.emplace_back(PortalB, 1);
+				m_aPortals[PortalB].m_aEdges.emplace_back(PortalA, 1);
 			}
+			RunStart = -1;
+		}
+	};
 
-			if (m_Open.GetSize() < 1)
-				return;
+	for(int cy = 0; cy < m_ClustersY; cy++)
+	{
+		for(int cx = 0; cx < m_ClustersX; cx++)
+		{
+			const int X = cx * CLUSTER_SIZE;
+			const int Y = cy * CLUSTER_SIZE;
+			if(X + CLUSTER_SIZE < m_LayerWidth)
+				AddEntrances(Y * m_LayerWidth + X + CLUSTER_SIZE - 1, Y * m_LayerWidth + X + CLUSTER_SIZE, m_LayerWidth, min(CLUSTER_SIZE, m_LayerHeight - Y));
+			if(Y + CLUSTER_SIZE < m_LayerHeight)
+				AddEntrances((Y + CLUSTER_SIZE - 1) * m_LayerWidth + X, (Y + CLUSTER_SIZE) * m_LayerWidth + X, 1, min(CLUSTER_SIZE, m_LayerWidth - X));
+		}
+	}
 
-			// get Lowest F from heap and set new CurrentIndex
-			CurrentIndex = m_Open.GetMin()->m_ID;
+	// distances between the portals inside of each cluster
+	CScratch Scratch;
+	for(int Cluster = 0; Cluster < (int)m_aClusterPortals.size(); Cluster++)
+	{
+		for(int Portal : m_aClusterPortals[Cluster])
+		{
+			SearchCluster(Scratch, Cluster, m_aPortals[Portal].m_Tile);
+			for(int Other : m_aClusterPortals[Cluster])
+			{
+				CNode& Node = Scratch.m_Tiles.Node(m_aPortals[Other].m_Tile);
+				if(Other != Portal && Node.m_IsClosed)
+					m_aPortals[Portal].m_aEdges.emplace_back(Other, Node.m_G);
+			}
+		}
+	}
+}
 
-			// delete it \o/
-			m_Open.RemoveMin();
+void CPathfinder::SearchCluster(CScratch& Scratch, int Cluster, int From) const
+{
+	// breadth first, every step costs the same so the distances are exact
+	const int StartX = (Cluster % m_ClustersX) * CLUSTER_SIZE;
+	const int StartY = (Cluster / m_ClustersX) * CLUSTER_SIZE;
+	const int EndX = min(StartX + CLUSTER_SIZE, m_LayerWidth);
+	const int EndY = min(StartY + CLUSTER_SIZE, m_LayerHeight);
+
+	CNodeSet& Nodes = Scratch.m_Tiles;
+	Nodes.Begin(m_LayerWidth * m_LayerHeight);
+	Nodes.Node(From).m_IsClosed = true;
+	Scratch.m_aQueue.clear();
+	Scratch.m_aQueue.push_back(From);
+
+	for(size_t Head = 0; Head < Scratch.m_aQueue.size(); Head++)
+	{
+		const int Current = Scratch.m_aQueue[Head];
+		const int X = Current % m_LayerWidth;
+		const int Y = Current / m_LayerWidth;
+		const int G = Nodes.Node(Current).m_G + 1;
+		const int aNeighbours[4][2] = { { X + 1, Y }, { X - 1, Y }, { X, Y + 1 }, { X, Y - 1 } };
+		for(const auto& Neighbour : aNeighbours)
+		{
+			if(Neighbour[0] < StartX || Neighbour[0] >= EndX || Neighbour[1] < StartY || Neighbour[1] >= EndY)
+				continue;
 
-			// set the one with lowest score to closed list and begin new from there
-			m_lNodes[CurrentIndex].m_IsClosed = true;
-			m_ClosedNodes++;
+			const int Index = Neighbour[1] * m_LayerWidth + Neighbour[0];
+			if(m_aCollision[Index])
+				continue;
+
+			CNode& Node = Nodes.Node(Index);
+			if(Node.m_IsClosed)
+				continue;
+
+			Node.m_IsClosed = true;
+			Node.m_G = G;
+			Node.m_Parent = Current;
+			Scratch.m_aQueue.push_back(Index);
+		}
+	}
+}
+
+bool CPathfinder::AppendClusterPath(CScratch& Scratch, int From, int To, std::vector<vec2>& aWayPoints) const
+{
+	// uses the result of SearchCluster() started at From
+	if(!Scratch.m_Tiles.Node(To).m_IsClosed)
+		return false;
+
+	const size_t First = aWayPoints.size();
+	for(int Index = To; Index != From; Index = Scratch.m_Tiles.Node(Index).m_Parent)
+		aWayPoints.push_back(GetTilePos(Index));
+	std::reverse(aWayPoints.begin() + First, aWayPoints.end());
+	return true;
+}
+
+bool CPathfinder::RefineRoute(CScratch& Scratch, int StartIndex, int EndIndex, const std::vector<int>& aRoute, std::vector<vec2>& aWayPoints) const
+{
+	auto Step = [&](int From, int To)
+	{
+		const int Cluster = GetCluster(From);
+		if(Cluster == GetCluster(To))
+		{
+			SearchCluster(Scratch, Cluster, From);
+			return AppendClusterPath(Scratch, From, To, aWayPoints);
 		}
 
-		// go backwards and return final path :-O
-		while (m_lNodes[CurrentIndex].m_ID != m_StartIndex)
+		// crossing into the neighbouring cluster
+		if(abs(From % m_LayerWidth - To % m_LayerWidth) + abs(From / m_LayerWidth - To / m_LayerWidth) != 1)
+			return false;
+		aWayPoints.push_back(GetTilePos(To));
+		return true;
+	};
+
+	int Current = StartIndex;
+	for(int Portal : aRoute)
+	{
+		if(!Step(Current, m_aPortals[Portal].m_Tile))
+			return false;
+		Current = m_aPortals[Portal].m_Tile;
+	}
+	return Step(Current, EndIndex);
+}
+
+bool CPathfinder::FindRoute(CScratch& Scratch, int StartIndex, int EndIndex) const
+{
+	const int NumPortals = (int)m_aPortals.size();
+	const int StartNode = NumPortals;
+	const int GoalNode = NumPortals + 1;
+	const int StartCluster = GetCluster(StartIndex);
+	const int GoalCluster = GetCluster(EndIndex);
+
+	// connect the start and the goal to the portals of their clusters
+	SearchCluster(Scratch, StartCluster, StartIndex);
+	Scratch.m_aStartEdges.clear();
+	for(int Portal : m_aClusterPortals[StartCluster])
+	{
+		if(const CNode& Node = Scratch.m_Tiles.Node(m_aPortals[Portal].m_Tile); Node.m_IsClosed)
+			Scratch.m_aStartEdges.emplace_back(Portal, Node.m_G);
+	}
+
+	SearchCluster(Scratch, GoalCluster, EndIndex);
+	Scratch.m_aGoalEdges.clear();
+	for(int Portal : m_aClusterPortals[GoalCluster])
+	{
+		if(const CNode& Node = Scratch.m_Tiles.Node(m_aPortals[Portal].m_Tile); Node.m_IsClosed)
+			Scratch.m_aGoalEdges.emplace_back(Portal, Node.m_G);
+	}
+
+	if(Scratch.m_aStartEdges.empty() || Scratch.m_aGoalEdges.empty())
+		return false;
+
+	const int EndX = EndIndex % m_LayerWidth;
+	const int EndY = EndIndex / m_LayerWidth;
+	CNodeSet& Nodes = Scratch.m_Portals;
+	CBinaryHeap<COpenNode>& Open = Scratch.m_PortalsOpen;
+	Nodes.Begin(NumPortals + 2);
+	Open.SetSize(NumPortals + 2);
+	Open.MakeEmpty();
+
+	auto Relax = [&](int From, int To, int Cost, int Tile)
+	{
+		CNode& Next = Nodes.Node(To);
+		if(Next.m_IsClosed)
+			return;
+
+		const int G = Nodes.Node(From).m_G + Cost;
+		if(!Next.m_IsOpen)
+		{
+			Next.m_Parent = From;
+			Next.m_G = G;
+			Next.m_H = abs(Tile % m_LayerWidth - EndX) + abs(Tile / m_LayerWidth - EndY);
+			Next.m_F = Next.m_G + Next.m_H;
+			Next.m_IsOpen = true;
+			Open.Insert({ To, Next.m_F });
+		}
+		else if(G < Next.m_G)
+		{
+			Next.m_Parent = From;
+			Next.m_G = G;
+			Next.m_F = Next.m_G + Next.m_H;
+			Open.DecreaseKey({ To, Next.m_F });
+		}
+	};
+
+	Nodes.Node(StartNode).m_IsOpen = true;
+	Open.Insert({ StartNode, 0 });
+	while(Open.GetSize() > 0)
+	{
+		const int Current = Open.GetMin()->m_ID;
+		Open.RemoveMin();
+		Nodes.Node(Current).m_IsClosed = true;
+		if(Current == GoalNode)
+			break;
+
+		if(Current == StartNode)
+		{
+			for(const auto& [Portal, Cost] : Scratch.m_aStartEdges)
+				Relax(Current, Portal, Cost, m_aPortals[Portal].m_Tile);
+			continue;
+		}
+
+		for(const auto& [Portal, Cost] : m_aPortals[Current].m_aEdges)
+			Relax(Current, Portal, Cost, m_aPortals[Portal].m_Tile);
+
+		if(m_aPortals[Current].m_Cluster == GoalCluster)
+		{
+			for(const auto& [Portal, Cost] : Scratch.m_aGoalEdges)
+			{
+				if(Portal == Current)
+					Relax(Current, GoalNode, Cost, EndIndex);
+			}
+		}
+	}
+
+	if(!Nodes.Node(GoalNode).m_IsClosed)
+		return false;
+
+	Scratch.m_aRoute.clear();
+	for(int Node = Nodes.Node(GoalNode).m_Parent; Node != StartNode; Node = Nodes.Node(Node).m_Parent)
+		Scratch.m_aRoute.push_back(Node);
+	std::reverse(Scratch.m_aRoute.begin(), Scratch.m_aRoute.end());
+	return true;
+}
+
+bool CPathfinder::GetCachedRoute(int64_t Key, std::vector<int>& aRoute)
+{
+	std::lock_guard<std::mutex> Lock(m_RoutesLock);
+	const auto Iter = m_aRoutesIndex.find(Key);
+	if(Iter == m_aRoutesIndex.end())
+		return false;
+
+	m_aRoutes.splice(m_aRoutes.begin(), m_aRoutes, Iter->second);
+	aRoute = Iter->second->second;
+	return true;
+}
+
+void CPathfinder::AddCachedRoute(int64_t Key, const std::vector<int>& aRoute)
+{
+	std::lock_guard<std::mutex> Lock(m_RoutesLock);
+	if(const auto Iter = m_aRoutesIndex.find(Key); Iter != m_aRoutesIndex.end())
+	{
+		Iter->second->second = aRoute;
+		m_aRoutes.splice(m_aRoutes.begin(), m_aRoutes, Iter->second);
+		return;
+	}
+
+	m_aRoutes.emplace_front(Key, aRoute);
+	m_aRoutesIndex[Key] = m_aRoutes.begin();
+	if((int)m_aRoutes.size() > MAX_CACHED_ROUTES)
+	{
+		m_aRoutesIndex.erase(m_aRoutes.back().first);
+		m_aRoutes.pop_back();
+	}
+}
+
+void CPathfinder::FindPath(CScratch& Scratch, vec2 StartPos, vec2 EndPos, std::vector<vec2>& aWayPoints)
+{
+	const int StartIndex = GetIndex(StartPos);
+	const int EndIndex = GetIndex(EndPos);
+	if(g_Config.m_SvPathfinderHierarchical && FindPathHierarchical(Scratch, StartIndex, EndIndex, aWayPoints))
+		return;
+
+	aWayPoints.clear();
+	FindPathTiles(Scratch, StartIndex, EndIndex, aWayPoints);
+}
+
+bool CPathfinder::FindPathHierarchical(CScratch& Scratch, int StartIndex, int EndIndex, std::vector<vec2>& aWayPoints)
+{
+	const int StartCluster = GetCluster(StartIndex);
+	const int GoalCluster = GetCluster(EndIndex);
+
+	// inside of one cluster the tiles are searched directly
+	if(StartCluster == GoalCluster)
+	{
+		SearchCluster(Scratch, StartCluster, StartIndex);
+		if(AppendClusterPath(Scratch, StartIndex, EndIndex, aWayPoints))
+			return true;
+	}
+
+	// a cached route is only used if the start and the goal still reach its ends
+	const int64_t Key = ((int64_t)StartCluster << 32) | GoalCluster;
+	if(GetCachedRoute(Key, Scratch.m_aRoute))
+	{
+		if(RefineRoute(Scratch, StartIndex, EndIndex, Scratch.m_aRoute, aWayPoints))
+			return true;
+		aWayPoints.clear();
+	}
+
+	if(!FindRoute(Scratch, StartIndex, EndIndex))
+		return false;
+
+	if(!RefineRoute(Scratch, StartIndex, EndIndex, Scratch.m_aRoute, aWayPoints))
+		return false;
+
+	AddCachedRoute(Key, Scratch.m_aRoute);
+	return true;
+}
+
+void CPathfinder::FindPathTiles(CScratch& Scratch, int StartIndex, int EndIndex, std::vector<vec2>& aWayPoints) const
+{
+	const int Size = m_LayerWidth * m_LayerHeight;
+	const int EndX = EndIndex % m_LayerWidth;
+	const int EndY = EndIndex / m_LayerWidth;
+
+	CNodeSet& Nodes = Scratch.m_Tiles;
+	CBinaryHeap<COpenNode>& Open = Scratch.m_Open;
+	Nodes.Begin(Size);
+	Open.SetSize(Size);
+	Open.MakeEmpty();
+	Nodes.Node(StartIndex).m_Parent = START;
+	Nodes.Node(StartIndex).m_IsClosed = true;
+	Nodes.Node(EndIndex).m_Parent = END;
+	int ClosedNodes = 1;
+
+	int CurrentIndex = StartIndex;
+	while(ClosedNodes < MAX_WAY_CALC && CurrentIndex != EndIndex)
+	{
+		for(int i = 0; i < 4; i++)
 		{
-			m_lFinalPath[m_FinalSize] = m_lNodes[CurrentIndex];
-			m_FinalSize++;
+			// get the working index
+			int WorkingIndex = -1;
+
+			switch(i)
+			{
+			case 0:
+				if(CurrentIndex + 1 < Size)
+					WorkingIndex = CurrentIndex + 1;
+				break;
+			case 1:
+				if(CurrentIndex - 1 >= 0)
+					WorkingIndex = CurrentIndex - 1;
+				break;
+			case 2:
+				if(CurrentIndex + m_LayerWidth < Size)
+					WorkingIndex = CurrentIndex + m_LayerWidth;
+				break;
+			case 3:
+				if(CurrentIndex - m_LayerWidth >= 0)
+					WorkingIndex = CurrentIndex - m_LayerWidth;
+			}
+
+			if(WorkingIndex < 0 || m_aCollision[WorkingIndex])
+				continue;
+
+			CNode& Current = Nodes.Node(CurrentIndex);
+			CNode& Working = Nodes.Node(WorkingIndex);
+			if(Working.m_IsClosed)
+				continue;
+
+			if(!Working.m_IsOpen)
+			{
+				// set its parent and calculate the important values
+				Working.m_Parent = CurrentIndex;
+				Working.m_G = Current.m_G + 1;
+				Working.m_H = abs(WorkingIndex % m_LayerWidth - EndX) + abs(WorkingIndex / m_LayerWidth - EndY);
+				Working.m_F = Working.m_G + Working.m_H;
+				Working.m_IsOpen = true;
+
+				Open.Insert({ WorkingIndex, Working.m_F });
+			}
+			else if(Working.m_G > Current.m_G + 1)
+			{
+				// set new parent, H value wont change
+				Working.m_Parent = CurrentIndex;
+				Working.m_G = Current.m_G + 1;
+				Working.m_F = Working.m_G + Working.m_H;
 
-			// get next node
-			CurrentIndex = m_lNodes[CurrentIndex].m_Parent;
+				Open.DecreaseKey({ WorkingIndex, Working.m_F });
+			}
 		}
+
+		if(Open.GetSize() < 1)
+			return;
+
+		// get Lowest F from heap and set new CurrentIndex
+		CurrentIndex = Open.GetMin()->m_ID;
+		Open.RemoveMin();
+
+		// set the one with lowest score to closed list and begin new from there
+		Nodes.Node(CurrentIndex).m_IsClosed = true;
+		ClosedNodes++;
+	}
+
+	// go backwards and return final path
+	while(CurrentIndex != StartIndex)
+	{
+		aWayPoints.push_back(GetTilePos(CurrentIndex));
+		CurrentIndex = Nodes.Node(CurrentIndex).m_Parent;
 	}
+	std::reverse(aWayPoints.begin(), aWayPoints.end());
 }
 
-vec2 CPathfinder::GetRandomWaypoint()
+vec2 CPathfinder::GetRandomWaypoint() const
 {
 	array<vec2> lPossibleWaypoints;
-	for (int i = 0; i < m_LayerHeight; i++)
+	for(int i = 0; i < m_LayerHeight; i++)
 	{
-		for (int j = 0; j < m_LayerWidth; j++)
+		for(int j = 0; j < m_LayerWidth; j++)
 		{
-			if (m_lMap[i * m_LayerWidth + j].m_IsClosed || m_lMap[i * m_LayerWidth + j].m_IsCol)
+			if(m_aCollision[i * m_LayerWidth + j])
 				continue;
 
-			lPossibleWaypoints.add(m_lMap[i * m_LayerWidth + j].m_Pos);
+			lPossibleWaypoints.add(vec2(j, i));
 		}
 	}
 
-	if (lPossibleWaypoints.size())
+	if(lPossibleWaypoints.size())
 	{
 		int Rand = secure_rand() % lPossibleWaypoints.size();
 		return lPossibleWaypoints[Rand];
@@ -205,7 +715,7 @@ vec2 CPathfinder::GetRandomWaypoint()
 	return vec2(0, 0);
 }
 
-vec2 CPathfinder::GetRandomWaypointRadius(vec2 Pos, float Radius)
+vec2 CPathfinder::GetRandomWaypointRadius(vec2 Pos, float Radius) const
 {
 	array<vec2> lPossibleWaypoints;
 	float Range = (Radius / 2.0f);
@@ -218,10 +728,10 @@ vec2 CPathfinder::GetRandomWaypointRadius(vec2 Pos, float Radius)
 	{
 		for(int j = StartX; j < EndX; j++)
 		{
-			if(m_lMap[i * m_LayerWidth + j].m_IsClosed || m_lMap[i * m_LayerWidth + j].m_IsCol)
+			if(m_aCollision[i * m_LayerWidth + j])
 				continue;
 
-			lPossibleWaypoints.add(m_lMap[i * m_LayerWidth + j].m_Pos);
+			lPossibleWaypoints.add(vec2(j, i));
 		}
 	}
 
@@ -231,4 +741,4 @@ vec2 CPathfinder::GetRandomWaypointRadius(vec2 Pos, float Radius)
 		return lPossibleWaypoints[Rand];
 	}
 	return vec2(0, 0);
-}
\ No newline at end of file
+}
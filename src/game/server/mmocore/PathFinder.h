@@ -6,67 +6,152 @@
 
 #define MAX_WAY_CALC 50000
 
-// player object
+/*
+	Paths of the bots are searched by a fixed pool of threads shared by all worlds.
+	The map of a world is only read after construction and every thread has its own
+	search nodes, so searches never wait for each other. A bot has at most one queued
+	request, a newer one replaces it. Found paths are given back to the bots by
+	Update() on the tick thread of the world.
+
+	With sv_pathfinder_hierarchical the map is split into clusters connected by
+	portals when the world is loaded. A search then only runs over the portals
+	and is refined into tiles inside single clusters, the tile search is the
+	fallback. Recent cluster to cluster routes are cached, so mobs chasing the
+	same player reuse one route.
+*/
 class CPathfinder
 {
+	friend class CPathfinderWorkers;
+
 public:
+	typedef std::function<void(int ClientID, std::vector<vec2>&& aWayPoints)> PathCallback;
+
 	CPathfinder(class CLayers* Layers, class CCollision* Collision);
 	~CPathfinder();
 
+	void RequestPath(int ClientID, vec2 StartPos, vec2 EndPos);
+	void CancelRequest(int ClientID);
+	void Update(const PathCallback& Callback);
+
+	vec2 GetRandomWaypoint() const;
+	vec2 GetRandomWaypointRadius(vec2 Pos, float Radius) const;
+
+private:
+	enum
+	{
+		START = -3,
+		END = -4,
+	};
+
+	// search buffers of a worker, a node is valid only if its stamp is the current generation
 	struct CNode
 	{
-		vec2 m_Pos;
+		unsigned m_Stamp;
 		int m_Parent;
-		int m_ID;
 		int m_G;
 		int m_H;
 		int m_F;
-		bool m_IsCol;
 		bool m_IsClosed;
 		bool m_IsOpen;
-
-		bool operator<(const CNode& Other) const { return (this->m_F < Other.m_F); }
-		bool operator==(const CNode& Other) const { return (this->m_ID < Other.m_ID); }
 	};
 
-	void Init();
-	void SetStart(vec2 Pos);
-	void SetEnd(vec2 Pos);
-
-	int GetIndex(int XPos, int YPos) const;
+	struct COpenNode
+	{
+		int m_ID;
+		int m_F;
 
-	vec2 GetRandomWaypoint();
-	vec2 GetRandomWaypointRadius(vec2 Pos, float Radius);
+		bool operator<(const COpenNode& Other) const { return m_F < Other.m_F; }
+	};
 
-	void FindPath();
+	struct CNodeSet
+	{
+		std::vector<CNode> m_aNodes;
+		unsigned m_Generation = 0;
 
-	array<CNode> m_lMap;
-	array<CNode> m_lFinalPath;
+		void Begin(int Size);
+		CNode& Node(int Index);
+	};
 
-	int m_FinalSize;
-private:
-	enum
+	struct CScratch
 	{
-		START = -3,
-		END = -4,
+		CNodeSet m_Tiles;
+		CNodeSet m_Portals;
+		CBinaryHeap<COpenNode> m_Open;
+		CBinaryHeap<COpenNode> m_PortalsOpen;
+		std::vector<int> m_aQueue;
+		std::vector<std::pair<int, int>> m_aStartEdges;
+		std::vector<std::pair<int, int>> m_aGoalEdges;
+		std::vector<int> m_aRoute;
 	};
 
-	class CLayers *m_pLayers;
-	class CCollision *m_pCollision;
-
-	array<CNode> m_lNodes;
+	struct CPortal
+	{
+		int m_Tile;
+		int m_Cluster;
+		std::vector<std::pair<int /* portal */, int /* cost */>> m_aEdges;
+	};
 
-	// binary heap for open nodes
-	CBinaryHeap<CNode> m_Open;
+	struct CRequest
+	{
+		int m_Sequence;
+		vec2 m_StartPos;
+		vec2 m_EndPos;
+		bool m_Queued;
+	};
 
-	int m_StartIndex;
-	int m_EndIndex;
+	struct CResult
+	{
+		int m_ClientID;
+		int m_Sequence;
+		std::vector<vec2> m_aWayPoints;
+	};
 
+	std::vector<bool> m_aCollision;
 	int m_LayerWidth;
 	int m_LayerHeight;
 
-	// fake array sizes
-	int m_ClosedNodes;
+	// cluster graph, read only after construction
+	std::vector<CPortal> m_aPortals;
+	std::vector<std::vector<int>> m_aClusterPortals;
+	std::unordered_map<int, int> m_aTilePortal;
+	int m_ClustersX;
+	int m_ClustersY;
+
+	// recent routes as portals from the start cluster to the goal cluster
+	typedef std::list<std::pair<int64_t, std::vector<int>>> RouteList;
+	std::mutex m_RoutesLock;
+	RouteList m_aRoutes;
+	std::unordered_map<int64_t, RouteList::iterator> m_aRoutesIndex;
+
+	std::shared_ptr<class CPathfinderWorkers> m_pWorkers;
+
+	// guarded by the lock of the workers
+	CRequest m_aRequests[MAX_CLIENTS];
+	int m_NumRunning;
+
+	// tick thread only
+	int m_aSequence[MAX_CLIENTS];
+	bool m_aPending[MAX_CLIENTS];
+
+	std::mutex m_ResultsLock;
+	std::vector<CResult> m_aResults;
+
+	int GetIndex(vec2 Pos) const;
+	int GetCluster(int Index) const;
+	vec2 GetTilePos(int Index) const { return vec2((Index % m_LayerWidth) * 32 + 16, (Index / m_LayerWidth) * 32 + 16); }
+
+	void BuildClusters();
+	int AddPortal(int Tile);
+	void SearchCluster(CScratch& Scratch, int Cluster, int From) const;
+	bool AppendClusterPath(CScratch& Scratch, int From, int To, std::vector<vec2>& aWayPoints) const;
+	bool RefineRoute(CScratch& Scratch, int StartIndex, int EndIndex, const std::vector<int>& aRoute, std::vector<vec2>& aWayPoints) const;
+	bool FindRoute(CScratch& Scratch, int StartIndex, int EndIndex) const;
+	bool GetCachedRoute(int64_t Key, std::vector<int>& aRoute);
+	void AddCachedRoute(int64_t Key, const std::vector<int>& aRoute);
+
+	void FindPath(CScratch& Scratch, vec2 StartPos, vec2 EndPos, std::vector<vec2>& aWayPoints);
+	bool FindPathHierarchical(CScratch& Scratch, int StartIndex, int EndIndex, std::vector<vec2>& aWayPoints);
+	void FindPathTiles(CScratch& Scratch, int StartIndex, int EndIndex, std::vector<vec2>& aWayPoints) const;
 };
 
 #endif
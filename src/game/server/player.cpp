@@ -28,6 +28,7 @@ CPlayer::CPlayer(CGS *pGS, int ClientID) : m_pGS(pGS), m_ClientID(ClientID)
 	m_EidolonCID = -1;
 	m_Spawned = true;
 	m_SnapHealthTick = 0;
+	m_AttributesCacheValid = false;
 	m_aPlayerTick[Respawn] = Server()->Tick() + Server()->TickSpeed();
 	m_aPlayerTick[Die] = Server()->Tick();
 	m_PrevTuningParams = *pGS->Tuning();
@@ -129,8 +130,6 @@ void CPlayer::TryCreateEidolon()
 	if(IsBot() || !IsAuthed() || !GetCharacter())
 		return;
 
-	mtxThreadPathWritedNow.lock();
-
 	int EidolonItemID = GetEquippedItemID(EQUIP_EIDOLON);
 	if(CEidolonInfoData* pEidolonData = GS()->GetEidolonByItemID(EidolonItemID))
 	{
@@ -140,8 +139,6 @@ void CPlayer::TryCreateEidolon()
 			m_EidolonCID = EidolonCID;
 		}
 	}
-
-	mtxThreadPathWritedNow.unlock();
 }
 
 void CPlayer::TryRemoveEidolon()
@@ -149,8 +146,6 @@ void CPlayer::TryRemoveEidolon()
 	if(IsBot())
 		return;
 
-	mtxThreadPathWritedNow.lock();
-
 	if(m_EidolonCID >= MAX_PLAYERS && m_EidolonCID < MAX_CLIENTS && GS()->m_apPlayers[m_EidolonCID])
 	{
 		if(GS()->m_apPlayers[m_EidolonCID]->GetCharacter())
@@ -161,27 +156,19 @@ void CPlayer::TryRemoveEidolon()
 	}
 
 	m_EidolonCID = -1;
-
-	mtxThreadPathWritedNow.unlock();
 }
 
 
 void CPlayer::EffectsTick()
 {
-	if(Server()->Tick() % Server()->TickSpeed() != 0 || CGS::ms_aEffects[m_ClientID].empty())
+	if(Server()->Tick() % Server()->TickSpeed() != 0 || CGS::ms_aEffects[m_ClientID].Empty())
 		return;
 
-	for(auto pEffect = CGS::ms_aEffects[m_ClientID].begin(); pEffect != CGS::ms_aEffects[m_ClientID].end();)
+	const unsigned Expired = CGS::ms_aEffects[m_ClientID].Elapse(1);
+	for(int EffectID = 0; EffectID < MAX_EFFECTS; EffectID++)
 	{
-		pEffect->second--;
-		if(pEffect->second <= 0)
-		{
-			GS()->Chat(m_ClientID, "You lost the effect {STR}.", pEffect->first.c_str());
-			pEffect = CGS::ms_aEffects[m_ClientID].erase(pEffect);
-			continue;
-		}
-
-		++pEffect;
+		if(Expired & (1u << EffectID))
+			GS()->Chat(m_ClientID, "You lost the effect {STR}.", CEffects::Name(EffectID));
 	}
 }
 
@@ -474,27 +461,41 @@ bool CPlayer::SpendCurrency(int Price, int ItemID)
 	return pItem->Remove(Price);
 }
 
-void CPlayer::GiveEffect(const char* Potion, int Sec, float Chance)
+void CPlayer::GiveEffect(int EffectID, int Sec, float Chance)
 {
+	if(EffectID < 0)
+		return;
+
 	if(m_pCharacter && m_pCharacter->IsAlive())
 	{
 		const float RandomChance = frandom() * 100.0f;
 		if(RandomChance < Chance)
 		{
-			GS()->Chat(m_ClientID, "You got the effect {STR} time {INT}sec.", Potion, Sec);
-			CGS::ms_aEffects[m_ClientID][Potion] = Sec;
+			GS()->Chat(m_ClientID, "You got the effect {STR} time {INT}sec.", CEffects::Name(EffectID), Sec);
+			CGS::ms_aEffects[m_ClientID].Set(EffectID, Sec);
 		}
 	}
 }
 
-bool CPlayer::IsActiveEffect(const char* Potion) const
+bool CPlayer::GiveEffect(const char* Potion, int Sec, float Chance)
 {
-	return CGS::ms_aEffects[m_ClientID].find(Potion) != CGS::ms_aEffects[m_ClientID].end();
+	// the names are registered while loading, unknown ones are rejected
+	const int EffectID = CEffects::Find(Potion);
+	if(EffectID < 0)
+		return false;
+
+	GiveEffect(EffectID, Sec, Chance);
+	return true;
+}
+
+bool CPlayer::IsActiveEffect(int EffectID) const
+{
+	return CGS::ms_aEffects[m_ClientID].IsActive(EffectID);
 }
 
 void CPlayer::ClearEffects()
 {
-	CGS::ms_aEffects[m_ClientID].clear();
+	CGS::ms_aEffects[m_ClientID].Clear();
 }
 
 const char *CPlayer::GetLanguage() const
@@ -502,6 +503,11 @@ const char *CPlayer::GetLanguage() const
 	return Server()->GetClientLanguage(m_ClientID);
 }
 
+int CPlayer::GetLanguageID() const
+{
+	return Server()->GetClientLanguageID(m_ClientID);
+}
+
 void CPlayer::UpdateTempData(int Health, int Mana)
 {
 	GetTempData().m_TempHealth = Health;
@@ -678,6 +684,7 @@ bool CPlayer::ParseVoteUpgrades(const char *CMD, const int VoteID, const int Vot
 	{
 		if(Upgrade(Get, &Acc().m_aStats[(AttributeIdentifier)VoteID], &Acc().m_Upgrade, VoteID2, 1000))
 		{
+			InvalidateAttributes();
 			GS()->Mmo()->SaveAccount(this, SAVE_UPGRADES);
 			GS()->UpdateVotes(m_ClientID, MENU_UPGRADES);
 		}
@@ -723,69 +730,110 @@ CPlayerItem* CPlayer::GetItem(ItemIdentifier ID)
 {
 	dbg_assert(CItemDescription::Data().find(ID) != CItemDescription::Data().end(), "invalid referring to the CPlayerItem");
 
-	if(CPlayerItem::Data()[m_ClientID].find(ID) == CPlayerItem::Data()[m_ClientID].end())
-	{
-		CPlayerItem(ID, m_ClientID).Init({}, {}, {}, {});
-		return &CPlayerItem::Data()[m_ClientID][ID];
-	}
+	auto& aItems = CPlayerItem::Data().Get(m_ClientID);
+	const auto Iter = aItems.find(ID);
+	if(Iter != aItems.end())
+		return &Iter->second;
 
-	return &CPlayerItem::Data()[m_ClientID][ID];
+	CPlayerItem(ID, m_ClientID).Init({}, {}, {}, {});
+	return &aItems[ID];
 }
 
 CSkill* CPlayer::GetSkill(SkillIdentifier ID)
 {
 	dbg_assert(CSkillDescription::Data().find(ID) != CSkillDescription::Data().end(), "invalid referring to the CSkillData");
 	
-	if(CSkill::Data()[m_ClientID].find(ID) == CSkill::Data()[m_ClientID].end())
-	{
-		CSkill(ID, m_ClientID).Init({},{});
-		return &CSkill::Data()[m_ClientID][ID];
-	}
+	auto& aSkills = CSkill::Data().Get(m_ClientID);
+	const auto Iter = aSkills.find(ID);
+	if(Iter != aSkills.end())
+		return &Iter->second;
 
-	return &CSkill::Data()[m_ClientID][ID];
+	CSkill(ID, m_ClientID).Init({},{});
+	return &aSkills[ID];
 }
 
 CQuestData& CPlayer::GetQuest(int QuestID)
 {
-	CQuestData::ms_aPlayerQuests[m_ClientID][QuestID].m_QuestID = QuestID;
-	CQuestData::ms_aPlayerQuests[m_ClientID][QuestID].m_pPlayer = this;
-	return CQuestData::ms_aPlayerQuests[m_ClientID][QuestID];
+	CQuestData& Quest = CQuestData::ms_aPlayerQuests.Get(m_ClientID)[QuestID];
+	Quest.m_QuestID = QuestID;
+	Quest.m_pPlayer = this;
+	return Quest;
+}
+
+const CQuestData* CPlayer::FindQuest(int QuestID) const
+{
+	const auto* paQuests = CQuestData::ms_aPlayerQuests.Find(m_ClientID);
+	if(!paQuests)
+		return nullptr;
+
+	const auto Iter = paQuests->find(QuestID);
+	return Iter != paQuests->end() ? &Iter->second : nullptr;
 }
 
 int CPlayer::GetEquippedItemID(ItemFunctional EquipID, int SkipItemID) const
 {
-	const auto Iter = std::find_if(CPlayerItem::Data()[m_ClientID].begin(), CPlayerItem::Data()[m_ClientID].end(), [EquipID, SkipItemID](const auto& p)
+	const auto* paItems = CPlayerItem::Data().Find(m_ClientID);
+	if(!paItems)
+		return -1;
+
+	const auto Iter = std::find_if(paItems->begin(), paItems->end(), [EquipID, SkipItemID](const auto& p)
 	{
 		return (p.second.HasItem() && p.second.IsEquipped() && p.second.Info()->IsFunctional(EquipID) && p.first != SkipItemID); 
 	});
-	return Iter != CPlayerItem::Data()[m_ClientID].end() ? Iter->first : -1;
+	return Iter != paItems->end() ? Iter->first : -1;
 }
 
 int CPlayer::GetAttributeSize(AttributeIdentifier ID)
 {
 	// if the best tank class is selected among the players we return the sync dungeon stats
-	const CAttributeDescription* pAtt = GS()->GetAttributeInfo(ID);
-	if(GS()->IsDungeon() && pAtt->GetUpgradePrice() < 4 && CDungeonData::ms_aDungeon[GS()->GetDungeonID()].IsDungeonPlaying())
+	if(GS()->IsDungeon() && GS()->GetAttributeInfo(ID)->GetUpgradePrice() < 4 && CDungeonData::ms_aDungeon[GS()->GetDungeonID()].IsDungeonPlaying())
 	{
 		const CGameControllerDungeon* pDungeon = dynamic_cast<CGameControllerDungeon*>(GS()->m_pController);
 		return pDungeon->GetAttributeDungeonSync(this, ID);
 	}
 
+	if(!m_AttributesCacheValid)
+		UpdateAttributesCache();
+	return m_aAttributesCache[(int)ID];
+}
+
+void CPlayer::PrepareSnap()
+{
+	// the snaps of other clients read these, create them before the snaps run in parallel
+	Acc();
+	GetTempData();
+	if(!m_AttributesCacheValid)
+		UpdateAttributesCache();
+}
+
+void CPlayer::UpdateAttributesCache()
+{
+	mem_zero(m_aAttributesCache, sizeof(m_aAttributesCache));
+
 	// get all attributes from items
-	int Size = 0;
-	for(const auto& [ItemID, ItemData] : CPlayerItem::Data()[m_ClientID])
+	if(const auto* paItems = CPlayerItem::Data().Find(m_ClientID))
 	{
-		if(ItemData.IsEquipped() && ItemData.Info()->IsEnchantable() && ItemData.Info()->GetInfoEnchantStats(ID))
+		for(const auto& [ItemID, ItemData] : *paItems)
 		{
-			Size += ItemData.GetEnchantStats(ID);
+			if(!ItemData.IsEquipped() || !ItemData.Info()->IsEnchantable())
+				continue;
+
+			for(int i = (int)AttributeIdentifier::SpreadShotgun; i < (int)AttributeIdentifier::ATTRIBUTES_NUM; i++)
+			{
+				if(ItemData.Info()->GetInfoEnchantStats((AttributeIdentifier)i))
+					m_aAttributesCache[i] += ItemData.GetEnchantStats((AttributeIdentifier)i);
+			}
 		}
 	}
 
 	// if the attribute has the value of player upgrades we sum up
-	if (pAtt->HasDatabaseField())
-		Size += Acc().m_aStats[ID];
+	for(const auto& [ID, pAttribute] : CAttributeDescription::Data())
+	{
+		if(pAttribute->HasDatabaseField())
+			m_aAttributesCache[(int)ID] += Acc().m_aStats[ID];
+	}
 
-	return Size;
+	m_AttributesCacheValid = true;
 }
 
 float CPlayer::GetAttributePercent(AttributeIdentifier ID)
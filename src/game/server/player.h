@@ -37,6 +37,11 @@ class CPlayer
 	int m_SnapHealthTick;
 	std::unordered_map < int, bool > m_aHiddenMenu;
 
+	// totals of equipped items and upgrades, rebuilt after they changed
+	int m_aAttributesCache[(int)AttributeIdentifier::ATTRIBUTES_NUM];
+	bool m_AttributesCacheValid;
+	void UpdateAttributesCache();
+
 protected:
 	CCharacter* m_pCharacter;
 	CGS* m_pGS;
@@ -107,10 +112,14 @@ public:
 	virtual int GetEquippedItemID(ItemFunctional EquipID, int SkipItemID = -1) const;
 	virtual int GetAttributeSize(AttributeIdentifier ID);
 	float GetAttributePercent(AttributeIdentifier ID);
+	void InvalidateAttributes() { m_AttributesCacheValid = false; }
+	virtual void PrepareSnap();
 	virtual void UpdateTempData(int Health, int Mana);
 
-	virtual void GiveEffect(const char* Potion, int Sec, float Chance = 100.0f);
-	virtual bool IsActiveEffect(const char* Potion) const;
+	virtual void GiveEffect(int EffectID, int Sec, float Chance = 100.0f);
+	bool GiveEffect(const char* Potion, int Sec, float Chance = 100.0f);
+	virtual bool IsActiveEffect(int EffectID) const;
+	bool IsActiveEffect(const char* Potion) const { return IsActiveEffect(CEffects::Find(Potion)); }
 	virtual void ClearEffects();
 
 	virtual void Tick();
@@ -151,6 +160,7 @@ public:
 	######################################################################### */
 	bool SpendCurrency(int Price, int ItemID = 1);
 	const char* GetLanguage() const;
+	int GetLanguageID() const;
 	void AddExp(int Exp);
 	void AddMoney(int Money);
 
@@ -174,8 +184,9 @@ public:
 	class CPlayerItem* GetItem(ItemIdentifier ID);
 	class CSkill* GetSkill(SkillIdentifier ID);
 	CQuestData& GetQuest(int QuestID);
-	CAccountTempData& GetTempData() const { return CAccountTempData::ms_aPlayerTempData[m_ClientID]; }
-	CAccountData& Acc() const { return CAccountData::ms_aData[m_ClientID]; }
+	const CQuestData* FindQuest(int QuestID) const;
+	CAccountTempData& GetTempData() const { return CAccountTempData::ms_aPlayerTempData.Get(m_ClientID); }
+	CAccountData& Acc() const { return CAccountData::ms_aData.Get(m_ClientID); }
 
 	int GetTypeAttributesSize(AttributeType Type);
 	int GetAttributesSize();
@@ -13,7 +13,7 @@
 MACRO_ALLOC_POOL_ID_IMPL(CPlayerBot, MAX_CLIENTS * ENGINE_MAX_WORLDS + MAX_CLIENTS)
 
 CPlayerBot::CPlayerBot(CGS *pGS, int ClientID, int BotID, int SubBotID, int SpawnPoint)
-	: CPlayer(pGS, ClientID), m_BotType(SpawnPoint), m_BotID(BotID), m_MobID(SubBotID), m_BotHealth(0), m_LastPosTick(0), m_PathSize(0)
+	: CPlayer(pGS, ClientID), m_BotType(SpawnPoint), m_BotID(BotID), m_MobID(SubBotID), m_BotHealth(0), m_LastPosTick(0)
 {
 	m_EidolonCID = -1;
 	m_OldTargetPos = vec2(0, 0);
@@ -23,8 +23,16 @@ CPlayerBot::CPlayerBot(CGS *pGS, int ClientID, int BotID, int SubBotID, int Spaw
 
 CPlayerBot::~CPlayerBot()
 {
-	for(int i = 0; i < MAX_PLAYERS; i++)
-		DataBotInfo::ms_aDataBot[m_BotID].m_aVisibleActive[i] = false;
+	if(GS()->PathFinder())
+		GS()->PathFinder()->CancelRequest(m_ClientID);
+
+	// other worlds read the bot data while the worlds tick
+	const int BotID = m_BotID;
+	Server()->ExecuteCrossWorld([BotID]()
+	{
+		for(int i = 0; i < MAX_PLAYERS; i++)
+			DataBotInfo::ms_aDataBot[BotID].m_aVisibleActive[i] = false;
+	});
 
 	delete m_pCharacter;
 	m_pCharacter = nullptr;
@@ -62,7 +70,7 @@ void CPlayerBot::Tick()
 		if(m_pCharacter->IsAlive() && m_BotActive)
 		{
 			m_ViewPos = m_pCharacter->GetPos();
-			ThreadMobsPathFinder();
+			HandlePathFinder();
 		}
 		else
 		{
@@ -95,16 +103,12 @@ void CPlayerBot::EffectsTick()
 	if(Server()->Tick() % Server()->TickSpeed() != 0)
 		return;
 
-	for(auto pEffect = m_aEffects.begin(); pEffect != m_aEffects.end();)
-	{
-		pEffect->second--;
-		if(pEffect->second <= 0)
-		{
-			pEffect = m_aEffects.erase(pEffect);
-			continue;
-		}
-		++pEffect;
-	}
+	m_aEffects.Elapse(1);
+}
+
+void CPlayerBot::SkipEffects(int Seconds)
+{
+	m_aEffects.Elapse(Seconds);
 }
 
 int CPlayerBot::GetRespawnTick() const
@@ -166,24 +170,24 @@ int CPlayerBot::GetAttributeSize(AttributeIdentifier ID)
 	return Size;
 }
 
-void CPlayerBot::GiveEffect(const char* Potion, int Sec, float Chance)
+void CPlayerBot::GiveEffect(int EffectID, int Sec, float Chance)
 {
 	if(!m_pCharacter || !m_pCharacter->IsAlive())
 		return;
 
 	const float RandomChance = frandom() * 100.0f;
 	if(RandomChance < Chance)
-		m_aEffects[Potion] = Sec;
+		m_aEffects.Set(EffectID, Sec);
 }
 
-bool CPlayerBot::IsActiveEffect(const char* Potion) const
+bool CPlayerBot::IsActiveEffect(int EffectID) const
 {
-	return m_aEffects.find(Potion) != m_aEffects.end();
+	return m_aEffects.IsActive(EffectID);
 }
 
 void CPlayerBot::ClearEffects()
 {
-	m_aEffects.clear();
+	m_aEffects.Clear();
 }
 
 void CPlayerBot::TryRespawn()
@@ -253,14 +257,13 @@ int CPlayerBot::IsVisibleForClient(int ClientID) const
 	if(m_BotType == TYPE_BOT_QUEST)
 	{
 		const int QuestID = QuestBotInfo::ms_aQuestBot[m_MobID].m_QuestID;
-		if(pSnappingPlayer->GetQuest(QuestID).GetState() != QuestState::ACCEPT)
+		const CQuestData* pQuest = pSnappingPlayer->FindQuest(QuestID);
+		if(!pQuest || pQuest->GetState() != QuestState::ACCEPT)
 			return 0;
 
-		if((QuestBotInfo::ms_aQuestBot[m_MobID].m_Step != pSnappingPlayer->GetQuest(QuestID).m_Step) || pSnappingPlayer->GetQuest(QuestID).m_StepsQuestBot[GetBotMobID()].m_StepComplete)
+		const auto pStepBot = pQuest->m_StepsQuestBot.find(GetBotMobID());
+		if((QuestBotInfo::ms_aQuestBot[m_MobID].m_Step != pQuest->m_Step) || (pStepBot != pQuest->m_StepsQuestBot.end() && pStepBot->second.m_StepComplete))
 			return 0;
-
-		// [first] quest bot active for player
-		DataBotInfo::ms_aDataBot[m_BotID].m_aVisibleActive[ClientID] = true;
 	}
 
 	if(m_BotType == TYPE_BOT_NPC)
@@ -276,6 +279,19 @@ int CPlayerBot::IsVisibleForClient(int ClientID) const
 	return 2;
 }
 
+void CPlayerBot::PrepareSnap()
+{
+	if(m_BotType != TYPE_BOT_QUEST || !m_BotActive)
+		return;
+
+	// [first] quest bot active for player, marked before any snap so they only read it
+	for(int i = 0; i < MAX_PLAYERS; i++)
+	{
+		if(IsVisibleForClient(i))
+			DataBotInfo::ms_aDataBot[m_BotID].m_aVisibleActive[i] = true;
+	}
+}
+
 void CPlayerBot::HandleTuningParams()
 {
 	if(!(m_PrevTuningParams == m_NextTuningParams))
@@ -372,7 +388,8 @@ bool CPlayerBot::IsActiveQuests(int SnapClientID) const
 	if(m_BotType == TYPE_BOT_NPC)
 	{
 		const int GivesQuest = GS()->Mmo()->BotsData()->GetQuestNPC(m_MobID);
-		if(NpcBotInfo::ms_aNpcBot[m_MobID].m_Function == FUNCTION_NPC_GIVE_QUEST && pSnappingPlayer->GetQuest(GivesQuest).GetState() == QuestState::NO_ACCEPT)
+		const CQuestData* pQuest = pSnappingPlayer->FindQuest(GivesQuest);
+		if(NpcBotInfo::ms_aNpcBot[m_MobID].m_Function == FUNCTION_NPC_GIVE_QUEST && (!pQuest || pQuest->GetState() == QuestState::NO_ACCEPT))
 			return true;
 
 		return false;
@@ -438,48 +455,7 @@ CTeeInfo& CPlayerBot::GetTeeInfo() const
 	return DataBotInfo::ms_aDataBot[m_BotID].m_TeeInfos;
 }
 
-void CPlayerBot::FindThreadPath(CGS* pGameServer, CPlayerBot* pBotPlayer, vec2 StartPos, vec2 SearchPos)
-{
-	if(!pGameServer || !pBotPlayer || length(StartPos) <= 0 || length(SearchPos) <= 0)
-		return;
-
-	mtxThreadPathWritedNow.lock();
-
-	while(pBotPlayer->m_ThreadReadNow.load(std::memory_order_acquire))
-		std::this_thread::sleep_for(std::chrono::microseconds(1));
-
-	pBotPlayer->m_OldTargetPos = pBotPlayer->m_TargetPos;
-
-	pGameServer->PathFinder()->Init();
-	pGameServer->PathFinder()->SetStart(StartPos);
-	pGameServer->PathFinder()->SetEnd(SearchPos);
-	pGameServer->PathFinder()->FindPath();
-	pBotPlayer->m_PathSize = pGameServer->PathFinder()->m_FinalSize;
-	for(int i = pBotPlayer->m_PathSize - 1, j = 0; i >= 0; i--, j++)
-		pBotPlayer->m_WayPoints[j] = vec2(pGameServer->PathFinder()->m_lFinalPath[i].m_Pos.x * 32 + 16, pGameServer->PathFinder()->m_lFinalPath[i].m_Pos.y * 32 + 16);
-
-	mtxThreadPathWritedNow.unlock();
-}
-
-void CPlayerBot::GetThreadRandomRadiusWaypointTarget(CGS* pGameServer, CPlayerBot* pBotPlayer, vec2 Pos, float Radius)
-{
-	if(!pGameServer || !pBotPlayer || length(Pos) <= 0)
-		return;
-
-	mtxThreadPathWritedNow.lock();
-
-	while(pBotPlayer->m_ThreadReadNow.load(std::memory_order_acquire))
-		std::this_thread::sleep_for(std::chrono::microseconds(1));
-
-	pBotPlayer->m_OldTargetPos = pBotPlayer->m_TargetPos;
-
-	const vec2 TargetPos = pGameServer->PathFinder()->GetRandomWaypointRadius(Pos, Radius);
-	pBotPlayer->m_TargetPos = vec2(TargetPos.x * 32, TargetPos.y * 32);
-
-	mtxThreadPathWritedNow.unlock();
-}
-
-void CPlayerBot::ThreadMobsPathFinder()
+void CPlayerBot::HandlePathFinder()
 {
 	if(!m_pCharacter || !m_pCharacter->IsAlive() || (m_TargetPos != vec2(0,0) && distance(m_TargetPos, m_OldTargetPos) < 48.0f))
 		return;
@@ -488,12 +464,15 @@ void CPlayerBot::ThreadMobsPathFinder()
 	{
 		if(m_TargetPos != vec2(0, 0) && (Server()->Tick() + 3 * m_ClientID) % (Server()->TickSpeed()) == 0)
 		{
-			std::thread(&FindThreadPath, GS(), this, m_ViewPos, m_TargetPos).detach();
+			m_OldTargetPos = m_TargetPos;
+			GS()->PathFinder()->RequestPath(m_ClientID, m_ViewPos, m_TargetPos);
 		}
 		else if(m_TargetPos == vec2(0, 0) || distance(m_ViewPos, m_TargetPos) < 128.0f)
 		{
 			m_LastPosTick = Server()->Tick() + (Server()->TickSpeed() * 2 + random_int() % 4);
-			std::thread(&GetThreadRandomRadiusWaypointTarget, GS(), this, m_ViewPos, 800.0f).detach();
+			m_OldTargetPos = m_TargetPos;
+			const vec2 TargetPos = GS()->PathFinder()->GetRandomWaypointRadius(m_ViewPos, 800.0f);
+			m_TargetPos = vec2(TargetPos.x * 32, TargetPos.y * 32);
 		}
 	}
 
@@ -502,20 +481,14 @@ void CPlayerBot::ThreadMobsPathFinder()
 		int OwnerID = m_MobID;
 		if(const CPlayer* pPlayerOwner = GS()->GetPlayer(OwnerID, true, true); pPlayerOwner && m_TargetPos != vec2(0, 0) && Server()->Tick() % (Server()->TickSpeed() / 3) == 0)
 		{
-			std::thread(&FindThreadPath, GS(), this, m_ViewPos, m_TargetPos).detach();
+			m_OldTargetPos = m_TargetPos;
+			GS()->PathFinder()->RequestPath(m_ClientID, m_ViewPos, m_TargetPos);
 		}
 	}
 }
 
 void CPlayerBot::ClearWayPoint()
 {
-	if(!m_WayPoints.empty())
-	{
-		bool Status = false;
-		if(!m_ThreadReadNow.compare_exchange_strong(Status, true, std::memory_order::memory_order_acquire, std::memory_order::memory_order_relaxed))
-			return;
-
-		m_WayPoints.clear();
-		m_ThreadReadNow.store(false, std::memory_order::memory_order_release);
-	}
-}
\ No newline at end of file
+	GS()->PathFinder()->CancelRequest(m_ClientID);
+	m_WayPoints.clear();
+}
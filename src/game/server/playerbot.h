@@ -5,8 +5,6 @@
 
 #include "player.h"
 
-inline std::mutex mtxThreadPathWritedNow;
-
 class CPlayerBot : public CPlayer
 {
 	MACRO_ALLOC_POOL_ID()
@@ -18,21 +16,19 @@ class CPlayerBot : public CPlayer
 	int m_BotStartHealth;
 	bool m_BotActive;
 	int m_DungeonAllowedSpawn;
-	std::map<int, vec2> m_WayPoints;
+	std::vector<vec2> m_WayPoints;
 
 public:
 	int m_LastPosTick;
-	int m_PathSize;
 	vec2 m_TargetPos;
 	vec2 m_OldTargetPos;
-	std::atomic_bool m_ThreadReadNow;
 
 	CPlayerBot(CGS *pGS, int ClientID, int BotID, int SubBotID, int SpawnPoint);
 	~CPlayerBot() override;
 
-	vec2& GetWayPoint(int Index) { return m_WayPoints[Index]; }
-	static void FindThreadPath(CGS* pGameServer, CPlayerBot* pBotPlayer, vec2 StartPos, vec2 SearchPos);
-	static void GetThreadRandomRadiusWaypointTarget(CGS* pGameServer, CPlayerBot* pBotPlayer, vec2 Pos, float Radius);
+	int GetPathSize() const { return (int)m_WayPoints.size(); }
+	const vec2& GetWayPoint(int Index) const { return m_WayPoints[Index]; }
+	void SetWayPoints(std::vector<vec2>&& aWayPoints) { m_WayPoints = std::move(aWayPoints); }
 	void ClearWayPoint();
 
 	int GetTeam() override { return TEAM_BLUE; }
@@ -52,12 +48,16 @@ public:
 
 	int64 GetMaskVisibleForClients() const override;
 	int IsVisibleForClient(int ClientID) const override;
+	void PrepareSnap() override;
 	int GetEquippedItemID(ItemFunctional EquipID, int SkipItemID = -1) const override;
 	int GetAttributeSize(AttributeIdentifier ID) override;
 
-	void GiveEffect(const char* Potion, int Sec, float Chance = 100.0f) override;
-	bool IsActiveEffect(const char* Potion) const override;
+	using CPlayer::GiveEffect;
+	using CPlayer::IsActiveEffect;
+	void GiveEffect(int EffectID, int Sec, float Chance = 100.0f) override;
+	bool IsActiveEffect(int EffectID) const override;
 	void ClearEffects() override;
+	void SkipEffects(int Seconds);
 
 	void Tick() override;
 	void PostTick() override;
@@ -72,7 +72,7 @@ public:
 	class CPlayer* GetEidolonOwner() const;
 
 private:
-	std::unordered_map < std::string /* effect */, int /* seconds */ > m_aEffects;
+	CEffectSet m_aEffects;
 	void EffectsTick() override;
 	int GetRespawnTick() const;
 	void TryRespawn() override;
@@ -83,9 +83,9 @@ private:
 	bool IsActiveQuests(int SnapClientID) const;
 
 	/***********************************************************************************/
-	/*  Thread path finderdon't want to secure m_TargetPos, or m_WayPoints with mutex  */
+	/*  Path finder, the paths are searched by the workers and set on the tick thread  */
 	/***********************************************************************************/
-	void ThreadMobsPathFinder();
+	void HandlePathFinder();
 };
 
 #endif
@@ -159,6 +159,10 @@ MACRO_CONFIG_STR(SvMySqlLogin, sv_sql_login, 32, "root", CFGFLAG_SERVER, "MySQL
 MACRO_CONFIG_STR(SvMySqlPassword, sv_sql_password, 32, "", CFGFLAG_SERVER, "MySQL Password")
 MACRO_CONFIG_INT(SvMySqlPort, sv_sql_port, 3306, 0, 65000, CFGFLAG_SERVER, "MySQL Port")
 MACRO_CONFIG_INT(SvMySqlPoolSize, sv_sql_pool_size, 3, 2, 12, CFGFLAG_SERVER, "MySQL Pool size");
+MACRO_CONFIG_INT(SvMySqlQueueSize, sv_sql_queue_size, 4096, 64, 65536, CFGFLAG_SERVER, "MySQL queued queries limit, producers wait when it is reached")
+MACRO_CONFIG_INT(SvPathfinderThreads, sv_pathfinder_threads, 2, 1, 16, CFGFLAG_SERVER, "Threads searching the paths of the bots (takes effect when the worlds are loaded)")
+MACRO_CONFIG_INT(SvPathfinderHierarchical, sv_pathfinder_hierarchical, 1, 0, 1, CFGFLAG_SERVER, "Search the paths of the bots over the cluster graph of the map first")
+MACRO_CONFIG_INT(SvItemsSaveInterval, sv_items_save_interval, 50, 1, 3000, CFGFLAG_SERVER, "Ticks between writing changed player items to the database")
 
 MACRO_CONFIG_INT(SvLoltextHspace, sv_loltext_hspace, 7, 7, 25, CFGFLAG_SERVER, "horizontal offset between loltext 'pixels'")
 MACRO_CONFIG_INT(SvLoltextVspace, sv_loltext_vspace, 7, 7, 25, CFGFLAG_SERVER, "vertical offset between loltext 'pixels'")
@@ -1,33 +1,136 @@
 #include <engine/external/json-parser/json.h>
 
+#include <base/math.h>
 #include <engine/storage.h>
 
 #include "localization.h"
 
-CLocalization::CLanguage::CLanguage() : m_Loaded(false), m_Direction(CLocalization::DIRECTION_LTR)
+unsigned CLocalization::CCatalog::Hash(const char* pText)
 {
-	m_aName[0] = 0;
-	m_aFilename[0] = 0;
-	m_aParentFilename[0] = 0;
+	// fnv-1a
+	unsigned Hash = 2166136261u;
+	for(; *pText; pText++)
+		Hash = (Hash ^ (unsigned char)*pText) * 16777619u;
+	return Hash;
 }
 
-CLocalization::CLanguage::CLanguage(const char* pName, const char* pFilename, const char* pParentFilename) : m_Loaded(false), m_Direction(CLocalization::DIRECTION_LTR)
+void CLocalization::CCatalog::Compile(const char* pText, std::vector<CSegment>& aSegments)
 {
-	str_copy(m_aName, pName, sizeof(m_aName));
-	str_copy(m_aFilename, pFilename, sizeof(m_aFilename));
-	str_copy(m_aParentFilename, pParentFilename, sizeof(m_aParentFilename));
+	int Iter = 0;
+	int Start = 0;
+	int ParamTypeStart = -1;
+	while(pText[Iter])
+	{
+		if(ParamTypeStart >= 0)
+		{
+			if(pText[Iter] != '}')
+			{
+				Iter = str_utf8_forward(pText, Iter);
+				continue;
+			}
+
+			// unknown placeholders are dropped
+			if(str_comp_num("STR", pText + ParamTypeStart, 3) == 0)
+				aSegments.push_back({ SEGMENT_STR, 0, 0 });
+			else if(str_comp_num("INT", pText + ParamTypeStart, 3) == 0)
+				aSegments.push_back({ SEGMENT_INT, 0, 0 });
+			else if(str_comp_num("VAL", pText + ParamTypeStart, 3) == 0)
+				aSegments.push_back({ SEGMENT_VAL, 0, 0 });
+
+			Start = Iter + 1;
+			ParamTypeStart = -1;
+		}
+		else if(pText[Iter] == '{')
+		{
+			if(Iter > Start)
+				aSegments.push_back({ SEGMENT_TEXT, Start, Iter - Start });
+			ParamTypeStart = Iter + 1;
+		}
+
+		Iter = str_utf8_forward(pText, Iter);
+	}
+
+	// an unclosed placeholder drops the rest of the text
+	if(ParamTypeStart == -1 && Iter > Start)
+		aSegments.push_back({ SEGMENT_TEXT, Start, Iter - Start });
+}
+
+int CLocalization::CCatalog::AddText(const char* pText)
+{
+	const int Offset = (int)m_aText.size();
+	m_aText.insert(m_aText.end(), pText, pText + str_length(pText) + 1);
+	return Offset;
+}
+
+void CLocalization::CCatalog::Rehash(int NumSlots)
+{
+	m_aSlots.assign(NumSlots, -1);
+	for(int i = 0; i < (int)m_aEntries.size(); i++)
+	{
+		unsigned Slot = m_aEntries[i].m_Hash & (NumSlots - 1);
+		while(m_aSlots[Slot] != -1)
+			Slot = (Slot + 1) & (NumSlots - 1);
+		m_aSlots[Slot] = i;
+	}
+}
+
+int CLocalization::CCatalog::Find(const char* pKey, unsigned Hash) const
+{
+	if(m_aSlots.empty())
+		return -1;
+
+	const unsigned Mask = (unsigned)m_aSlots.size() - 1;
+	for(unsigned Slot = Hash & Mask; m_aSlots[Slot] != -1; Slot = (Slot + 1) & Mask)
+	{
+		const CEntry& Entry = m_aEntries[m_aSlots[Slot]];
+		if(Entry.m_Hash == Hash && str_comp(&m_aText[Entry.m_Key], pKey) == 0)
+			return m_aSlots[Slot];
+	}
+	return -1;
 }
 
-CLocalization::CLanguage::~CLanguage()
+void CLocalization::CCatalog::Add(const char* pKey, const char* pValue)
 {
-	hashtable< CEntry, 128 >::iterator Iter = m_Translations.begin();
-	while(Iter != m_Translations.end())
+	const unsigned KeyHash = Hash(pKey);
+	int Index = Find(pKey, KeyHash);
+	if(Index == -1)
 	{
-		if(Iter.data())
-			Iter.data()->Free();
+		Index = (int)m_aEntries.size();
+		m_aEntries.push_back({ KeyHash, AddText(pKey), 0, 0, 0 });
 
-		++Iter;
+		// keep the table at most half full
+		if(m_aEntries.size() * 2 > m_aSlots.size())
+			Rehash(max(64, (int)m_aSlots.size() * 2));
+		else
+		{
+			const unsigned Mask = (unsigned)m_aSlots.size() - 1;
+			unsigned Slot = KeyHash & Mask;
+			while(m_aSlots[Slot] != -1)
+				Slot = (Slot + 1) & Mask;
+			m_aSlots[Slot] = Index;
+		}
 	}
+
+	// a later value replaces the earlier one
+	CEntry& Entry = m_aEntries[Index];
+	Entry.m_Value = AddText(pValue);
+	Entry.m_FirstSegment = (int)m_aSegments.size();
+	Compile(pValue, m_aSegments);
+	Entry.m_NumSegments = (int)m_aSegments.size() - Entry.m_FirstSegment;
+}
+
+CLocalization::CLanguage::CLanguage() : m_ParentID(-1), m_Direction(CLocalization::DIRECTION_LTR)
+{
+	m_aName[0] = 0;
+	m_aFilename[0] = 0;
+	m_aParentFilename[0] = 0;
+}
+
+CLocalization::CLanguage::CLanguage(const char* pName, const char* pFilename, const char* pParentFilename) : m_ParentID(-1), m_Direction(CLocalization::DIRECTION_LTR)
+{
+	str_copy(m_aName, pName, sizeof(m_aName));
+	str_copy(m_aFilename, pFilename, sizeof(m_aFilename));
+	str_copy(m_aParentFilename, pParentFilename, sizeof(m_aParentFilename));
 }
 
 bool CLocalization::CLanguage::Load(CLocalization* pLocalization, IStorageEngine* pStorage)
@@ -57,9 +160,6 @@ bool CLocalization::CLanguage::Load(CLocalization* pLocalization, IStorageEngine
 		return false;
 	}
 
-	dynamic_string Buffer;
-	int Length;
-
 	// extract data
 	const json_value& rStart = (*pJsonData)["translation"];
 	if(rStart.type == json_array)
@@ -67,38 +167,29 @@ bool CLocalization::CLanguage::Load(CLocalization* pLocalization, IStorageEngine
 		for(unsigned i = 0; i < rStart.u.array.length; ++i)
 		{
 			const char* pKey = rStart[i]["key"];
-			if(pKey && pKey[0])
-			{
-				CEntry* pEntry = m_Translations.set(pKey);
-
-				const char* pSingular = rStart[i]["value"];
-				if(pSingular && pSingular[0])
-				{
-					Length = str_length(pSingular) + 1;
-					pEntry->m_apVersions = new char[Length];
-					str_copy(pEntry->m_apVersions, pSingular, Length);
-				}
-			}
+			if(!pKey || !pKey[0])
+				continue;
+
+			// untranslated lines are left to the parent language
+			const char* pSingular = rStart[i]["value"];
+			if(pSingular && pSingular[0])
+				m_Catalog.Add(pKey, pSingular);
+			pLocalization->m_KeyCatalog.Add(pKey, pKey);
 		}
 	}
 
 	// clean up
 	json_value_free(pJsonData);
-	m_Loaded = true;
-
 	return true;
 }
 
 const char* CLocalization::CLanguage::Localize(const char* pText) const
 {
-	const CEntry* pEntry = m_Translations.get(pText);
-	if(!pEntry)
-		return nullptr;
-
-	return pEntry->m_apVersions;
+	const int Entry = m_Catalog.Find(pText, CCatalog::Hash(pText));
+	return Entry == -1 ? nullptr : m_Catalog.GetValue(Entry);
 }
 
-CLocalization::CLocalization(IStorageEngine* pStorage) : m_pStorage(pStorage), m_pMainLanguage(nullptr)
+CLocalization::CLocalization(IStorageEngine* pStorage) : m_pStorage(pStorage), m_MainLanguageID(-1)
 { }
 
 CLocalization::~CLocalization()
@@ -139,7 +230,7 @@ bool CLocalization::Init()
 		return true; // return true because it's not a critical error
 
 	// extract data
-	m_pMainLanguage = nullptr;
+	m_MainLanguageID = -1;
 	const json_value& rStart = (*pJsonData)["language indices"];
 	if(rStart.type == json_array)
 	{
@@ -147,168 +238,182 @@ bool CLocalization::Init()
 		{
 			CLanguage*& pLanguage = m_pLanguages.increment();
 			pLanguage = new CLanguage((const char*)rStart[i]["name"], (const char*)rStart[i]["file"], (const char*)rStart[i]["parent"]);
-
 			if(m_Cfg_MainLanguage == pLanguage->GetFilename())
-			{
-				pLanguage->Load(this, Storage());
-				m_pMainLanguage = pLanguage;
-			}
+				m_MainLanguageID = m_pLanguages.size() - 1;
 		}
 	}
 
 	// clean up
 	json_value_free(pJsonData);
+
+	// every language is loaded at once, the worlds read them in parallel later
+	for(int i = 0; i < m_pLanguages.size(); i++)
+	{
+		CLanguage* pLanguage = m_pLanguages[i];
+		pLanguage->Load(this, Storage());
+		for(int p = 0; p < m_pLanguages.size() && pLanguage->GetParentFilename()[0]; p++)
+		{
+			if(p != i && str_comp(m_pLanguages[p]->GetFilename(), pLanguage->GetParentFilename()) == 0)
+				pLanguage->m_ParentID = p;
+		}
+	}
 	return true;
 }
 
-const char* CLocalization::LocalizeWithDepth(const char* pLanguageCode, const char* pText, int Depth)
+int CLocalization::GetLanguageID(const char* pLanguageCode) const
 {
-	CLanguage* pLanguage = m_pMainLanguage;
 	if(pLanguageCode)
 	{
 		for(int i = 0; i < m_pLanguages.size(); i++)
 		{
 			if(str_comp(m_pLanguages[i]->GetFilename(), pLanguageCode) == 0)
-			{
-				pLanguage = m_pLanguages[i];
-				break;
-			}
+				return i;
 		}
 	}
+	return -1;
+}
 
-	if(!pLanguage)
-		return pText;
-
-	if(!pLanguage->IsLoaded())
-		pLanguage->Load(this, Storage());
-
-	const char* pResult = pLanguage->Localize(pText);
-	if(pResult)
-		return pResult;
-	if(pLanguage->GetParentFilename()[0] && Depth < 4)
-		return LocalizeWithDepth(pLanguage->GetParentFilename(), pText, Depth + 1);
-	return pText;
+CLocalization::CLanguage* CLocalization::GetLanguage(int LanguageID) const
+{
+	if(LanguageID < 0 || LanguageID >= m_pLanguages.size())
+		LanguageID = m_MainLanguageID;
+	return LanguageID >= 0 ? m_pLanguages[LanguageID] : nullptr;
 }
 
-const char* CLocalization::Localize(const char* pLanguageCode, const char* pText)
+const char* CLocalization::Localize(int LanguageID, const char* pText)
 {
-	return LocalizeWithDepth(pLanguageCode, pText, 0);
+	const CLanguage* pLanguage = GetLanguage(LanguageID);
+	const unsigned Hash = CCatalog::Hash(pText);
+	for(int Depth = 0; pLanguage && Depth <= 4; Depth++)
+	{
+		const int Entry = pLanguage->m_Catalog.Find(pText, Hash);
+		if(Entry != -1)
+			return pLanguage->m_Catalog.GetValue(Entry);
+		pLanguage = pLanguage->m_ParentID >= 0 ? m_pLanguages[pLanguage->m_ParentID] : nullptr;
+	}
+	return pText;
 }
 
-void CLocalization::Format_V(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, va_list VarArgs)
+void CLocalization::FormatSegments(dynamic_string& Buffer, const CLanguage* pLanguage, const char* pText, const CSegment* pSegments, int NumSegments, va_list VarArgs)
 {
-	CLanguage* pLanguage = m_pMainLanguage;
-	if(pLanguageCode)
+	va_list VarArgsIter;
+	va_copy(VarArgsIter, VarArgs);
+
+	int BufferIter = Buffer.length();
+	for(int i = 0; i < NumSegments; i++)
 	{
-		for(int i = 0; i < m_pLanguages.size(); i++)
+		const CSegment& Segment = pSegments[i];
+		if(Segment.m_Type == SEGMENT_TEXT)
 		{
-			if(str_comp(m_pLanguages[i]->GetFilename(), pLanguageCode) != 0)
-				continue;
-
-			pLanguage = m_pLanguages[i];
-			break;
+			BufferIter = Buffer.append_at_num(BufferIter, pText + Segment.m_Offset, Segment.m_Length);
+		}
+		else if(Segment.m_Type == SEGMENT_STR)
+		{
+			const char* pVarArgValue = va_arg(VarArgsIter, const char*);
+			const char* pTranslatedValue = pLanguage->Localize(pVarArgValue);
+			BufferIter = Buffer.append_at(BufferIter, (pTranslatedValue ? pTranslatedValue : pVarArgValue));
+		}
+		else if(Segment.m_Type == SEGMENT_INT)
+		{
+			char aBuf[128];
+			str_format(aBuf, sizeof(aBuf), "%d", va_arg(VarArgsIter, int));
+			BufferIter = Buffer.append_at(BufferIter, aBuf);
+		}
+		else if(Segment.m_Type == SEGMENT_VAL)
+		{
+			BufferIter = Buffer.append_at(BufferIter, get_commas<int>(va_arg(VarArgsIter, int)).c_str());
 		}
 	}
 
+	va_end(VarArgsIter);
+}
+
+void CLocalization::Format_V(dynamic_string& Buffer, int LanguageID, const char* pText, va_list VarArgs)
+{
+	const CLanguage* pLanguage = GetLanguage(LanguageID);
 	if(!pLanguage)
 	{
 		Buffer.append(pText);
 		return;
 	}
 
-	// start parameters of the end of the name and type string
-	const int BufferStart = Buffer.length();
-	int BufferIter = BufferStart;
-	int ParamTypeStart = -1;
+	// texts from outside of the catalog are split on every call
+	static thread_local std::vector<CSegment> s_aSegments;
+	s_aSegments.clear();
+	CCatalog::Compile(pText, s_aSegments);
+	FormatSegments(Buffer, pLanguage, pText, s_aSegments.data(), (int)s_aSegments.size(), VarArgs);
+}
 
-	// argument parsing
-	va_list VarArgsIter;
-	va_copy(VarArgsIter, VarArgs);
+void CLocalization::Format(dynamic_string& Buffer, int LanguageID, const char* pText, ...)
+{
+	va_list VarArgs;
+	va_start(VarArgs, pText);
 
-	// character positions
-	int Iter = 0;
-	int Start = 0;
+	Format_V(Buffer, LanguageID, pText, VarArgs);
 
-	// parse text to search for positions
-	while(pText[Iter])
-	{
-		if(ParamTypeStart >= 0)
-		{
-			if(pText[Iter] != '}')
-			{
-				Iter = str_utf8_forward(pText, Iter);
-				continue;
-			}
+	va_end(VarArgs);
+}
 
-			// we get data from an argument parsing arguments
-			if(str_comp_num("STR", pText + ParamTypeStart, 3) == 0) // string
-			{
-				const char* pVarArgValue = va_arg(VarArgsIter, const char*);
-				const char* pTranslatedValue = pLanguage->Localize(pVarArgValue);
-				BufferIter = Buffer.append_at(BufferIter, (pTranslatedValue ? pTranslatedValue : pVarArgValue));
-			}
-			else if(str_comp_num("INT", pText + ParamTypeStart, 3) == 0) // intiger
-			{
-				char aBuf[128];
-				const int pVarArgValue = va_arg(VarArgsIter, int);
-				str_format(aBuf, sizeof(aBuf), "%d", pVarArgValue); // %ll
-				BufferIter = Buffer.append_at(BufferIter, aBuf);
-			}
-			else if(str_comp_num("VAL", pText + ParamTypeStart, 3) == 0) // value
-			{
-				const int pVarArgValue = va_arg(VarArgsIter, int);
-				BufferIter = Buffer.append_at(BufferIter, get_commas<int>(pVarArgValue).c_str());
-			}
+void CLocalization::Format(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, ...)
+{
+	va_list VarArgs;
+	va_start(VarArgs, pText);
 
-			//
-			Start = Iter + 1;
-			ParamTypeStart = -1;
-		}
+	Format_V(Buffer, GetLanguageID(pLanguageCode), pText, VarArgs);
 
-		// parameter parsing start
-		else
+	va_end(VarArgs);
+}
+
+void CLocalization::Format_VL(dynamic_string& Buffer, int LanguageID, const char* pText, va_list VarArgs)
+{
+	const CLanguage* pLanguage = GetLanguage(LanguageID);
+	if(!pLanguage)
+	{
+		Buffer.append(pText);
+		return;
+	}
+
+	// the translation or the key itself, both already split
+	const unsigned Hash = CCatalog::Hash(pText);
+	const CLanguage* pTranslation = pLanguage;
+	for(int Depth = 0; pTranslation && Depth <= 4; Depth++)
+	{
+		const CCatalog& Catalog = pTranslation->m_Catalog;
+		const int Entry = Catalog.Find(pText, Hash);
+		if(Entry != -1)
 		{
-			if(pText[Iter] == '{')
-			{
-				BufferIter = Buffer.append_at_num(BufferIter, pText + Start, Iter - Start);
-				Iter++;
-				ParamTypeStart = Iter;
-			}
+			FormatSegments(Buffer, pLanguage, Catalog.GetValue(Entry), Catalog.GetSegments(Entry), Catalog.GetNumSegments(Entry), VarArgs);
+			return;
 		}
-
-		Iter = str_utf8_forward(pText, Iter);
+		pTranslation = pTranslation->m_ParentID >= 0 ? m_pLanguages[pTranslation->m_ParentID] : nullptr;
 	}
 
-	// close the argument macro
-	va_end(VarArgsIter);
+	const int Entry = m_KeyCatalog.Find(pText, Hash);
+	if(Entry != -1)
+	{
+		FormatSegments(Buffer, pLanguage, m_KeyCatalog.GetValue(Entry), m_KeyCatalog.GetSegments(Entry), m_KeyCatalog.GetNumSegments(Entry), VarArgs);
+		return;
+	}
 
-	if(Iter > 0 && ParamTypeStart == -1)
-		Buffer.append_at_num(BufferIter, pText + Start, Iter - Start);
+	Format_V(Buffer, LanguageID, pText, VarArgs);
 }
 
-void CLocalization::Format(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, ...)
+void CLocalization::Format_L(dynamic_string& Buffer, int LanguageID, const char* pText, ...)
 {
 	va_list VarArgs;
 	va_start(VarArgs, pText);
 
-	Format_V(Buffer, pLanguageCode, pText, VarArgs);
+	Format_VL(Buffer, LanguageID, pText, VarArgs);
 
 	va_end(VarArgs);
 }
 
-void CLocalization::Format_VL(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, va_list VarArgs)
-{
-	const char* pLocalText = Localize(pLanguageCode, pText);
-
-	Format_V(Buffer, pLanguageCode, pLocalText, VarArgs);
-}
-
 void CLocalization::Format_L(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, ...)
 {
 	va_list VarArgs;
 	va_start(VarArgs, pText);
 
-	Format_VL(Buffer, pLanguageCode, pText, VarArgs);
+	Format_VL(Buffer, GetLanguageID(pLanguageCode), pText, VarArgs);
 
 	va_end(VarArgs);
 }
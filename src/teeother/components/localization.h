@@ -1,7 +1,11 @@
 #ifndef TEEOTHER_COMPONENTS_LOCALIZATION_H
 #define TEEOTHER_COMPONENTS_LOCALIZATION_H
 
-#include <teeother/tl/hashtable.h>
+#include <base/tl/array.h>
+#include <teeother/system/string.h>
+
+#include <cstdarg>
+#include <vector>
 
 /*
  * TODO: Add plural rules example {RP:{INT}:{STR}} or {PR:{INT}:player} use rules from lang files
@@ -13,44 +17,79 @@ class CLocalization
 	IStorageEngine* Storage() { return m_pStorage; }
 
 public:
+	enum
+	{
+		SEGMENT_TEXT = 0,
+		SEGMENT_STR,
+		SEGMENT_INT,
+		SEGMENT_VAL,
+	};
 
-	class CLanguage
+	// a piece of a format string, either literal text or a placeholder
+	struct CSegment
 	{
-	protected:
-		class CEntry
+		int m_Type;
+		int m_Offset;
+		int m_Length;
+	};
+
+	/*
+		Translations of one language in an open addressing table. The texts
+		are split at their placeholders when they are added, the catalog is
+		only read after loading, so the worlds use it concurrently.
+	*/
+	class CCatalog
+	{
+		struct CEntry
 		{
-		public:
-			char* m_apVersions;
-
-			CEntry() : m_apVersions(nullptr) {}
-
-			void Free()
-			{
-				if (m_apVersions)
-				{
-					delete[] m_apVersions;
-					m_apVersions = nullptr;
-				}
-			}
+			unsigned m_Hash;
+			int m_Key;
+			int m_Value;
+			int m_FirstSegment;
+			int m_NumSegments;
 		};
 
+		std::vector<CEntry> m_aEntries;
+		std::vector<int> m_aSlots;
+		std::vector<char> m_aText;
+		std::vector<CSegment> m_aSegments;
+
+		int AddText(const char* pText);
+		void Rehash(int NumSlots);
+
+	public:
+		static unsigned Hash(const char* pText);
+		static void Compile(const char* pText, std::vector<CSegment>& aSegments);
+
+		void Add(const char* pKey, const char* pValue);
+		int Find(const char* pKey, unsigned Hash) const;
+		int Size() const { return (int)m_aEntries.size(); }
+
+		const char* GetValue(int Entry) const { return &m_aText[m_aEntries[Entry].m_Value]; }
+		const CSegment* GetSegments(int Entry) const { return m_aSegments.data() + m_aEntries[Entry].m_FirstSegment; }
+		int GetNumSegments(int Entry) const { return m_aEntries[Entry].m_NumSegments; }
+	};
+
+	class CLanguage
+	{
+	protected:
 		char m_aName[64];
 		char m_aFilename[64];
 		char m_aParentFilename[64];
-		bool m_Loaded;
+		int m_ParentID;
 		int m_Direction;
 
-		hashtable< CEntry, 128 > m_Translations;
+		CCatalog m_Catalog;
+
+		friend class CLocalization;
 
 	public:
 		CLanguage();
 		CLanguage(const char* pName, const char* pFilename, const char* pParentFilename);
-		~CLanguage();
 
 		const char* GetParentFilename() const { return m_aParentFilename; }
 		const char* GetFilename() const { return m_aFilename; }
 		const char* GetName() const { return m_aName; }
-		bool IsLoaded() const { return m_Loaded; }
 		bool Load(CLocalization* pLocalization, IStorageEngine* pStorage);
 		const char* Localize(const char* pKey) const;
 	};
@@ -63,31 +102,44 @@ public:
 	};
 
 protected:
-	CLanguage* m_pMainLanguage;
+	int m_MainLanguageID;
+
+	// the keys of all languages, for texts that no language translates
+	CCatalog m_KeyCatalog;
+
+	CLanguage* GetLanguage(int LanguageID) const;
+	void FormatSegments(dynamic_string& Buffer, const CLanguage* pLanguage, const char* pText, const CSegment* pSegments, int NumSegments, va_list VarArgs);
 
 public:
 	array<CLanguage*> m_pLanguages;
 	fixed_string128 m_Cfg_MainLanguage;
 
-protected:
-	const char* LocalizeWithDepth(const char* pLanguageCode, const char* pText, int Depth);
-
-public:
 	CLocalization(IStorageEngine* pStorage);
 	virtual ~CLocalization();
 
 	virtual bool InitConfig(int argc, const char** argv);
 	virtual bool Init();
 
+	/*
+		Function: GetLanguageID
+			Returns the index of the language in m_pLanguages or -1 for
+			the main language. Callers keep the id instead of the code.
+	*/
+	int GetLanguageID(const char* pLanguageCode) const;
+
 	//localize
-	const char* Localize(const char* pLanguageCode, const char* pText);
+	const char* Localize(int LanguageID, const char* pText);
+	const char* Localize(const char* pLanguageCode, const char* pText) { return Localize(GetLanguageID(pLanguageCode), pText); }
 
 	//format
-	void Format_V(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, va_list VarArgs);
+	void Format_V(dynamic_string& Buffer, int LanguageID, const char* pText, va_list VarArgs);
+	void Format(dynamic_string& Buffer, int LanguageID, const char* pText, ...);
 	void Format(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, ...);
 	//localize, format
-	void Format_VL(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, va_list VarArgs);
+	void Format_VL(dynamic_string& Buffer, int LanguageID, const char* pText, va_list VarArgs);
+	void Format_VL(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, va_list VarArgs) { Format_VL(Buffer, GetLanguageID(pLanguageCode), pText, VarArgs); }
+	void Format_L(dynamic_string& Buffer, int LanguageID, const char* pText, ...);
 	void Format_L(dynamic_string& Buffer, const char* pLanguageCode, const char* pText, ...);
 };
 
-#endif
\ No newline at end of file
+#endif
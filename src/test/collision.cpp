@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <base/system.h>
+#include <game/collision.h>
+#include <game/mapitems.h>
+
+#include <random>
+#include <vector>
+
+// the per-tile traversal IntersectLine and IntersectLineColFlag used before the packed tiles
+static bool IntersectLineReference(const CCollision &Collision, vec2 Pos0, vec2 Pos1, vec2 *pOutCollision, vec2 *pOutBeforeCollision, int ColFlag, int *pHitTile)
+{
+	const int Tile0X = round_to_int(Pos0.x) / 32;
+	const int Tile0Y = round_to_int(Pos0.y) / 32;
+	const int Tile1X = round_to_int(Pos1.x) / 32;
+	const int Tile1Y = round_to_int(Pos1.y) / 32;
+
+	const float Ratio = (Tile0X == Tile1X) ? 1.f : (Pos1.y - Pos0.y) / (Pos1.x - Pos0.x);
+	const float DetPos = Pos0.x * Pos1.y - Pos0.y * Pos1.x;
+
+	const int DeltaTileX = (Tile0X <= Tile1X) ? 1 : -1;
+	const int DeltaTileY = (Tile0Y <= Tile1Y) ? 1 : -1;
+
+	const float DeltaError = DeltaTileY * DeltaTileX * Ratio;
+
+	int CurTileX = Tile0X;
+	int CurTileY = Tile0Y;
+	vec2 Pos = Pos0;
+
+	bool Vertical = false;
+
+	float Error = 0;
+	if(Tile0Y != Tile1Y && Tile0X != Tile1X)
+	{
+		Error = (CurTileX * Ratio - CurTileY - DetPos / (32 * (Pos1.x - Pos0.x))) * DeltaTileY;
+		if(Tile0X < Tile1X)
+			Error += Ratio * DeltaTileY;
+		if(Tile0Y < Tile1Y)
+			Error -= DeltaTileY;
+	}
+
+	auto IsTile = [&](int TileX, int TileY) { return Collision.GetCollisionAt(TileX * 32, TileY * 32) & ColFlag; };
+	while(CurTileX != Tile1X || CurTileY != Tile1Y)
+	{
+		if(IsTile(CurTileX, CurTileY))
+			break;
+		if(CurTileY != Tile1Y && (CurTileX == Tile1X || Error > 0))
+		{
+			CurTileY += DeltaTileY;
+			Error -= 1;
+			Vertical = false;
+		}
+		else
+		{
+			CurTileX += DeltaTileX;
+			Error += DeltaError;
+			Vertical = true;
+		}
+	}
+	if(IsTile(CurTileX, CurTileY))
+	{
+		if(CurTileX != Tile0X || CurTileY != Tile0Y)
+		{
+			if(Vertical)
+			{
+				Pos.x = 32 * (CurTileX + ((Tile0X < Tile1X) ? 0 : 1));
+				Pos.y = (Pos.x * (Pos1.y - Pos0.y) - DetPos) / (Pos1.x - Pos0.x);
+			}
+			else
+			{
+				Pos.y = 32 * (CurTileY + ((Tile0Y < Tile1Y) ? 0 : 1));
+				Pos.x = (Pos.y * (Pos1.x - Pos0.x) + DetPos) / (Pos1.y - Pos0.y);
+			}
+		}
+		if(pOutCollision)
+			*pOutCollision = Pos;
+		if(pOutBeforeCollision)
+		{
+			vec2 Dir = normalize(Pos1 - Pos0);
+			if(Vertical)
+				Dir *= 0.5f / absolute(Dir.x) + 1.f;
+			else
+				Dir *= 0.5f / absolute(Dir.y) + 1.f;
+			*pOutBeforeCollision = Pos - Dir;
+		}
+		*pHitTile = Collision.GetCollisionAt(CurTileX * 32, CurTileY * 32);
+		return true;
+	}
+	if(pOutCollision)
+		*pOutCollision = Pos1;
+	if(pOutBeforeCollision)
+		*pOutBeforeCollision = Pos1;
+	*pHitTile = 0;
+	return false;
+}
+
+TEST(Collision, IntersectLineMatchesReference)
+{
+	// a map that is not a multiple of 64 tiles, so the last bit word is partial
+	const int Width = 77;
+	const int Height = 53;
+	std::mt19937 Random(1);
+	std::vector<CTile> aTiles(Width * Height);
+	for(CTile &Tile : aTiles)
+	{
+		mem_zero(&Tile, sizeof(Tile));
+		const int Roll = Random() % 100;
+		if(Roll < 8)
+			Tile.m_Index = TILE_SOLID;
+		else if(Roll < 11)
+			Tile.m_Index = TILE_NOHOOK;
+		else if(Roll < 14)
+			Tile.m_Index = TILE_INVISIBLE_WALL;
+		else if(Roll < 16)
+			Tile.m_Index = TILE_DEATH;
+	}
+
+	CCollision Collision;
+	Collision.InitTiles(aTiles.data(), Width, Height);
+
+	// solid and solid or invisible wall use the bits, nohook and death the flags
+	const int aColFlags[] = {
+		CCollision::COLFLAG_SOLID,
+		CCollision::COLFLAG_SOLID | CCollision::COLFLAG_DISALLOW_MOVE,
+		CCollision::COLFLAG_NOHOOK,
+		CCollision::COLFLAG_DEATH,
+	};
+
+	std::uniform_real_distribution<float> Coord(-100.0f, 32.0f * Width + 100.0f);
+	std::uniform_real_distribution<float> Offset(-300.0f, 300.0f);
+	int NumHits = 0;
+	for(int Trial = 0; Trial < 100000; Trial++)
+	{
+		// long lines over the whole map, short ones and lines along the axes
+		const vec2 Pos0(Coord(Random), Coord(Random) * Height / Width);
+		vec2 Pos1 = Trial % 2 ? vec2(Coord(Random), Coord(Random) * Height / Width) : Pos0 + vec2(Offset(Random), Offset(Random));
+		if(Trial % 13 == 0)
+			Pos1.x = Pos0.x;
+		else if(Trial % 17 == 0)
+			Pos1.y = Pos0.y;
+
+		for(int ColFlag : aColFlags)
+		{
+			vec2 ExpectedCollision, ExpectedBefore, Collided, Before;
+			int ExpectedTile;
+			const bool Expected = IntersectLineReference(Collision, Pos0, Pos1, &ExpectedCollision, &ExpectedBefore, ColFlag, &ExpectedTile);
+			const bool Result = Collision.IntersectLineColFlag(Pos0, Pos1, &Collided, &Before, ColFlag);
+			ASSERT_EQ(Expected, Result) << "trial " << Trial << " flag " << ColFlag;
+			ASSERT_EQ(mem_comp(&ExpectedCollision, &Collided, sizeof(vec2)), 0) << "trial " << Trial << " flag " << ColFlag;
+			ASSERT_EQ(mem_comp(&ExpectedBefore, &Before, sizeof(vec2)), 0) << "trial " << Trial << " flag " << ColFlag;
+
+			if(ColFlag == CCollision::COLFLAG_SOLID)
+			{
+				ASSERT_EQ(ExpectedTile, Collision.IntersectLine(Pos0, Pos1, &Collided, &Before)) << "trial " << Trial;
+				ASSERT_EQ(mem_comp(&ExpectedCollision, &Collided, sizeof(vec2)), 0) << "trial " << Trial;
+				NumHits += Expected;
+			}
+		}
+	}
+
+	// most of the lines have to end in a wall to mean something
+	EXPECT_GT(NumHits, 50000);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <base/system.h>
+#include <game/server/mmocore/Effects.h>
+
+// the names are global, this is the only test that registers any
+TEST(Effects, Register)
+{
+	EXPECT_EQ(CEffects::Find("Fire"), (int)EFFECT_FIRE);
+	EXPECT_STREQ(CEffects::Name(EFFECT_POISON), "Poison");
+	EXPECT_STREQ(CEffects::Name(-1), "");
+	EXPECT_EQ(CEffects::Find("Frozen"), -1);
+	EXPECT_EQ(CEffects::Register(""), -1);
+
+	// a name is registered once, builtin ones keep their id
+	const int Frozen = CEffects::Register("Frozen");
+	EXPECT_EQ(Frozen, (int)NUM_BUILTIN_EFFECTS);
+	EXPECT_EQ(CEffects::Register("Frozen"), Frozen);
+	EXPECT_EQ(CEffects::Find("Frozen"), Frozen);
+	EXPECT_EQ(CEffects::Register("Slowdown"), (int)EFFECT_SLOWDOWN);
+	EXPECT_STREQ(CEffects::Name(Frozen), "Frozen");
+	EXPECT_STREQ(CEffects::Name(Frozen + 1), "");
+
+	for(int i = Frozen + 1; i < MAX_EFFECTS; i++)
+	{
+		char aName[16];
+		str_format(aName, sizeof(aName), "Effect%d", i);
+		EXPECT_EQ(CEffects::Register(aName), i);
+	}
+
+	// full, the known names are still found
+	EXPECT_EQ(CEffects::Register("Overflow"), -1);
+	EXPECT_EQ(CEffects::Find("Overflow"), -1);
+	EXPECT_EQ(CEffects::Register("Frozen"), Frozen);
+	EXPECT_STREQ(CEffects::Name(MAX_EFFECTS - 1), "Effect31");
+	EXPECT_STREQ(CEffects::Name(MAX_EFFECTS), "");
+}
+
+TEST(Effects, Elapse)
+{
+	CEffectSet Set;
+	EXPECT_TRUE(Set.Empty());
+	EXPECT_EQ(Set.Elapse(1), 0u);
+
+	Set.Set(EFFECT_FIRE, 1);
+	Set.Set(EFFECT_POISON, 3);
+	Set.Set(MAX_EFFECTS - 1, 5);
+	Set.Set(-1, 5);
+	Set.Set(MAX_EFFECTS, 5);
+	EXPECT_TRUE(Set.IsActive(EFFECT_FIRE));
+	EXPECT_FALSE(Set.IsActive(EFFECT_SLOWDOWN));
+	EXPECT_FALSE(Set.IsActive(-1));
+
+	EXPECT_EQ(Set.Elapse(1), 1u << EFFECT_FIRE);
+	EXPECT_FALSE(Set.IsActive(EFFECT_FIRE));
+	EXPECT_TRUE(Set.IsActive(EFFECT_POISON));
+
+	// several seconds at once, everything at or below zero runs out together
+	EXPECT_EQ(Set.Elapse(2), 1u << EFFECT_POISON);
+	EXPECT_EQ(Set.Elapse(1), 0u);
+	EXPECT_EQ(Set.Elapse(10), 1u << (MAX_EFFECTS - 1));
+	EXPECT_TRUE(Set.Empty());
+
+	// setting an active effect again restarts it
+	Set.Set(EFFECT_SLOWDOWN, 2);
+	Set.Set(EFFECT_REGEN_MANA, 2);
+	EXPECT_EQ(Set.Elapse(1), 0u);
+	Set.Set(EFFECT_SLOWDOWN, 3);
+	EXPECT_EQ(Set.Elapse(1), 1u << EFFECT_REGEN_MANA);
+	EXPECT_EQ(Set.Elapse(5), 1u << EFFECT_SLOWDOWN);
+
+	Set.Set(EFFECT_FIRE, 4);
+	Set.Clear();
+	EXPECT_TRUE(Set.Empty());
+	EXPECT_EQ(Set.Elapse(5), 0u);
+}
@@ -12,3 +12,25 @@ TEST(Filesystem, CreateCloseDelete)
 	EXPECT_FALSE(io_close(File));
 	EXPECT_FALSE(fs_remove(Info.m_aFilename));
 }
+
+TEST(Filesystem, MapFile)
+{
+	CTestInfo Info;
+	const char aData[] = "map file data";
+
+	IOHANDLE File = io_open(Info.m_aFilename, IOFLAG_WRITE);
+	ASSERT_TRUE(File);
+	EXPECT_EQ(io_write(File, aData, sizeof(aData)), sizeof(aData));
+	EXPECT_FALSE(io_close(File));
+
+	File = io_open(Info.m_aFilename, IOFLAG_READ);
+	ASSERT_TRUE(File);
+	unsigned Size = 0;
+	const void *pData = io_map(File, &Size);
+	EXPECT_FALSE(io_close(File));
+	ASSERT_TRUE(pData);
+	ASSERT_EQ(Size, sizeof(aData));
+	EXPECT_EQ(mem_comp(pData, aData, sizeof(aData)), 0);
+	io_unmap(pData, Size);
+	EXPECT_FALSE(fs_remove(Info.m_aFilename));
+}
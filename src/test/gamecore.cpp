@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <base/system.h>
+#include <game/gamecore.h>
+
+#include <random>
+
+// the per-unit loop over all slots CCharacterCore::Move used before the swept circles
+static vec2 CollidePlayersReference(const CWorldCore &World, const CCharacterCore *pCore, vec2 NewPos)
+{
+	const vec2 From = pCore->m_Pos;
+	float Distance = distance(From, NewPos);
+	if(Distance > 0)
+	{
+		int End = Distance + 1;
+		vec2 LastPos = From;
+		for(int i = 0; i < End; i++)
+		{
+			float a = i / Distance;
+			vec2 Pos = mix(From, NewPos, a);
+			for(int p = 0; p < MAX_CLIENTS; p++)
+			{
+				const CCharacterCore *pCharCore = World.m_apCharacters[p];
+				if(!pCharCore || pCore->m_WorldID != pCharCore->m_WorldID || pCharCore == pCore)
+					continue;
+				if((!(pCharCore->m_Super || pCore->m_Super) && (pCore->m_Solo || pCharCore->m_Solo || pCharCore->m_CollisionDisabled)))
+					continue;
+				float D = distance(Pos, pCharCore->m_Pos);
+				if(D < CCharacterCore::PhysicalSize() && D >= 0.0f)
+				{
+					if(a > 0.0f)
+						return LastPos;
+					if(distance(NewPos, pCharCore->m_Pos) > D)
+						return NewPos;
+					return From;
+				}
+			}
+			LastPos = Pos;
+		}
+	}
+	return NewPos;
+}
+
+TEST(CharacterCore, CollidePlayersMatchesReference)
+{
+	static CWorldCore s_World;
+	static CCharacterCore s_aCores[MAX_CLIENTS];
+	for(auto &Core : s_aCores)
+		Core.Init(&s_World, nullptr);
+
+	std::mt19937 Random(1);
+	std::uniform_real_distribution<float> Unit(-1.0f, 1.0f);
+	int NumHits = 0;
+	for(int Trial = 0; Trial < 50000; Trial++)
+	{
+		for(int i = 0; i < MAX_CLIENTS; i++)
+			s_World.SetCharacter(i, nullptr);
+
+		// far from and close to the origin, fast and slow moves, some barely moving at all
+		const float Base = Trial % 3 == 0 ? 30000.0f : (Trial % 3 == 1 ? 500.0f : 5.0f);
+		const float Speed = Trial % 5 == 0 ? 600.0f : 40.0f;
+		const int NumCores = 2 + Random() % 12;
+		for(int i = 0; i < NumCores; i++)
+		{
+			CCharacterCore *pCore = &s_aCores[Random() % MAX_CLIENTS];
+			pCore->m_WorldID = 0;
+			pCore->m_Super = Random() % 20 == 0;
+			pCore->m_Solo = Random() % 20 == 0;
+			pCore->m_CollisionDisabled = Random() % 20 == 0;
+			s_World.SetCharacter(pCore - s_aCores, pCore);
+		}
+
+		CCharacterCore *pMover = s_World.m_apCharacters[s_World.m_aCharacterIDs[Random() % s_World.m_NumCharacters]];
+		pMover->m_Pos = vec2(Base + Unit(Random) * 100.0f, Base + Unit(Random) * 100.0f);
+		vec2 NewPos = pMover->m_Pos + vec2(Unit(Random) * Speed, Unit(Random) * Speed);
+		if(Trial % 7 == 0)
+			NewPos = pMover->m_Pos + vec2(Unit(Random) * 0.01f, 0.0f);
+
+		for(int Index = 0; Index < s_World.m_NumCharacters; Index++)
+		{
+			CCharacterCore *pCore = s_World.m_apCharacters[s_World.m_aCharacterIDs[Index]];
+			if(pCore != pMover)
+				pCore->m_Pos = pMover->m_Pos + vec2(Unit(Random) * (Speed + 60.0f), Unit(Random) * (Speed + 60.0f));
+		}
+
+		// a player touching the start of the move
+		if(Trial % 11 == 0)
+		{
+			CCharacterCore *pFirst = s_World.m_apCharacters[s_World.m_aCharacterIDs[0]];
+			if(pFirst != pMover)
+				pFirst->m_Pos = pMover->m_Pos + vec2(CCharacterCore::PhysicalSize() * Unit(Random), 0.0f);
+		}
+
+		const vec2 Expected = CollidePlayersReference(s_World, pMover, NewPos);
+		const vec2 Result = pMover->CollidePlayers(NewPos);
+		ASSERT_EQ(mem_comp(&Expected, &Result, sizeof(vec2)), 0) << "trial " << Trial;
+		if(mem_comp(&Expected, &NewPos, sizeof(vec2)) != 0)
+			NumHits++;
+	}
+
+	// the trials have to hit players often enough to mean something
+	EXPECT_GT(NumHits, 2500);
+}
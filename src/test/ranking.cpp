@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <game/server/mmocore/Components/Rankings/RankingData.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+
+// checks every rank and the whole order against a plain sort
+static void ExpectMatchesReference(const CLeaderboard &Board, const std::map<int, int64_t> &Reference)
+{
+	std::vector<std::pair<int64_t, int>> aSorted;
+	for(const auto &[ID, Score] : Reference)
+		aSorted.emplace_back(-Score, ID);
+	std::sort(aSorted.begin(), aSorted.end());
+
+	ASSERT_EQ(Board.GetSize(), (int)aSorted.size());
+	for(int i = 0; i < (int)aSorted.size(); i++)
+		ASSERT_EQ(Board.GetRank(aSorted[i].second), i + 1) << "id " << aSorted[i].second;
+
+	int Num = 0;
+	Board.ForTop((int)aSorted.size() + 1, [&](int Rank, int ID, int64_t Score)
+	{
+		ASSERT_LT(Num, (int)aSorted.size());
+		EXPECT_EQ(Rank, Num + 1);
+		EXPECT_EQ(ID, aSorted[Num].second);
+		EXPECT_EQ(Score, -aSorted[Num].first);
+		Num++;
+	});
+	EXPECT_EQ(Num, (int)aSorted.size());
+}
+
+TEST(Leaderboard, EqualScores)
+{
+	CLeaderboard Board;
+	Board.Set(5, 100);
+	Board.Set(3, 100);
+	Board.Set(9, 100);
+	Board.Set(1, 200);
+
+	// equal scores are ordered by id
+	EXPECT_EQ(Board.GetRank(1), 1);
+	EXPECT_EQ(Board.GetRank(3), 2);
+	EXPECT_EQ(Board.GetRank(5), 3);
+	EXPECT_EQ(Board.GetRank(9), 4);
+
+	Board.Set(9, 300);
+	Board.Set(9, 300);
+	EXPECT_EQ(Board.GetSize(), 4);
+	EXPECT_EQ(Board.GetRank(9), 1);
+	EXPECT_EQ(Board.GetRank(1), 2);
+	EXPECT_EQ(Board.GetRank(3), 3);
+	EXPECT_EQ(Board.GetRank(5), 4);
+
+	Board.Set(5, 200);
+	EXPECT_EQ(Board.GetRank(1), 2);
+	EXPECT_EQ(Board.GetRank(5), 3);
+	EXPECT_EQ(Board.GetRank(3), 4);
+
+	Board.Remove(1);
+	Board.Remove(1);
+	EXPECT_EQ(Board.GetSize(), 3);
+	EXPECT_EQ(Board.GetRank(1), -1);
+	EXPECT_EQ(Board.GetRank(5), 2);
+	EXPECT_EQ(Board.GetRank(3), 3);
+
+	Board.Clear();
+	EXPECT_EQ(Board.GetSize(), 0);
+	EXPECT_EQ(Board.GetRank(9), -1);
+}
+
+TEST(Leaderboard, MatchesReference)
+{
+	CLeaderboard Board;
+	std::map<int, int64_t> Reference;
+	std::mt19937 Random(1);
+	for(int Op = 0; Op < 20000; Op++)
+	{
+		// few different scores, so many entries share one
+		const int ID = Random() % 500;
+		if(Random() % 4 == 0)
+		{
+			Board.Remove(ID);
+			Reference.erase(ID);
+		}
+		else
+		{
+			const int64_t Score = Random() % 40;
+			Board.Set(ID, Score);
+			Reference[ID] = Score;
+		}
+
+		if(Op % 200 == 0)
+			ExpectMatchesReference(Board, Reference);
+	}
+	ExpectMatchesReference(Board, Reference);
+
+	// empty it one by one, the levels shrink back
+	for(auto Iter = Reference.begin(); Iter != Reference.end();)
+	{
+		Board.Remove(Iter->first);
+		Iter = Reference.erase(Iter);
+		if(Reference.size() % 50 == 0)
+			ExpectMatchesReference(Board, Reference);
+	}
+	EXPECT_EQ(Board.GetSize(), 0);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <base/math.h>
+#include <base/system.h>
+#include <engine/shared/snapshot.h>
+
+static void AddFilled(CSnapshotStorage &Storage, int Tick, int Size)
+{
+	char aData[4096];
+	mem_zero(aData, sizeof(aData));
+	aData[0] = (char)Tick;
+	aData[Size - 1] = (char)(Tick + 1);
+	Storage.Add(Tick, Tick * 10, Size, aData, 0, 0);
+}
+
+static bool CheckFilled(CSnapshotStorage &Storage, int Tick, int Size)
+{
+	CSnapshot *pData = 0;
+	if(Storage.Get(Tick, 0, &pData, 0) != Size)
+		return false;
+	const char *pBytes = (const char *)pData;
+	return pBytes[0] == (char)Tick && pBytes[Size - 1] == (char)(Tick + 1);
+}
+
+TEST(SnapshotStorage, AddGet)
+{
+	CSnapshotStorage Storage;
+	EXPECT_EQ(Storage.Get(0, 0, 0, 0), -1);
+
+	char aData[64] = "snap";
+	char aAltData[16] = "alt";
+	Storage.Add(5, 1234, sizeof(aData), aData, sizeof(aAltData), aAltData);
+
+	int64_t Tagtime = 0;
+	CSnapshot *pData = 0;
+	CSnapshot *pAltData = 0;
+	EXPECT_EQ(Storage.Get(5, &Tagtime, &pData, &pAltData), (int)sizeof(aData));
+	EXPECT_EQ(Tagtime, 1234);
+	EXPECT_STREQ((const char *)pData, "snap");
+	EXPECT_STREQ((const char *)pAltData, "alt");
+	EXPECT_EQ(Storage.Get(4, 0, 0, 0), -1);
+	EXPECT_EQ(Storage.Get(5 + 256, 0, 0, 0), -1);
+	EXPECT_EQ(Storage.RetainedBytes(), (int)(sizeof(aData) + sizeof(aAltData)));
+}
+
+TEST(SnapshotStorage, PurgeUntil)
+{
+	CSnapshotStorage Storage;
+	for(int Tick = 1; Tick <= 10; Tick++)
+		AddFilled(Storage, Tick, 100);
+
+	Storage.PurgeUntil(6);
+	EXPECT_EQ(Storage.NumSnapshots(), 5);
+	EXPECT_EQ(Storage.RetainedBytes(), 500);
+	EXPECT_EQ(Storage.Get(5, 0, 0, 0), -1);
+	EXPECT_TRUE(CheckFilled(Storage, 6, 100));
+	EXPECT_TRUE(CheckFilled(Storage, 10, 100));
+
+	Storage.PurgeAll();
+	EXPECT_EQ(Storage.NumSnapshots(), 0);
+	EXPECT_EQ(Storage.Get(10, 0, 0, 0), -1);
+}
+
+TEST(SnapshotStorage, Ring)
+{
+	// keep 150 ticks like the server while the sizes change
+	CSnapshotStorage Storage;
+	int Capacity = 0;
+	for(int Tick = 0; Tick < 5000; Tick += 2)
+	{
+		Storage.PurgeUntil(Tick - 150);
+		AddFilled(Storage, Tick, 8 + ((Tick * 37) % 4000) / 4 * 4);
+		if(Tick == 1000)
+			Capacity = Storage.CapacityBytes();
+
+		for(int Past = max(Tick - 148, 0); Past <= Tick; Past += 2)
+			ASSERT_TRUE(CheckFilled(Storage, Past, 8 + ((Past * 37) % 4000) / 4 * 4));
+	}
+
+	// no more memory once the window was filled
+	EXPECT_EQ(Storage.CapacityBytes(), Capacity);
+	EXPECT_EQ(Storage.NumSnapshots(), 76);
+}
+
+TEST(SnapshotStorage, TickRestart)
+{
+	CSnapshotStorage Storage;
+	AddFilled(Storage, 100, 40);
+	AddFilled(Storage, 3, 40);
+	EXPECT_EQ(Storage.NumSnapshots(), 1);
+	EXPECT_EQ(Storage.Get(100, 0, 0, 0), -1);
+	EXPECT_TRUE(CheckFilled(Storage, 3, 40));
+}
@@ -0,0 +1,200 @@
+/* (c) Magnus Auvinen. See licence.txt in the root of the distribution for more information. */
+/* If you are missing that file, acquire a complete release at teeworlds.com.                */
+#include <base/math.h>
+#include <base/system.h>
+#include <base/vmath.h>
+#include <game/server/entity_allocator.h>
+
+#include <random>
+#include <vector>
+
+/*
+	Measures the entity tick of a world with the old intrusive type lists
+	and with the dense per-type arrays the world uses now. Both use the
+	entity allocator of the world, so only the traversal differs.
+*/
+
+// moves around like a projectile
+class CBenchEntity
+{
+public:
+	CBenchEntity *m_pPrevTypeEntity = nullptr;
+	CBenchEntity *m_pNextTypeEntity = nullptr;
+	int m_TypeSlot = -1;
+	bool m_MarkedForDestroy = false;
+	vec2 m_Pos;
+	vec2 m_Vel;
+
+	CBenchEntity(vec2 Pos, vec2 Vel) : m_Pos(Pos), m_Vel(Vel) {}
+	virtual ~CBenchEntity() = default;
+
+	virtual void Tick()
+	{
+		m_Pos += m_Vel;
+		if(m_Pos.x < 0.0f || m_Pos.x > 4096.0f)
+			m_Vel.x = -m_Vel.x;
+		if(m_Pos.y < 0.0f || m_Pos.y > 4096.0f)
+			m_Vel.y = -m_Vel.y;
+	}
+};
+
+class CBenchWorld
+{
+	CEntityAllocator m_Allocator;
+	std::mt19937 m_Random;
+	bool m_Dense;
+
+	// the old backend, new entities were put in front of the list
+	CBenchEntity *m_pFirstEntity = nullptr;
+
+	// the current backend, holes are closed once per tick
+	std::vector<CBenchEntity *> m_apEntities;
+
+	float Random(float Min, float Max) { return std::uniform_real_distribution<float>(Min, Max)(m_Random); }
+
+public:
+	CBenchWorld(bool Dense) : m_Random(1), m_Dense(Dense) {}
+
+	~CBenchWorld()
+	{
+		for(CBenchEntity *pEnt : Entities())
+			Destroy(pEnt);
+	}
+
+	std::vector<CBenchEntity *> Entities() const
+	{
+		if(m_Dense)
+		{
+			std::vector<CBenchEntity *> apEntities;
+			for(CBenchEntity *pEnt : m_apEntities)
+				if(pEnt)
+					apEntities.push_back(pEnt);
+			return apEntities;
+		}
+
+		std::vector<CBenchEntity *> apEntities;
+		for(CBenchEntity *pEnt = m_pFirstEntity; pEnt; pEnt = pEnt->m_pNextTypeEntity)
+			apEntities.push_back(pEnt);
+		return apEntities;
+	}
+
+	void Spawn()
+	{
+		CBenchEntity *pEnt = new(m_Allocator.Allocate(sizeof(CBenchEntity))) CBenchEntity(vec2(Random(0.0f, 4096.0f), Random(0.0f, 4096.0f)), vec2(Random(-8.0f, 8.0f), Random(-8.0f, 8.0f)));
+		if(m_Dense)
+		{
+			pEnt->m_TypeSlot = (int)m_apEntities.size();
+			m_apEntities.push_back(pEnt);
+			return;
+		}
+
+		if(m_pFirstEntity)
+			m_pFirstEntity->m_pPrevTypeEntity = pEnt;
+		pEnt->m_pNextTypeEntity = m_pFirstEntity;
+		m_pFirstEntity = pEnt;
+	}
+
+	void Destroy(CBenchEntity *pEnt)
+	{
+		if(m_Dense)
+			m_apEntities[pEnt->m_TypeSlot] = nullptr;
+		else
+		{
+			if(pEnt->m_pPrevTypeEntity)
+				pEnt->m_pPrevTypeEntity->m_pNextTypeEntity = pEnt->m_pNextTypeEntity;
+			else
+				m_pFirstEntity = pEnt->m_pNextTypeEntity;
+			if(pEnt->m_pNextTypeEntity)
+				pEnt->m_pNextTypeEntity->m_pPrevTypeEntity = pEnt->m_pPrevTypeEntity;
+		}
+
+		pEnt->~CBenchEntity();
+		CEntityAllocator::Free(pEnt);
+	}
+
+	void RemoveEntities()
+	{
+		for(CBenchEntity *pEnt : Entities())
+			if(pEnt->m_MarkedForDestroy)
+				Destroy(pEnt);
+
+		if(!m_Dense)
+			return;
+
+		int Num = 0;
+		for(CBenchEntity *pEnt : m_apEntities)
+		{
+			if(!pEnt)
+				continue;
+			pEnt->m_TypeSlot = Num;
+			m_apEntities[Num++] = pEnt;
+		}
+		m_apEntities.resize(Num);
+	}
+
+	void Tick()
+	{
+		if(m_Dense)
+		{
+			for(size_t i = 0; i < m_apEntities.size(); i++)
+				if(m_apEntities[i])
+					m_apEntities[i]->Tick();
+			return;
+		}
+
+		for(CBenchEntity *pEnt = m_pFirstEntity; pEnt; pEnt = pEnt->m_pNextTypeEntity)
+			pEnt->Tick();
+	}
+
+	// replaces every second entity, the new ones take the scattered free blocks
+	void Scatter()
+	{
+		int NumReplaced = 0;
+		for(CBenchEntity *pEnt : Entities())
+		{
+			if(m_Random() % 2)
+			{
+				pEnt->m_MarkedForDestroy = true;
+				NumReplaced++;
+			}
+		}
+		RemoveEntities();
+		for(int i = 0; i < NumReplaced; i++)
+			Spawn();
+	}
+};
+
+static void Measure(CBenchWorld &World, const char *pName, int NumEntities, int NumTicks)
+{
+	const int64 Start = time_get();
+	for(int i = 0; i < NumTicks; i++)
+		World.Tick();
+	const double Seconds = (double)(time_get() - Start) / time_freq();
+
+	dbg_msg("world_bench", "%s: %d entities, %.2f us per tick, %.1f ns per entity", pName, NumEntities,
+		Seconds * 1e6 / NumTicks, Seconds * 1e9 / ((double)NumTicks * NumEntities));
+}
+
+int main(int argc, const char **argv)
+{
+	dbg_logger_stdout();
+
+	const int NumEntities = argc > 1 ? max(str_toint(argv[1]), 1) : 4000;
+	const int NumTicks = argc > 2 ? max(str_toint(argv[2]), 1) : 200;
+
+	for(int Dense = 0; Dense < 2; Dense++)
+	{
+		CBenchWorld World(Dense);
+		for(int i = 0; i < NumEntities; i++)
+			World.Spawn();
+
+		char aName[64];
+		str_format(aName, sizeof(aName), "%s fresh", Dense ? "arrays" : "lists");
+		Measure(World, aName, NumEntities, NumTicks);
+
+		World.Scatter();
+		str_format(aName, sizeof(aName), "%s scattered", Dense ? "arrays" : "lists");
+		Measure(World, aName, NumEntities, NumTicks);
+	}
+	return 0;
+}